@@ -0,0 +1,51 @@
+#!/usr/bin/env bash
+# Report how the time and memory of Duostra grow with the device size, by mapping a fixed family of circuits,
+# the decomposed QFTs and layers of random CXs, to synthetic devices from 16 to about 16k qubits.
+# Each circuit is mapped to the devices with at least as many qubits, e.g.,
+#     ./duostra_scaling.sh ../../qsyn sabre
+# The search scheduler does not scale to the large devices; the shortest paths of the largest devices take about 600 MiB.
+QSYN=${1:-../../qsyn}
+SCHEDULER=${2:-sabre}
+SCRIPT_DIR=$(dirname "$0")
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+for qnum in 16 128 1024; do
+    python3 "$SCRIPT_DIR/generate_random_cx_qasm.py" --qnum "$qnum" --output_root "$WORK_DIR"
+done
+
+CIRCUITS=("$SCRIPT_DIR/../qft/qft_16dec.qasm" "$SCRIPT_DIR/../qft/qft_127dec.qasm" "$WORK_DIR/rand_cx_16.qasm" "$WORK_DIR/rand_cx_128.qasm" "$WORK_DIR/rand_cx_1024.qasm")
+
+# <number of qubits>:<arguments to `device generate`>
+DEVICES=(
+    "16:grid 4" "64:grid 8" "256:grid 16" "1024:grid 32" "4096:grid 64" "16384:grid 128"
+    "18:heavy-hex 3 5" "78:heavy-hex 7 9" "307:heavy-hex 13 19" "1313:heavy-hex 27 39" "5425:heavy-hex 55 79" "17617:heavy-hex 111 127"
+    "16:all-to-all 16" "64:all-to-all 64" "256:all-to-all 256" "1024:all-to-all 1024"
+)
+
+field() {
+    echo "$1" | sed -n "s/^$2 *\([0-9.]*\).*$/\1/p" | tail -n 1
+}
+
+printf "%-20s %7s %-16s %8s %8s %10s %10s %10s %10s %10s %10s\n" \
+    "device" "qubits" "circuit" "gates" "#SWAP" "place (s)" "APSP (s)" "sched (s)" "result (s)" "total (s)" "mem (MiB)"
+for circuit in "${CIRCUITS[@]}"; do
+    circuit_qubits=$(sed -n 's/^qreg q\[\([0-9]*\)\];$/\1/p' "$circuit")
+    for device in "${DEVICES[@]}"; do
+        device_qubits=${device%%:*}
+        device_args=${device#*:}
+        if [ "$device_qubits" -lt "$circuit_qubits" ]; then continue; fi
+
+        output=$($QSYN --no-version --qsynrc-path /dev/null "$SCRIPT_DIR/duostra_scaling.qsyn" "$device_args" "$circuit" "$SCHEDULER" 2>&1)
+        gates=$(echo "$output" | sed -n 's/^QCir ([0-9]* qubits, \([0-9]*\) gates.*$/\1/p' | head -n 1)
+        printf "%-20s %7s %-16s %8s %8s %10s %10s %10s %10s %10s %10s\n" \
+            "$device_args" "$device_qubits" "$(basename "$circuit" .qasm)" "$gates" \
+            "$(field "$output" "#SWAP:")" \
+            "$(field "$output" "Placement:")" \
+            "$(field "$output" "APSP:")" \
+            "$(field "$output" "Scheduling:")" \
+            "$(field "$output" "Result:")" \
+            "$(field "$output" "Period time used :")" \
+            "$(field "$output" "Total memory used:")"
+    done
+done
@@ -0,0 +1,36 @@
+from argparse import ArgumentParser, Namespace
+from pathlib import Path
+import random
+
+
+def write_random_cx_layer(w, rng, qnum):
+    # a random perfect matching of the qubits, so that every qubit is busy in every layer
+    qubits = list(range(qnum))
+    rng.shuffle(qubits)
+    for ctrl, targ in zip(qubits[0::2], qubits[1::2]):
+        w.write("cx q[{ctrl}],q[{targ}];\n".format(ctrl=ctrl, targ=targ))
+
+
+def main(args):
+    rng = random.Random(args.seed)
+    with open("{root}/rand_cx_{num}.qasm".format(root=args.output_root, num=args.qnum), "w") as qasmf:
+        qasmf.write('OPENQASM 2.0;\ninclude "qelib1.inc";\n')
+        qasmf.write("qreg q[{}];\n".format(args.qnum))
+        for _ in range(args.layers):
+            write_random_cx_layer(qasmf, rng, args.qnum)
+
+
+def parse_args() -> Namespace:
+    parser = ArgumentParser(description="Generate layers of CX gates on random pairs of qubits")
+    parser.add_argument("--qnum", type=int, help="Number of qubits", required=True)
+    parser.add_argument("--layers", type=int, help="Number of CX layers", default=20)
+    parser.add_argument("--seed", type=int, help="Random seed", default=0)
+    parser.add_argument(
+        "--output_root", type=Path, help="Output file directory", default="./"
+    )
+    return parser.parse_args()
+
+
+if __name__ == "__main__":
+    args = parse_args()
+    main(args)
@@ -0,0 +1,15 @@
+#!/usr/bin/env bash
+# Report the QCir-to-tableau conversion throughput (gates per second) on the large SABRE benchmarks.
+# Run it with the qsyn binaries before and after a change to compare them, e.g.,
+#     ./qcir_to_tableau_throughput.sh ../../qsyn
+QSYN=${1:-../../qsyn}
+SCRIPT_DIR=$(dirname "$0")
+
+printf "%-24s %8s %12s %14s\n" "circuit" "gates" "time (s)" "gates/s"
+for file in "$SCRIPT_DIR"/../SABRE/large/*.qasm; do
+    output=$($QSYN --no-version --qsynrc-path /dev/null "$SCRIPT_DIR/qcir_to_tableau.qsyn" "$file" 2>&1)
+    gates=$(echo "$output" | sed -n 's/^QCir ([0-9]* qubits, \([0-9]*\) gates)$/\1/p' | head -n 1)
+    time=$(echo "$output" | sed -n 's/^Period time used : \([0-9.]*\) seconds$/\1/p' | tail -n 1)
+    printf "%-24s %8s %12s %14s\n" "$(basename "$file" .qasm)" "$gates" "$time" \
+        "$(awk -v g="$gates" -v t="$time" 'BEGIN { if (t > 0) printf "%.0f", g / t; else print "-" }')"
+done
@@ -0,0 +1,58 @@
+from argparse import ArgumentParser, Namespace
+from pathlib import Path
+import random
+
+
+def random_angle(rng, max_denominator):
+    # random rational multiple of pi, so that the tensor is generic but the QASM stays exact
+    denominator = rng.randint(3, max_denominator)
+    numerator = rng.randint(1, 2 * denominator - 1)
+    return "{num}*pi/{den}".format(num=numerator, den=denominator)
+
+
+def write_random_layer(w, rng, qnum, max_denominator):
+    for q in range(qnum):
+        w.write("rz({ang}) q[{q}];\n".format(ang=random_angle(rng, max_denominator), q=q))
+        w.write("ry({ang}) q[{q}];\n".format(ang=random_angle(rng, max_denominator), q=q))
+        w.write("rz({ang}) q[{q}];\n".format(ang=random_angle(rng, max_denominator), q=q))
+
+
+def write_entangling_layer(w, qnum, offset):
+    for q in range(offset, qnum - 1, 2):
+        w.write("cx q[{ctrl}],q[{targ}];\n".format(ctrl=q, targ=q + 1))
+
+
+def main(args):
+    rng = random.Random(args.seed)
+    with open("{root}/rand_{num}.qasm".format(root=args.output_root, num=args.qnum), "w") as qasmf:
+        qasmf.write('OPENQASM 2.0;\ninclude "qelib1.inc";\n')
+        qasmf.write("qreg q[{}];\n".format(args.qnum))
+        for layer in range(args.layers):
+            write_random_layer(qasmf, rng, args.qnum, args.max_denominator_value)
+            write_entangling_layer(qasmf, args.qnum, layer % 2)
+        write_random_layer(qasmf, rng, args.qnum, args.max_denominator_value)
+
+
+def parse_args() -> Namespace:
+    parser = ArgumentParser(description="Generate a brickwork circuit of random single-qubit rotations whose unitary is dense")
+    parser.add_argument("--qnum", type=int, help="Number of qubits", required=True)
+    parser.add_argument("--layers", type=int, help="Number of entangling layers (default: 2 * qnum)")
+    parser.add_argument("--seed", type=int, help="Random seed", default=0)
+    parser.add_argument(
+        "--max_denominator_value",
+        type=int,
+        help="Maximum value of the denominators of the angles",
+        default=64,
+    )
+    parser.add_argument(
+        "--output_root", type=Path, help="Output file directory", default="./"
+    )
+    args = parser.parse_args()
+    if args.layers is None:
+        args.layers = 2 * args.qnum
+    return args
+
+
+if __name__ == "__main__":
+    args = parse_args()
+    main(args)
@@ -0,0 +1,4 @@
+for file in 6 7 8; do
+    echo "Generating size = $file"
+    python3 generate_random_unitary_qasm.py --qnum ${file}
+done
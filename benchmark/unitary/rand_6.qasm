@@ -0,0 +1,267 @@
+OPENQASM 2.0;
+include "qelib1.inc";
+qreg q[6];
+rz(50*pi/57) q[0];
+ry(54*pi/51) q[0];
+rz(5*pi/5) q[0];
+rz(66*pi/64) q[1];
+ry(52*pi/34) q[1];
+rz(101*pi/61) q[1];
+rz(39*pi/56) q[2];
+ry(62*pi/64) q[2];
+rz(38*pi/25) q[2];
+rz(117*pi/60) q[3];
+ry(17*pi/16) q[3];
+rz(10*pi/11) q[3];
+rz(4*pi/11) q[4];
+ry(33*pi/42) q[4];
+rz(69*pi/61) q[4];
+rz(78*pi/48) q[5];
+ry(19*pi/60) q[5];
+rz(7*pi/22) q[5];
+cx q[0],q[1];
+cx q[2],q[3];
+cx q[4],q[5];
+rz(10*pi/49) q[0];
+ry(109*pi/60) q[0];
+rz(43*pi/46) q[0];
+rz(13*pi/33) q[1];
+ry(28*pi/25) q[1];
+rz(40*pi/23) q[1];
+rz(27*pi/43) q[2];
+ry(71*pi/64) q[2];
+rz(57*pi/33) q[2];
+rz(67*pi/58) q[3];
+ry(4*pi/19) q[3];
+rz(71*pi/54) q[3];
+rz(2*pi/61) q[4];
+ry(12*pi/8) q[4];
+rz(52*pi/56) q[4];
+rz(86*pi/48) q[5];
+ry(1*pi/43) q[5];
+rz(64*pi/42) q[5];
+cx q[1],q[2];
+cx q[3],q[4];
+rz(43*pi/55) q[0];
+ry(21*pi/18) q[0];
+rz(9*pi/48) q[0];
+rz(19*pi/15) q[1];
+ry(16*pi/17) q[1];
+rz(19*pi/54) q[1];
+rz(70*pi/54) q[2];
+ry(6*pi/31) q[2];
+rz(6*pi/8) q[2];
+rz(66*pi/59) q[3];
+ry(63*pi/62) q[3];
+rz(10*pi/9) q[3];
+rz(38*pi/38) q[4];
+ry(16*pi/48) q[4];
+rz(43*pi/38) q[4];
+rz(70*pi/55) q[5];
+ry(31*pi/16) q[5];
+rz(78*pi/54) q[5];
+cx q[0],q[1];
+cx q[2],q[3];
+cx q[4],q[5];
+rz(37*pi/38) q[0];
+ry(6*pi/31) q[0];
+rz(50*pi/41) q[0];
+rz(37*pi/23) q[1];
+ry(19*pi/18) q[1];
+rz(7*pi/14) q[1];
+rz(24*pi/55) q[2];
+ry(5*pi/5) q[2];
+rz(9*pi/33) q[2];
+rz(11*pi/8) q[3];
+ry(17*pi/51) q[3];
+rz(20*pi/59) q[3];
+rz(5*pi/62) q[4];
+ry(11*pi/56) q[4];
+rz(90*pi/60) q[4];
+rz(107*pi/62) q[5];
+ry(51*pi/37) q[5];
+rz(91*pi/56) q[5];
+cx q[1],q[2];
+cx q[3],q[4];
+rz(36*pi/36) q[0];
+ry(31*pi/36) q[0];
+rz(28*pi/57) q[0];
+rz(87*pi/60) q[1];
+ry(54*pi/40) q[1];
+rz(36*pi/40) q[1];
+rz(32*pi/31) q[2];
+ry(83*pi/45) q[2];
+rz(46*pi/47) q[2];
+rz(6*pi/8) q[3];
+ry(15*pi/42) q[3];
+rz(43*pi/34) q[3];
+rz(25*pi/57) q[4];
+ry(2*pi/18) q[4];
+rz(35*pi/49) q[4];
+rz(8*pi/10) q[5];
+ry(51*pi/26) q[5];
+rz(11*pi/13) q[5];
+cx q[0],q[1];
+cx q[2],q[3];
+cx q[4],q[5];
+rz(53*pi/30) q[0];
+ry(2*pi/6) q[0];
+rz(19*pi/53) q[0];
+rz(90*pi/57) q[1];
+ry(3*pi/17) q[1];
+rz(74*pi/55) q[1];
+rz(69*pi/43) q[2];
+ry(10*pi/41) q[2];
+rz(1*pi/4) q[2];
+rz(25*pi/43) q[3];
+ry(74*pi/41) q[3];
+rz(13*pi/10) q[3];
+rz(6*pi/8) q[4];
+ry(15*pi/56) q[4];
+rz(1*pi/5) q[4];
+rz(6*pi/15) q[5];
+ry(16*pi/48) q[5];
+rz(27*pi/33) q[5];
+cx q[1],q[2];
+cx q[3],q[4];
+rz(8*pi/49) q[0];
+ry(87*pi/62) q[0];
+rz(5*pi/4) q[0];
+rz(40*pi/30) q[1];
+ry(9*pi/9) q[1];
+rz(4*pi/7) q[1];
+rz(11*pi/7) q[2];
+ry(23*pi/22) q[2];
+rz(12*pi/30) q[2];
+rz(9*pi/6) q[3];
+ry(3*pi/32) q[3];
+rz(13*pi/41) q[3];
+rz(51*pi/47) q[4];
+ry(9*pi/15) q[4];
+rz(47*pi/25) q[4];
+rz(22*pi/33) q[5];
+ry(87*pi/47) q[5];
+rz(31*pi/16) q[5];
+cx q[0],q[1];
+cx q[2],q[3];
+cx q[4],q[5];
+rz(8*pi/52) q[0];
+ry(87*pi/53) q[0];
+rz(6*pi/13) q[0];
+rz(34*pi/24) q[1];
+ry(8*pi/19) q[1];
+rz(57*pi/41) q[1];
+rz(23*pi/45) q[2];
+ry(4*pi/3) q[2];
+rz(53*pi/46) q[2];
+rz(73*pi/60) q[3];
+ry(66*pi/58) q[3];
+rz(40*pi/61) q[3];
+rz(46*pi/44) q[4];
+ry(43*pi/27) q[4];
+rz(10*pi/19) q[4];
+rz(2*pi/38) q[5];
+ry(48*pi/32) q[5];
+rz(6*pi/8) q[5];
+cx q[1],q[2];
+cx q[3],q[4];
+rz(6*pi/50) q[0];
+ry(36*pi/37) q[0];
+rz(8*pi/11) q[0];
+rz(62*pi/51) q[1];
+ry(40*pi/25) q[1];
+rz(23*pi/21) q[1];
+rz(17*pi/40) q[2];
+ry(40*pi/48) q[2];
+rz(48*pi/27) q[2];
+rz(54*pi/29) q[3];
+ry(11*pi/44) q[3];
+rz(5*pi/3) q[3];
+rz(23*pi/15) q[4];
+ry(11*pi/24) q[4];
+rz(15*pi/18) q[4];
+rz(58*pi/43) q[5];
+ry(46*pi/27) q[5];
+rz(87*pi/59) q[5];
+cx q[0],q[1];
+cx q[2],q[3];
+cx q[4],q[5];
+rz(54*pi/39) q[0];
+ry(7*pi/5) q[0];
+rz(90*pi/58) q[0];
+rz(54*pi/39) q[1];
+ry(85*pi/52) q[1];
+rz(6*pi/48) q[1];
+rz(15*pi/13) q[2];
+ry(5*pi/7) q[2];
+rz(21*pi/47) q[2];
+rz(34*pi/31) q[3];
+ry(63*pi/59) q[3];
+rz(72*pi/61) q[3];
+rz(1*pi/41) q[4];
+ry(5*pi/59) q[4];
+rz(42*pi/34) q[4];
+rz(30*pi/22) q[5];
+ry(7*pi/6) q[5];
+rz(18*pi/15) q[5];
+cx q[1],q[2];
+cx q[3],q[4];
+rz(82*pi/64) q[0];
+ry(14*pi/8) q[0];
+rz(17*pi/49) q[0];
+rz(4*pi/3) q[1];
+ry(87*pi/63) q[1];
+rz(21*pi/29) q[1];
+rz(2*pi/3) q[2];
+ry(1*pi/3) q[2];
+rz(87*pi/55) q[2];
+rz(13*pi/36) q[3];
+ry(4*pi/15) q[3];
+rz(26*pi/41) q[3];
+rz(39*pi/58) q[4];
+ry(12*pi/20) q[4];
+rz(16*pi/9) q[4];
+rz(51*pi/57) q[5];
+ry(11*pi/43) q[5];
+rz(3*pi/4) q[5];
+cx q[0],q[1];
+cx q[2],q[3];
+cx q[4],q[5];
+rz(58*pi/61) q[0];
+ry(102*pi/54) q[0];
+rz(9*pi/10) q[0];
+rz(21*pi/11) q[1];
+ry(45*pi/36) q[1];
+rz(5*pi/10) q[1];
+rz(2*pi/20) q[2];
+ry(1*pi/5) q[2];
+rz(22*pi/16) q[2];
+rz(36*pi/19) q[3];
+ry(24*pi/23) q[3];
+rz(73*pi/63) q[3];
+rz(109*pi/61) q[4];
+ry(8*pi/5) q[4];
+rz(83*pi/48) q[4];
+rz(59*pi/60) q[5];
+ry(56*pi/43) q[5];
+rz(35*pi/26) q[5];
+cx q[1],q[2];
+cx q[3],q[4];
+rz(7*pi/14) q[0];
+ry(38*pi/27) q[0];
+rz(1*pi/21) q[0];
+rz(5*pi/11) q[1];
+ry(22*pi/20) q[1];
+rz(24*pi/24) q[1];
+rz(12*pi/48) q[2];
+ry(40*pi/24) q[2];
+rz(1*pi/5) q[2];
+rz(11*pi/20) q[3];
+ry(19*pi/12) q[3];
+rz(24*pi/21) q[3];
+rz(36*pi/28) q[4];
+ry(10*pi/11) q[4];
+rz(16*pi/10) q[4];
+rz(31*pi/49) q[5];
+ry(7*pi/62) q[5];
+rz(12*pi/22) q[5];
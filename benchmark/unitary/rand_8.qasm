@@ -0,0 +1,467 @@
+OPENQASM 2.0;
+include "qelib1.inc";
+qreg q[8];
+rz(50*pi/57) q[0];
+ry(54*pi/51) q[0];
+rz(5*pi/5) q[0];
+rz(66*pi/64) q[1];
+ry(52*pi/34) q[1];
+rz(101*pi/61) q[1];
+rz(39*pi/56) q[2];
+ry(62*pi/64) q[2];
+rz(38*pi/25) q[2];
+rz(117*pi/60) q[3];
+ry(17*pi/16) q[3];
+rz(10*pi/11) q[3];
+rz(4*pi/11) q[4];
+ry(33*pi/42) q[4];
+rz(69*pi/61) q[4];
+rz(78*pi/48) q[5];
+ry(19*pi/60) q[5];
+rz(7*pi/22) q[5];
+rz(10*pi/49) q[6];
+ry(109*pi/60) q[6];
+rz(43*pi/46) q[6];
+rz(13*pi/33) q[7];
+ry(28*pi/25) q[7];
+rz(40*pi/23) q[7];
+cx q[0],q[1];
+cx q[2],q[3];
+cx q[4],q[5];
+cx q[6],q[7];
+rz(27*pi/43) q[0];
+ry(71*pi/64) q[0];
+rz(57*pi/33) q[0];
+rz(67*pi/58) q[1];
+ry(4*pi/19) q[1];
+rz(71*pi/54) q[1];
+rz(2*pi/61) q[2];
+ry(12*pi/8) q[2];
+rz(52*pi/56) q[2];
+rz(86*pi/48) q[3];
+ry(1*pi/43) q[3];
+rz(64*pi/42) q[3];
+rz(43*pi/55) q[4];
+ry(21*pi/18) q[4];
+rz(9*pi/48) q[4];
+rz(19*pi/15) q[5];
+ry(16*pi/17) q[5];
+rz(19*pi/54) q[5];
+rz(70*pi/54) q[6];
+ry(6*pi/31) q[6];
+rz(6*pi/8) q[6];
+rz(66*pi/59) q[7];
+ry(63*pi/62) q[7];
+rz(10*pi/9) q[7];
+cx q[1],q[2];
+cx q[3],q[4];
+cx q[5],q[6];
+rz(38*pi/38) q[0];
+ry(16*pi/48) q[0];
+rz(43*pi/38) q[0];
+rz(70*pi/55) q[1];
+ry(31*pi/16) q[1];
+rz(78*pi/54) q[1];
+rz(37*pi/38) q[2];
+ry(6*pi/31) q[2];
+rz(50*pi/41) q[2];
+rz(37*pi/23) q[3];
+ry(19*pi/18) q[3];
+rz(7*pi/14) q[3];
+rz(24*pi/55) q[4];
+ry(5*pi/5) q[4];
+rz(9*pi/33) q[4];
+rz(11*pi/8) q[5];
+ry(17*pi/51) q[5];
+rz(20*pi/59) q[5];
+rz(5*pi/62) q[6];
+ry(11*pi/56) q[6];
+rz(90*pi/60) q[6];
+rz(107*pi/62) q[7];
+ry(51*pi/37) q[7];
+rz(91*pi/56) q[7];
+cx q[0],q[1];
+cx q[2],q[3];
+cx q[4],q[5];
+cx q[6],q[7];
+rz(36*pi/36) q[0];
+ry(31*pi/36) q[0];
+rz(28*pi/57) q[0];
+rz(87*pi/60) q[1];
+ry(54*pi/40) q[1];
+rz(36*pi/40) q[1];
+rz(32*pi/31) q[2];
+ry(83*pi/45) q[2];
+rz(46*pi/47) q[2];
+rz(6*pi/8) q[3];
+ry(15*pi/42) q[3];
+rz(43*pi/34) q[3];
+rz(25*pi/57) q[4];
+ry(2*pi/18) q[4];
+rz(35*pi/49) q[4];
+rz(8*pi/10) q[5];
+ry(51*pi/26) q[5];
+rz(11*pi/13) q[5];
+rz(53*pi/30) q[6];
+ry(2*pi/6) q[6];
+rz(19*pi/53) q[6];
+rz(90*pi/57) q[7];
+ry(3*pi/17) q[7];
+rz(74*pi/55) q[7];
+cx q[1],q[2];
+cx q[3],q[4];
+cx q[5],q[6];
+rz(69*pi/43) q[0];
+ry(10*pi/41) q[0];
+rz(1*pi/4) q[0];
+rz(25*pi/43) q[1];
+ry(74*pi/41) q[1];
+rz(13*pi/10) q[1];
+rz(6*pi/8) q[2];
+ry(15*pi/56) q[2];
+rz(1*pi/5) q[2];
+rz(6*pi/15) q[3];
+ry(16*pi/48) q[3];
+rz(27*pi/33) q[3];
+rz(8*pi/49) q[4];
+ry(87*pi/62) q[4];
+rz(5*pi/4) q[4];
+rz(40*pi/30) q[5];
+ry(9*pi/9) q[5];
+rz(4*pi/7) q[5];
+rz(11*pi/7) q[6];
+ry(23*pi/22) q[6];
+rz(12*pi/30) q[6];
+rz(9*pi/6) q[7];
+ry(3*pi/32) q[7];
+rz(13*pi/41) q[7];
+cx q[0],q[1];
+cx q[2],q[3];
+cx q[4],q[5];
+cx q[6],q[7];
+rz(51*pi/47) q[0];
+ry(9*pi/15) q[0];
+rz(47*pi/25) q[0];
+rz(22*pi/33) q[1];
+ry(87*pi/47) q[1];
+rz(31*pi/16) q[1];
+rz(8*pi/52) q[2];
+ry(87*pi/53) q[2];
+rz(6*pi/13) q[2];
+rz(34*pi/24) q[3];
+ry(8*pi/19) q[3];
+rz(57*pi/41) q[3];
+rz(23*pi/45) q[4];
+ry(4*pi/3) q[4];
+rz(53*pi/46) q[4];
+rz(73*pi/60) q[5];
+ry(66*pi/58) q[5];
+rz(40*pi/61) q[5];
+rz(46*pi/44) q[6];
+ry(43*pi/27) q[6];
+rz(10*pi/19) q[6];
+rz(2*pi/38) q[7];
+ry(48*pi/32) q[7];
+rz(6*pi/8) q[7];
+cx q[1],q[2];
+cx q[3],q[4];
+cx q[5],q[6];
+rz(6*pi/50) q[0];
+ry(36*pi/37) q[0];
+rz(8*pi/11) q[0];
+rz(62*pi/51) q[1];
+ry(40*pi/25) q[1];
+rz(23*pi/21) q[1];
+rz(17*pi/40) q[2];
+ry(40*pi/48) q[2];
+rz(48*pi/27) q[2];
+rz(54*pi/29) q[3];
+ry(11*pi/44) q[3];
+rz(5*pi/3) q[3];
+rz(23*pi/15) q[4];
+ry(11*pi/24) q[4];
+rz(15*pi/18) q[4];
+rz(58*pi/43) q[5];
+ry(46*pi/27) q[5];
+rz(87*pi/59) q[5];
+rz(54*pi/39) q[6];
+ry(7*pi/5) q[6];
+rz(90*pi/58) q[6];
+rz(54*pi/39) q[7];
+ry(85*pi/52) q[7];
+rz(6*pi/48) q[7];
+cx q[0],q[1];
+cx q[2],q[3];
+cx q[4],q[5];
+cx q[6],q[7];
+rz(15*pi/13) q[0];
+ry(5*pi/7) q[0];
+rz(21*pi/47) q[0];
+rz(34*pi/31) q[1];
+ry(63*pi/59) q[1];
+rz(72*pi/61) q[1];
+rz(1*pi/41) q[2];
+ry(5*pi/59) q[2];
+rz(42*pi/34) q[2];
+rz(30*pi/22) q[3];
+ry(7*pi/6) q[3];
+rz(18*pi/15) q[3];
+rz(82*pi/64) q[4];
+ry(14*pi/8) q[4];
+rz(17*pi/49) q[4];
+rz(4*pi/3) q[5];
+ry(87*pi/63) q[5];
+rz(21*pi/29) q[5];
+rz(2*pi/3) q[6];
+ry(1*pi/3) q[6];
+rz(87*pi/55) q[6];
+rz(13*pi/36) q[7];
+ry(4*pi/15) q[7];
+rz(26*pi/41) q[7];
+cx q[1],q[2];
+cx q[3],q[4];
+cx q[5],q[6];
+rz(39*pi/58) q[0];
+ry(12*pi/20) q[0];
+rz(16*pi/9) q[0];
+rz(51*pi/57) q[1];
+ry(11*pi/43) q[1];
+rz(3*pi/4) q[1];
+rz(58*pi/61) q[2];
+ry(102*pi/54) q[2];
+rz(9*pi/10) q[2];
+rz(21*pi/11) q[3];
+ry(45*pi/36) q[3];
+rz(5*pi/10) q[3];
+rz(2*pi/20) q[4];
+ry(1*pi/5) q[4];
+rz(22*pi/16) q[4];
+rz(36*pi/19) q[5];
+ry(24*pi/23) q[5];
+rz(73*pi/63) q[5];
+rz(109*pi/61) q[6];
+ry(8*pi/5) q[6];
+rz(83*pi/48) q[6];
+rz(59*pi/60) q[7];
+ry(56*pi/43) q[7];
+rz(35*pi/26) q[7];
+cx q[0],q[1];
+cx q[2],q[3];
+cx q[4],q[5];
+cx q[6],q[7];
+rz(7*pi/14) q[0];
+ry(38*pi/27) q[0];
+rz(1*pi/21) q[0];
+rz(5*pi/11) q[1];
+ry(22*pi/20) q[1];
+rz(24*pi/24) q[1];
+rz(12*pi/48) q[2];
+ry(40*pi/24) q[2];
+rz(1*pi/5) q[2];
+rz(11*pi/20) q[3];
+ry(19*pi/12) q[3];
+rz(24*pi/21) q[3];
+rz(36*pi/28) q[4];
+ry(10*pi/11) q[4];
+rz(16*pi/10) q[4];
+rz(31*pi/49) q[5];
+ry(7*pi/62) q[5];
+rz(12*pi/22) q[5];
+rz(67*pi/57) q[6];
+ry(10*pi/49) q[6];
+rz(26*pi/22) q[6];
+rz(43*pi/56) q[7];
+ry(27*pi/22) q[7];
+rz(4*pi/9) q[7];
+cx q[1],q[2];
+cx q[3],q[4];
+cx q[5],q[6];
+rz(62*pi/38) q[0];
+ry(44*pi/33) q[0];
+rz(103*pi/56) q[0];
+rz(44*pi/54) q[1];
+ry(16*pi/10) q[1];
+rz(16*pi/10) q[1];
+rz(3*pi/30) q[2];
+ry(22*pi/22) q[2];
+rz(88*pi/50) q[2];
+rz(20*pi/60) q[3];
+ry(22*pi/61) q[3];
+rz(73*pi/43) q[3];
+rz(52*pi/27) q[4];
+ry(12*pi/43) q[4];
+rz(13*pi/7) q[4];
+rz(4*pi/8) q[5];
+ry(29*pi/50) q[5];
+rz(7*pi/6) q[5];
+rz(1*pi/3) q[6];
+ry(36*pi/28) q[6];
+rz(38*pi/36) q[6];
+rz(59*pi/31) q[7];
+ry(28*pi/34) q[7];
+rz(6*pi/30) q[7];
+cx q[0],q[1];
+cx q[2],q[3];
+cx q[4],q[5];
+cx q[6],q[7];
+rz(15*pi/26) q[0];
+ry(11*pi/19) q[0];
+rz(13*pi/30) q[0];
+rz(8*pi/25) q[1];
+ry(12*pi/7) q[1];
+rz(5*pi/4) q[1];
+rz(49*pi/31) q[2];
+ry(26*pi/46) q[2];
+rz(16*pi/10) q[2];
+rz(17*pi/28) q[3];
+ry(21*pi/16) q[3];
+rz(4*pi/5) q[3];
+rz(19*pi/42) q[4];
+ry(7*pi/9) q[4];
+rz(25*pi/32) q[4];
+rz(35*pi/26) q[5];
+ry(20*pi/55) q[5];
+rz(16*pi/9) q[5];
+rz(19*pi/12) q[6];
+ry(41*pi/28) q[6];
+rz(55*pi/46) q[6];
+rz(67*pi/59) q[7];
+ry(42*pi/34) q[7];
+rz(64*pi/56) q[7];
+cx q[1],q[2];
+cx q[3],q[4];
+cx q[5],q[6];
+rz(26*pi/34) q[0];
+ry(29*pi/37) q[0];
+rz(3*pi/3) q[0];
+rz(41*pi/48) q[1];
+ry(42*pi/55) q[1];
+rz(9*pi/5) q[1];
+rz(9*pi/12) q[2];
+ry(20*pi/41) q[2];
+rz(49*pi/56) q[2];
+rz(38*pi/40) q[3];
+ry(91*pi/48) q[3];
+rz(61*pi/54) q[3];
+rz(13*pi/7) q[4];
+ry(9*pi/8) q[4];
+rz(6*pi/58) q[4];
+rz(4*pi/7) q[5];
+ry(2*pi/11) q[5];
+rz(1*pi/22) q[5];
+rz(58*pi/51) q[6];
+ry(11*pi/24) q[6];
+rz(20*pi/54) q[6];
+rz(84*pi/58) q[7];
+ry(62*pi/32) q[7];
+rz(33*pi/26) q[7];
+cx q[0],q[1];
+cx q[2],q[3];
+cx q[4],q[5];
+cx q[6],q[7];
+rz(34*pi/27) q[0];
+ry(5*pi/35) q[0];
+rz(12*pi/39) q[0];
+rz(67*pi/46) q[1];
+ry(77*pi/51) q[1];
+rz(12*pi/7) q[1];
+rz(58*pi/30) q[2];
+ry(27*pi/51) q[2];
+rz(35*pi/21) q[2];
+rz(77*pi/60) q[3];
+ry(53*pi/29) q[3];
+rz(50*pi/33) q[3];
+rz(76*pi/41) q[4];
+ry(2*pi/17) q[4];
+rz(1*pi/45) q[4];
+rz(24*pi/50) q[5];
+ry(33*pi/22) q[5];
+rz(33*pi/39) q[5];
+rz(5*pi/24) q[6];
+ry(34*pi/34) q[6];
+rz(106*pi/63) q[6];
+rz(27*pi/22) q[7];
+ry(52*pi/27) q[7];
+rz(4*pi/27) q[7];
+cx q[1],q[2];
+cx q[3],q[4];
+cx q[5],q[6];
+rz(21*pi/13) q[0];
+ry(17*pi/62) q[0];
+rz(19*pi/18) q[0];
+rz(43*pi/49) q[1];
+ry(1*pi/6) q[1];
+rz(54*pi/33) q[1];
+rz(16*pi/12) q[2];
+ry(111*pi/59) q[2];
+rz(11*pi/41) q[2];
+rz(90*pi/46) q[3];
+ry(12*pi/12) q[3];
+rz(3*pi/29) q[3];
+rz(60*pi/42) q[4];
+ry(30*pi/27) q[4];
+rz(2*pi/6) q[4];
+rz(20*pi/33) q[5];
+ry(1*pi/4) q[5];
+rz(80*pi/41) q[5];
+rz(21*pi/11) q[6];
+ry(7*pi/23) q[6];
+rz(71*pi/47) q[6];
+rz(45*pi/44) q[7];
+ry(13*pi/15) q[7];
+rz(100*pi/53) q[7];
+cx q[0],q[1];
+cx q[2],q[3];
+cx q[4],q[5];
+cx q[6],q[7];
+rz(63*pi/52) q[0];
+ry(2*pi/10) q[0];
+rz(60*pi/42) q[0];
+rz(81*pi/42) q[1];
+ry(44*pi/62) q[1];
+rz(16*pi/44) q[1];
+rz(80*pi/46) q[2];
+ry(9*pi/21) q[2];
+rz(117*pi/64) q[2];
+rz(52*pi/27) q[3];
+ry(8*pi/21) q[3];
+rz(25*pi/36) q[3];
+rz(7*pi/5) q[4];
+ry(24*pi/31) q[4];
+rz(25*pi/51) q[4];
+rz(23*pi/32) q[5];
+ry(81*pi/53) q[5];
+rz(1*pi/7) q[5];
+rz(6*pi/60) q[6];
+ry(33*pi/34) q[6];
+rz(4*pi/60) q[6];
+rz(67*pi/63) q[7];
+ry(73*pi/45) q[7];
+rz(28*pi/39) q[7];
+cx q[1],q[2];
+cx q[3],q[4];
+cx q[5],q[6];
+rz(6*pi/17) q[0];
+ry(81*pi/52) q[0];
+rz(65*pi/52) q[0];
+rz(68*pi/47) q[1];
+ry(33*pi/29) q[1];
+rz(8*pi/22) q[1];
+rz(14*pi/12) q[2];
+ry(73*pi/60) q[2];
+rz(6*pi/30) q[2];
+rz(14*pi/62) q[3];
+ry(5*pi/29) q[3];
+rz(14*pi/9) q[3];
+rz(20*pi/52) q[4];
+ry(4*pi/49) q[4];
+rz(58*pi/53) q[4];
+rz(44*pi/30) q[5];
+ry(2*pi/29) q[5];
+rz(42*pi/34) q[5];
+rz(33*pi/49) q[6];
+ry(6*pi/8) q[6];
+rz(2*pi/7) q[6];
+rz(45*pi/25) q[7];
+ry(3*pi/4) q[7];
+rz(12*pi/25) q[7];
@@ -45,6 +45,26 @@ bool valid_decomposition_mode(size_t const& val) {
     return false;
 };
 
+namespace {
+
+void add_tensor_precision_argument(ArgumentParser& parser) {
+    parser.add_argument<std::string>("-p", "--precision")
+        .choices({"single", "double"})
+        .default_value("double")
+        .help("the floating-point precision used during tensor contraction. Single precision halves the memory footprint. The result is stored in double precision");
+}
+
+/**
+ * @brief The tensor manager stores double-precision tensors. Widen the single-precision result after the contraction is done.
+ *
+ */
+std::optional<tensor::QTensor<double>> widen_to_double(std::optional<tensor::QTensor<float>> tensor) {
+    if (!tensor.has_value()) return std::nullopt;
+    return tensor->astype<double>();
+}
+
+}  // namespace
+
 Command convert_from_qcir_cmd(
     qcir::QCirMgr& qcir_mgr,
     zx::ZXGraphMgr& zxgraph_mgr,
@@ -64,6 +84,8 @@ Command convert_from_qcir_cmd(
             auto to_tensor =
                 subparsers.add_parser("tensor")
                     .description("convert from QCir to Tensor");
+
+            add_tensor_precision_argument(to_tensor);
             auto to_tableau =
                 subparsers.add_parser("tableau")
                     .description("convert from QCir to Tableau");
@@ -86,7 +108,9 @@ Command convert_from_qcir_cmd(
             }
             if (to_type == "tensor") {
                 spdlog::info("Converting to QCir {} to Tensor {}...", qcir_mgr.focused_id(), tensor_mgr.get_next_id());
-                auto tensor = to_tensor(*qcir_mgr.get());
+                auto tensor = parser.get<std::string>("--precision") == "single"
+                                  ? widen_to_double(to_tensor_as<float>(*qcir_mgr.get()))
+                                  : to_tensor_as<double>(*qcir_mgr.get());
 
                 if (tensor.has_value()) {
                     *tensor = tensor->to_matrix();
@@ -132,6 +156,8 @@ Command convert_from_zx_cmd(zx::ZXGraphMgr& zxgraph_mgr, QCirMgr& qcir_mgr, tens
 
             auto to_tensor = subparsers.add_parser("tensor")
                                  .description("convert from ZXGraph to Tensor");
+
+            add_tensor_precision_argument(to_tensor);
         },
         [&](ArgumentParser const& parser) {
             if (!dvlab::utils::mgr_has_data(zxgraph_mgr)) return CmdExecResult::error;
@@ -163,7 +189,9 @@ Command convert_from_zx_cmd(zx::ZXGraphMgr& zxgraph_mgr, QCirMgr& qcir_mgr, tens
             }
             if (to_type == "tensor") {
                 spdlog::info("Converting ZXGraph {} to Tensor {}...", zxgraph_mgr.focused_id(), tensor_mgr.get_next_id());
-                auto tensor = qsyn::to_tensor(*zxgraph_mgr.get());
+                auto tensor = parser.get<std::string>("--precision") == "single"
+                                  ? widen_to_double(to_tensor_as<float>(*zxgraph_mgr.get()))
+                                  : to_tensor_as<double>(*zxgraph_mgr.get());
 
                 if (tensor.has_value()) {
                     tensor_mgr.add(tensor_mgr.get_next_id(), std::make_unique<qsyn::tensor::QTensor<double>>(std::move(tensor.value())));
@@ -296,7 +324,7 @@ Command conversion_cmd(QCirMgr& qcir_mgr, qsyn::tensor::TensorMgr& tensor_mgr, q
 Command sk_decompose_cmd(qsyn::tensor::TensorMgr& tensor_mgr, QCirMgr& qcir_mgr) {
     return {"sk-decompose",
             [&](ArgumentParser& parser) {
-                parser.description("decompose the tensor by SK-algorithm");
+                parser.description("decompose the tensor, or the rotations of a QCir, by SK-algorithm");
                 parser.add_argument<size_t>("-d", "--depth")
                     .required(true)
                     .help("the depth of the gate list");
@@ -304,10 +332,42 @@ Command sk_decompose_cmd(qsyn::tensor::TensorMgr& tensor_mgr, QCirMgr& qcir_mgr)
                 parser.add_argument<size_t>("-r", "--recursion")
                     .required(true)
                     .help("the recursion times of Solovay-Kitaev algorithm");
+
+                parser.add_argument<std::string>("--cache-dir")
+                    .help("if specified, load the gate list from this directory, or save it there if it does not exist yet");
+
+                parser.add_argument<bool>("-q", "--qcir")
+                    .action(store_true)
+                    .help("if specified, decompose every single-qubit rotation of the focused QCir whose angle is not a multiple of π/4, instead of the focused tensor");
+
+                parser.add_argument<size_t>("-j", "--jobs")
+                    .default_value(0)
+                    .help("the number of threads to approximate distinct rotations with --qcir. If 0, use all hardware threads");
             },
             // NOTE - Check the function solovay_kitaev_decompose
             [&](ArgumentParser const& parser) {
-                tensor::SolovayKitaev decomposer(parser.get<size_t>("--depth"), parser.get<size_t>("--recursion"));
+                auto const cache_dir = parser.parsed("--cache-dir")
+                                           ? std::make_optional<std::filesystem::path>(parser.get<std::string>("--cache-dir"))
+                                           : std::nullopt;
+                tensor::SolovayKitaev decomposer(parser.get<size_t>("--depth"), parser.get<size_t>("--recursion"), cache_dir);
+
+                if (parser.get<bool>("--qcir")) {
+                    if (!dvlab::utils::mgr_has_data(qcir_mgr)) return CmdExecResult::error;
+                    spdlog::info("Decomposing rotations of QCir {} to QCir {} by Solovay-Kitaev algorithm...", qcir_mgr.focused_id(), qcir_mgr.get_next_id());
+                    auto result = decomposer.decompose_rotations(*qcir_mgr.get(), parser.get<size_t>("--jobs"));
+
+                    if (result) {
+                        auto const filename   = qcir_mgr.get()->get_filename();
+                        auto const procedures = qcir_mgr.get()->get_procedures();
+                        qcir_mgr.add(qcir_mgr.get_next_id(), std::make_unique<qcir::QCir>(std::move(*result)));
+                        qcir_mgr.get()->add_procedures(procedures);
+                        qcir_mgr.get()->add_procedure("Solovay-Kitaev");
+                        qcir_mgr.get()->set_filename(filename);
+                    }
+
+                    return CmdExecResult::done;
+                }
+
                 spdlog::info("Decomposing Tensor {} to QCir {} by Solovay-Kitaev algorithm...", tensor_mgr.focused_id(), qcir_mgr.get_next_id());
                 auto result = decomposer.solovay_kitaev_decompose(*tensor_mgr.get());
 
@@ -8,6 +8,7 @@
 #include "./qcir_to_tableau.hpp"
 
 #include <gsl/narrow>
+#include <optional>
 #include <ranges>
 #include <span>
 #include <tl/adjacent.hpp>
@@ -19,6 +20,7 @@
 #include "qcir/basic_gate_type.hpp"
 #include "qcir/qcir_gate.hpp"
 #include "qsyn/qsyn_type.hpp"
+#include "tableau/packed_stabilizer_tableau.hpp"
 #include "tableau/tableau.hpp"
 #include "util/phase.hpp"
 #include "util/util.hpp"
@@ -41,11 +43,21 @@ std::vector<size_t> get_qubit_idx_vec(QubitIdList const& qubits) {
     return ret;
 }
 
-[[nodiscard]] bool implement_mcr(Tableau& tableau, QubitIdList const& qubits, dvlab::Phase const& ph, Pauli pauli) {
-    if (std::holds_alternative<StabilizerTableau>(tableau.back())) {
-        tableau.push_back(std::vector<PauliRotation>{});
-    }
-
+/**
+ * @brief Emit the Pauli rotations that a multi-controlled rotation or phase gate decomposes into.
+ *        The rotation plane of the target is converted to Z on `frame` before emitting and restored afterwards.
+ *
+ * @param frame the Clifford frame the rotations are emitted in
+ * @param n_qubits number of qubits of the Pauli products
+ * @param qubits the controls followed by the target
+ * @param ph the phase of the gate
+ * @param pauli the rotation axis of the target
+ * @param is_phase_gate true for multi-controlled phase gates, false for multi-controlled rotation gates
+ * @param emit callback taking the Pauli product and the phase of each rotation
+ * @return true if successful, false if interrupted
+ */
+template <typename T, typename F>
+[[nodiscard]] bool emit_multi_controlled_rotations(PauliProductTrait<T>& frame, size_t n_qubits, QubitIdList const& qubits, dvlab::Phase const& ph, Pauli pauli, bool is_phase_gate, F&& emit) {
     dvlab::Phase const phase =
         ph *
         dvlab::Rational(1, static_cast<int>(std::pow(2, gsl::narrow<double>(qubits.size()) - 1)));
@@ -53,83 +65,59 @@ std::vector<size_t> get_qubit_idx_vec(QubitIdList const& qubits) {
     auto const targ = qubits.back();
     // convert rotation plane first
     if (pauli == Pauli::x) {
-        tableau.h(targ);
+        frame.h(targ);
     } else if (pauli == Pauli::y) {
-        tableau.v(targ);
+        frame.v(targ);
     }
-    // guaranteed to be a vector of PauliRotation
-    auto& last_rotation_group = std::get<std::vector<PauliRotation>>(tableau.back());
 
-    for (auto const comb_size : std::views::iota(0ul, qubits.size())) {
-        bool const is_neg  = comb_size % 2;
-        auto qubit_idx_vec = get_qubit_idx_vec(qubits);
+    // multi-controlled phase gates rotate on every nonempty subset of the qubits;
+    // multi-controlled rotation gates rotate on the target together with every subset of the controls
+    auto const min_comb_size = is_phase_gate ? 1ul : 0ul;
+    for (auto const comb_size : std::views::iota(min_comb_size, min_comb_size + qubits.size())) {
+        bool const is_neg = (comb_size - min_comb_size) % 2;
         for (auto qubit_idx_vec : dvlab::combinations(get_qubit_idx_vec(qubits), comb_size)) {
             if (stop_requested()) {
                 return false;
             }
             auto const pauli_range =
-                std::views::iota(0ul, tableau.n_qubits()) |
-                std::views::transform([&qubit_idx_vec, targ](auto i) -> Pauli {
+                std::views::iota(0ul, n_qubits) |
+                std::views::transform([&qubit_idx_vec, targ, is_phase_gate](auto i) -> Pauli {
                     // if i is in qubit_idx_range, return Z, otherwise I
-                    return (i == targ) || dvlab::contains(qubit_idx_vec, i) ? Pauli::z : Pauli::i;
+                    return (!is_phase_gate && i == targ) || dvlab::contains(qubit_idx_vec, i) ? Pauli::z : Pauli::i;
                 }) |
                 tl::to<std::vector>();
-            last_rotation_group.push_back(PauliRotation(pauli_range.begin(), pauli_range.end(), is_neg ? -phase : phase));
+            emit(PauliProduct(pauli_range.begin(), pauli_range.end(), false), is_neg ? -phase : phase);
         }
     }
     // restore rotation plane
     if (pauli == Pauli::x) {
-        tableau.h(targ);
+        frame.h(targ);
     } else if (pauli == Pauli::y) {
-        tableau.vdg(targ);
+        frame.vdg(targ);
     }
 
     return true;
 }
 
-[[nodiscard]] bool implement_mcp(Tableau& tableau, QubitIdList const& qubits, dvlab::Phase const& ph, Pauli pauli) {
+[[nodiscard]] bool implement_multi_controlled_rotation(Tableau& tableau, QubitIdList const& qubits, dvlab::Phase const& ph, Pauli pauli, bool is_phase_gate) {
     if (std::holds_alternative<StabilizerTableau>(tableau.back())) {
         tableau.push_back(std::vector<PauliRotation>{});
     }
 
-    dvlab::Phase const phase =
-        ph *
-        dvlab::Rational(1, static_cast<int>(std::pow(2, gsl::narrow<double>(qubits.size()) - 1)));
-
-    auto const targ = qubits.back();
-    // convert rotation plane first
-    if (pauli == Pauli::x) {
-        tableau.h(targ);
-    } else if (pauli == Pauli::y) {
-        tableau.v(targ);
-    }
-    // guaranteed to be a vector of PauliRotation
-    auto& last_rotation_group = std::get<std::vector<PauliRotation>>(tableau.back());
+    return emit_multi_controlled_rotations(
+        tableau, tableau.n_qubits(), qubits, ph, pauli, is_phase_gate,
+        [&tableau](PauliProduct const& product, dvlab::Phase const& phase) {
+            // guaranteed to be a vector of PauliRotation
+            std::get<std::vector<PauliRotation>>(tableau.back()).push_back(PauliRotation(product, phase));
+        });
+}
 
-    for (auto const comb_size : std::views::iota(1ul, qubits.size() + 1)) {
-        bool const is_neg  = (comb_size - 1) % 2;
-        auto qubit_idx_vec = get_qubit_idx_vec(qubits);
-        for (auto qubit_idx_vec : dvlab::combinations(get_qubit_idx_vec(qubits), comb_size)) {
-            if (stop_requested()) {
-                return false;
-            }
-            auto const pauli_range =
-                std::views::iota(0ul, tableau.n_qubits()) |
-                std::views::transform([&qubit_idx_vec](auto i) -> Pauli {
-                    return dvlab::contains(qubit_idx_vec, i) ? Pauli::z : Pauli::i;
-                }) |
-                tl::to<std::vector>();
-            last_rotation_group.push_back(PauliRotation(pauli_range.begin(), pauli_range.end(), is_neg ? -phase : phase));
-        }
-    }
-    // restore rotation plane
-    if (pauli == Pauli::x) {
-        tableau.h(targ);
-    } else if (pauli == Pauli::y) {
-        tableau.vdg(targ);
-    }
+[[nodiscard]] bool implement_mcr(Tableau& tableau, QubitIdList const& qubits, dvlab::Phase const& ph, Pauli pauli) {
+    return implement_multi_controlled_rotation(tableau, qubits, ph, pauli, false);
+}
 
-    return true;
+[[nodiscard]] bool implement_mcp(Tableau& tableau, QubitIdList const& qubits, dvlab::Phase const& ph, Pauli pauli) {
+    return implement_multi_controlled_rotation(tableau, qubits, ph, pauli, true);
 }
 
 }  // namespace
@@ -305,7 +293,245 @@ bool append_to_tableau(qcir::ControlGate const& op, experimental::Tableau& table
 
 namespace experimental {
 
+namespace {
+
+/**
+ * @brief Apply a single-qubit P- or R-rotation as Clifford gates if it is a Clifford rotation.
+ *        The cases are the same as in append_to_tableau.
+ *
+ * @return true if the rotation is applied
+ */
+template <typename T>
+bool append_clifford_rotation(dvlab::Phase const& phase, Pauli pauli, PauliProductTrait<T>& tableau, size_t qubit) {
+    if (phase == dvlab::Phase(1)) {
+        switch (pauli) {
+            case Pauli::x:
+                tableau.x(qubit);
+                break;
+            case Pauli::y:
+                tableau.y(qubit);
+                break;
+            default:
+                tableau.z(qubit);
+                break;
+        }
+    } else if (phase == dvlab::Phase(1, 2)) {
+        switch (pauli) {
+            case Pauli::x:
+                tableau.v(qubit);
+                break;
+            case Pauli::y:
+                tableau.sdg(qubit).v(qubit).s(qubit);
+                break;
+            default:
+                tableau.s(qubit);
+                break;
+        }
+    } else if (phase == dvlab::Phase(-1, 2)) {
+        switch (pauli) {
+            case Pauli::x:
+                tableau.vdg(qubit);
+                break;
+            case Pauli::y:
+                tableau.sdg(qubit).vdg(qubit).s(qubit);
+                break;
+            default:
+                tableau.sdg(qubit);
+                break;
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Apply the operation as Clifford gates if append_to_tableau would apply it as Clifford gates
+ *
+ * @return true if the operation is applied; false if it is not a Clifford operation of the supported types
+ */
+template <typename T>
+bool append_clifford(qcir::Operation const& op, PauliProductTrait<T>& tableau, QubitIdList const& qubits) {
+    if (op.get_underlying_if<qcir::IdGate>()) return true;
+    if (op.get_underlying_if<qcir::HGate>()) {
+        tableau.h(qubits[0]);
+        return true;
+    }
+    if (op.get_underlying_if<qcir::SwapGate>()) {
+        tableau.swap(qubits[0], qubits[1]);
+        return true;
+    }
+    if (op.get_underlying_if<qcir::ECRGate>()) {
+        tableau.ecr(qubits[0], qubits[1]);
+        return true;
+    }
+    if (auto const gate = op.get_underlying_if<qcir::PZGate>()) return append_clifford_rotation(gate->get_phase(), Pauli::z, tableau, qubits[0]);
+    if (auto const gate = op.get_underlying_if<qcir::PXGate>()) return append_clifford_rotation(gate->get_phase(), Pauli::x, tableau, qubits[0]);
+    if (auto const gate = op.get_underlying_if<qcir::PYGate>()) return append_clifford_rotation(gate->get_phase(), Pauli::y, tableau, qubits[0]);
+    if (auto const gate = op.get_underlying_if<qcir::RZGate>()) return append_clifford_rotation(gate->get_phase(), Pauli::z, tableau, qubits[0]);
+    if (auto const gate = op.get_underlying_if<qcir::RXGate>()) return append_clifford_rotation(gate->get_phase(), Pauli::x, tableau, qubits[0]);
+    if (auto const gate = op.get_underlying_if<qcir::RYGate>()) return append_clifford_rotation(gate->get_phase(), Pauli::y, tableau, qubits[0]);
+
+    if (auto const gate = op.get_underlying_if<qcir::ControlGate>()) {
+        if (gate->get_num_qubits() != 2) return false;
+        auto const& target_op = gate->get_target_operation();
+        if (auto const target = target_op.get_underlying_if<qcir::PXGate>(); target && target->get_phase() == dvlab::Phase(1)) {
+            tableau.cx(qubits[0], qubits[1]);
+            return true;
+        }
+        if (auto const target = target_op.get_underlying_if<qcir::PYGate>(); target && target->get_phase() == dvlab::Phase(1)) {
+            tableau.sdg(qubits[1]).cx(qubits[0], qubits[1]).s(qubits[1]);
+            return true;
+        }
+        if (auto const target = target_op.get_underlying_if<qcir::PZGate>(); target && target->get_phase() == dvlab::Phase(1)) {
+            tableau.cz(qubits[0], qubits[1]);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+struct MultiControlledRotation {
+    dvlab::Phase phase;
+    Pauli pauli;
+    bool is_phase_gate;
+};
+
+/**
+ * @brief Get the parameters of a non-Clifford operation that append_to_tableau implements with implement_mcp or implement_mcr
+ *
+ * @return the parameters, or std::nullopt if the operation is of other types
+ */
+std::optional<MultiControlledRotation> get_multi_controlled_rotation(qcir::Operation const& operation) {
+    // a controlled gate has the parameters of its target, as long as the target is a P- or R-rotation
+    auto const control_gate = operation.get_underlying_if<qcir::ControlGate>();
+    auto const& op          = control_gate ? control_gate->get_target_operation() : operation;
+
+    if (auto const gate = op.get_underlying_if<qcir::PZGate>()) return MultiControlledRotation{gate->get_phase(), Pauli::z, true};
+    if (auto const gate = op.get_underlying_if<qcir::PXGate>()) return MultiControlledRotation{gate->get_phase(), Pauli::x, true};
+    if (auto const gate = op.get_underlying_if<qcir::PYGate>()) return MultiControlledRotation{gate->get_phase(), Pauli::y, true};
+    if (auto const gate = op.get_underlying_if<qcir::RZGate>()) return MultiControlledRotation{gate->get_phase(), Pauli::z, false};
+    if (auto const gate = op.get_underlying_if<qcir::RXGate>()) return MultiControlledRotation{gate->get_phase(), Pauli::x, false};
+    if (auto const gate = op.get_underlying_if<qcir::RYGate>()) return MultiControlledRotation{gate->get_phase(), Pauli::y, false};
+
+    return std::nullopt;
+}
+
+/**
+ * @brief Convert the QCir to a tableau on column-major packed rows.
+ *        The rows of the Clifford tableau and of all rotations live in one PackedPauliProducts, and the Clifford gates between
+ *        two non-Clifford gates are recorded and applied to all rows in one tiled pass right before the rows are needed.
+ *        The result is identical to that of the gate-by-gate conversion.
+ *
+ * @return the tableau, or std::nullopt if the circuit contains unsupported gates or the conversion is interrupted
+ */
+std::optional<Tableau> to_tableau_packed(qcir::QCir const& qcir) {
+    auto const n_qubits = qcir.get_num_qubits();
+
+    // rows [0, 2n) are the stabilizers and destabilizers;
+    // row 2n + i is the Pauli product of the rotation whose phase is phases[i]
+    PackedPauliProducts rows{n_qubits};
+    StabilizerTableau const identity{n_qubits};
+    for (size_t i = 0; i < n_qubits; ++i) {
+        rows.push_back(identity.stabilizer(i));
+    }
+    for (size_t i = 0; i < n_qubits; ++i) {
+        rows.push_back(identity.destabilizer(i));
+    }
+    std::vector<dvlab::Phase> phases;
+
+    CliffordPrimitiveRecorder pending_cliffords;
+    auto const flush_cliffords = [&]() {
+        rows.apply_primitives(pending_cliffords.primitives());
+        pending_cliffords.clear();
+    };
+
+    for (auto const& gate : qcir.get_gates()) {
+        if (stop_requested()) {
+            return std::nullopt;
+        }
+        auto const& op     = gate->get_operation();
+        auto const& qubits = gate->get_qubits();
+        if (append_clifford(op, pending_cliffords, qubits)) continue;
+
+        auto const rotation = get_multi_controlled_rotation(op);
+        if (!rotation.has_value()) {
+            return std::nullopt;
+        }
+        flush_cliffords();
+        if (!emit_multi_controlled_rotations(
+                rows, n_qubits, qubits, rotation->phase, rotation->pauli, rotation->is_phase_gate,
+                [&rows, &phases](PauliProduct const& product, dvlab::Phase const& phase) {
+                    rows.push_back(product);
+                    phases.push_back(phase);
+                })) {
+            return std::nullopt;
+        }
+    }
+    flush_cliffords();
+
+    StabilizerTableau clifford{n_qubits};
+    for (size_t i = 0; i < n_qubits; ++i) {
+        clifford.stabilizer(i)   = rows.get(i);
+        clifford.destabilizer(i) = rows.get(n_qubits + i);
+    }
+
+    if (phases.empty()) {
+        return Tableau{clifford};
+    }
+
+    std::vector<PauliRotation> rotations;
+    rotations.reserve(phases.size());
+    for (size_t i = 0; i < phases.size(); ++i) {
+        rotations.emplace_back(rows.get(2 * n_qubits + i), phases[i]);
+    }
+
+    return Tableau{clifford, rotations};
+}
+
+}  // namespace
+
+/**
+ * @brief Convert a Clifford circuit to a packed stabilizer tableau. The gates are recorded and applied to the columns
+ *        in tiled batches, and no PauliProduct is ever built, so this scales to circuits with tens of thousands of qubits.
+ *
+ * @return the tableau, or std::nullopt if the circuit contains a gate that is not a Clifford gate of the supported types,
+ *         or the conversion is interrupted
+ */
+std::optional<PackedStabilizerTableau> to_packed_stabilizer_tableau(qcir::QCir const& qcir) {
+    // bounds the memory for the recorded gates of long circuits
+    constexpr size_t clifford_batch_size = 1 << 14;
+
+    PackedStabilizerTableau tableau{qcir.get_num_qubits()};
+    CliffordPrimitiveRecorder pending_cliffords;
+
+    for (auto const& gate : qcir.get_gates()) {
+        if (stop_requested()) {
+            return std::nullopt;
+        }
+        if (!append_clifford(gate->get_operation(), pending_cliffords, gate->get_qubits())) {
+            return std::nullopt;
+        }
+        if (pending_cliffords.primitives().size() >= clifford_batch_size) {
+            tableau.apply_primitives(pending_cliffords.primitives());
+            pending_cliffords.clear();
+        }
+    }
+    tableau.apply_primitives(pending_cliffords.primitives());
+
+    return tableau;
+}
+
 std::optional<Tableau> to_tableau(qcir::QCir const& qcir) {
+    if (auto result = to_tableau_packed(qcir)) {
+        return result;
+    }
+    if (stop_requested()) {
+        return std::nullopt;
+    }
+
+    // fall back to the gate-by-gate conversion, which also handles composite operations
     Tableau result{qcir.get_num_qubits()};
 
     for (auto const& gate : qcir.get_gates()) {
@@ -343,3 +569,4 @@ bool append_to_tableau(qcir::QCir const& qcir, experimental::Tableau& tableau, Q
 }
 
 }  // namespace qsyn
+
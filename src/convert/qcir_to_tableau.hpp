@@ -9,6 +9,7 @@
 
 #include "qcir/operation.hpp"
 #include "qcir/qcir.hpp"
+#include "tableau/packed_stabilizer_tableau.hpp"
 #include "tableau/pauli_rotation.hpp"
 #include "tableau/tableau.hpp"
 
@@ -17,6 +18,7 @@ namespace qsyn {
 namespace experimental {
 
 std::optional<Tableau> to_tableau(qcir::QCir const& qcir);
+std::optional<PackedStabilizerTableau> to_packed_stabilizer_tableau(qcir::QCir const& qcir);
 
 }  // namespace experimental
 
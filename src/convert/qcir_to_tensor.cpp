@@ -15,6 +15,7 @@
 #include "qcir/basic_gate_type.hpp"
 #include "qcir/qcir.hpp"
 #include "qsyn/qsyn_type.hpp"
+#include "tensor/gate_matrix.hpp"
 #include "tensor/qtensor.hpp"
 
 extern bool stop_requested();
@@ -27,31 +28,22 @@ using qsyn::tensor::QTensor;
 
 template <>
 std::optional<QTensor<double>> to_tensor(HGate const& /* op */) {
-    return QTensor<double>::hbox(2);
+    return QTensor<double>::from_gate_matrix(tensor::hgate_matrix<double>);
 }
 
 template <>
 std::optional<QTensor<double>> to_tensor(IdGate const& /* op */) {
-    return QTensor<double>::identity(1);
+    return QTensor<double>::from_gate_matrix(tensor::idgate_matrix<double>);
 }
 
 template <>
 std::optional<QTensor<double>> to_tensor(SwapGate const& /* op */) {
-    auto tensor = QTensor<double>{{1.0, 0.0, 0.0, 0.0},
-                                  {0.0, 0.0, 1.0, 0.0},
-                                  {0.0, 1.0, 0.0, 0.0},
-                                  {0.0, 0.0, 0.0, 1.0}};
-    return tensor.to_qtensor();
+    return QTensor<double>::from_gate_matrix(tensor::swapgate_matrix<double>);
 }
 
 template <>
 std::optional<QTensor<double>> to_tensor(ECRGate const& /* op */) {
-    using namespace std::complex_literals;
-    auto tensor = QTensor<double>{{0.0, 0.0, 1.0 / std::sqrt(2), 1.i / std::sqrt(2)},
-                                  {0.0, 0.0, 1.i / std::sqrt(2), 1.0 / std::sqrt(2)},
-                                  {1.0 / std::sqrt(2), -1.i / std::sqrt(2), 0.0, 0.0},
-                                  {-1.i / std::sqrt(2), 1.0 / std::sqrt(2), 0.0, 0.0}};
-    return tensor.to_qtensor();
+    return QTensor<double>::from_gate_matrix(tensor::ecrgate_matrix<double>);
 }
 
 template <>
@@ -113,7 +105,8 @@ namespace {
  * @param gate new gate
  * @param main main tensor
  */
-void update_tensor_pin(Qubit2TensorPinMap& qubit2pin, QCirGate const& gate, QTensor<double> const& gate_tensor, QTensor<double>& main) {
+template <typename T>
+void update_tensor_pin(Qubit2TensorPinMap& qubit2pin, QCirGate const& gate, QTensor<T> const& gate_tensor, QTensor<T>& main) {
     spdlog::trace("Pin Permutation");
     for (auto& [qubit, pin] : qubit2pin) {
         auto const [old_out, old_in] = pin;
@@ -135,6 +128,24 @@ void update_tensor_pin(Qubit2TensorPinMap& qubit2pin, QCirGate const& gate, QTen
     }
 }
 
+/**
+ * @brief Convert gate to tensor of the given precision. Gate tensors are tiny, so they are always built in double precision and then cast.
+ *
+ * @tparam T
+ * @param gate
+ * @return std::optional<QTensor<T>>
+ */
+template <std::floating_point T>
+std::optional<QTensor<T>> gate_to_tensor_as(QCirGate const& gate) {
+    auto tensor = to_tensor(gate);
+    if constexpr (std::same_as<T, double>) {
+        return tensor;
+    } else {
+        if (!tensor.has_value()) return std::nullopt;
+        return tensor->template astype<T>();
+    }
+}
+
 }  // namespace
 
 /**
@@ -144,14 +155,27 @@ void update_tensor_pin(Qubit2TensorPinMap& qubit2pin, QCirGate const& gate, QTen
  * @return std::optional<QTensor<double>>
  */
 template <>
-std::optional<QTensor<double>> to_tensor(QCir const& qcir) try {
+std::optional<QTensor<double>> to_tensor(QCir const& qcir) {
+    return to_tensor_as<double>(qcir);
+}
+
+/**
+ * @brief Convert QCir to tensor with the given floating-point precision.
+ *        The contraction is carried out entirely in T, so single precision halves the memory footprint.
+ *
+ * @tparam T floating-point type of the tensor elements
+ * @param qcir
+ * @return std::optional<QTensor<T>>
+ */
+template <std::floating_point T>
+std::optional<QTensor<T>> to_tensor_as(QCir const& qcir) try {
     if (qcir.get_num_qubits() == 0) {
         spdlog::warn("QCir is empty!!");
         return std::nullopt;
     }
     spdlog::debug("Add boundary");
 
-    QTensor<double> tensor;
+    QTensor<T> tensor;
 
     // Constructing an identity with large number of qubits takes much time and memory.
     // To make this process interruptible by SIGINT (ctrl-C), we grow the qubit size one by one
@@ -160,7 +184,7 @@ std::optional<QTensor<double>> to_tensor(QCir const& qcir) try {
             spdlog::warn("Conversion interrupted.");
             return std::nullopt;
         }
-        tensor = tensordot(tensor, QTensor<double>::identity(1));
+        tensor = tensordot(tensor, QTensor<T>::identity(1));
     }
 
     Qubit2TensorPinMap qubit_to_pins;  // qubit -> (output, input)
@@ -176,7 +200,7 @@ std::optional<QTensor<double>> to_tensor(QCir const& qcir) try {
             return std::nullopt;
         }
         spdlog::debug("Gate {} ({})", gate->get_id(), gate->get_operation().get_repr());
-        auto const gate_tensor = to_tensor(*gate);
+        auto const gate_tensor = gate_to_tensor_as<T>(*gate);
         if (!gate_tensor.has_value()) {
             spdlog::error("Conversion of Gate {} ({}) to Tensor is not supported yet!!", gate->get_id(), gate->get_operation().get_repr());
             return std::nullopt;
@@ -213,4 +237,7 @@ std::optional<QTensor<double>> to_tensor(QCir const& qcir) try {
     return std::nullopt;
 }
 
+template std::optional<QTensor<float>> to_tensor_as(QCir const& qcir);
+template std::optional<QTensor<double>> to_tensor_as(QCir const& qcir);
+
 }  // namespace qsyn
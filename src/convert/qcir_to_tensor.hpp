@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <concepts>
+
 #include "qcir/qcir.hpp"
 #include "qcir/qcir_gate.hpp"
 #include "tensor/qtensor.hpp"
@@ -19,4 +21,7 @@ std::optional<qsyn::tensor::QTensor<double>> to_tensor(QCirGate const& gate);
 template <>
 std::optional<qsyn::tensor::QTensor<double>> to_tensor(QCir const& qcir);
 
+template <std::floating_point T>
+std::optional<qsyn::tensor::QTensor<T>> to_tensor_as(QCir const& qcir);
+
 }  // namespace qsyn
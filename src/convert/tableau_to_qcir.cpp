@@ -7,12 +7,18 @@
 
 #include "./tableau_to_qcir.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <gsl/narrow>
+#include <optional>
+#include <span>
 #include <tl/adjacent.hpp>
 #include <tl/to.hpp>
+#include <unordered_map>
 
 #include "qcir/basic_gate_type.hpp"
 #include "qcir/qcir.hpp"
+#include "util/boolean_matrix.hpp"
 #include "util/phase.hpp"
 
 extern bool stop_requested();
@@ -110,9 +116,252 @@ std::optional<qcir::QCir> NaivePauliRotationsSynthesisStrategy::synthesize(std::
     return qcir;
 }
 
-std::optional<qcir::QCir> TParPauliRotationsSynthesisStrategy::synthesize(std::vector<PauliRotation> const& /* rotations */) const {
-    spdlog::error("TPar Synthesis Strategy is not implemented yet!!");
-    return std::nullopt;
+namespace {
+
+/**
+ * @brief The parities of the terms of a phase polynomial, stored column-major.
+ *        Column q packs bit q of every term's parity into 64-bit words, so that
+ *        updating all terms through a CNOT is a word-wise XOR of two columns.
+ *
+ */
+class ParityColumns {
+public:
+    using Word = std::uint64_t;
+
+    ParityColumns(size_t n_qubits, size_t n_terms) : _n_words{(n_terms + _word_bits - 1) / _word_bits}, _words(n_qubits * _n_words, 0) {}
+
+    bool get(size_t qubit, size_t term) const { return (_words[qubit * _n_words + term / _word_bits] >> (term % _word_bits)) & 1; }
+    void set(size_t qubit, size_t term) { _words[qubit * _n_words + term / _word_bits] |= Word{1} << (term % _word_bits); }
+
+    /**
+     * @brief Update the parities after a CNOT: the wire values change from y to y' with y'_targ = y_targ ^ y_ctrl,
+     *        so a term containing y_targ now also contains y'_ctrl.
+     */
+    void cx(size_t ctrl, size_t targ) {
+        for (size_t w = 0; w < _n_words; ++w) {
+            _words[ctrl * _n_words + w] ^= _words[targ * _n_words + w];
+        }
+    }
+
+private:
+    static constexpr size_t _word_bits = 64;
+    size_t _n_words;
+    std::vector<Word> _words;
+};
+
+// block size of the Gaussian elimination that restores the wires after a parity network
+constexpr size_t parity_network_block_size = 5;
+
+/**
+ * @brief Synthesize a phase polynomial with the GraySynth parity network of
+ *        Amy, Azimzadeh, and Mosca, "On the CNOT-complexity of CNOT-phase circuits," 2018.
+ *        The terms are recursively partitioned by the qubit that splits them most unevenly,
+ *        so terms sharing parities are synthesized together and reuse the same CNOTs.
+ *        A phase is applied as soon as a wire carries its parity, and the wires are restored at the end.
+ *
+ * @param qcir the circuit to append to
+ * @param parities the parities of the terms; should be nonzero and pairwise distinct
+ * @param phases the phases of the terms
+ * @return true if successful, false if interrupted
+ */
+bool add_parity_network(qcir::QCir& qcir, ParityColumns parities, std::vector<dvlab::Phase> const& phases) {
+    auto const n_qubits = qcir.get_num_qubits();
+    // row q is the parity wire q carries
+    auto wire_parities = dvlab::identity(n_qubits);
+
+    auto const add_cx = [&](size_t ctrl, size_t targ) {
+        qcir.append(qcir::CXGate(), {ctrl, targ});
+        parities.cx(ctrl, targ);
+        wire_parities.row_operation(ctrl, targ);
+    };
+
+    // invariants: all terms agree on the qubits that are neither remaining nor the target,
+    //             and all terms contain the target if it is set
+    struct Partition {
+        std::vector<size_t> terms;
+        std::vector<size_t> remaining_qubits;
+        std::optional<size_t> target;
+    };
+    std::vector<Partition> stack;
+    stack.push_back({std::views::iota(0ul, phases.size()) | tl::to<std::vector>(),
+                     std::views::iota(0ul, n_qubits) | tl::to<std::vector>(),
+                     std::nullopt});
+
+    while (!stack.empty()) {
+        if (stop_requested()) {
+            return false;
+        }
+        auto partition = std::move(stack.back());
+        stack.pop_back();
+        auto& terms            = partition.terms;
+        auto& remaining_qubits = partition.remaining_qubits;
+        auto const& target     = partition.target;
+
+        if (terms.empty()) continue;
+
+        if (target.has_value()) {
+            // move the qubits shared by all terms onto the target wire
+            for (size_t qubit = 0; qubit < n_qubits; ++qubit) {
+                if (qubit == *target) continue;
+                if (std::ranges::all_of(terms, [&](size_t term) { return parities.get(qubit, term); })) {
+                    add_cx(qubit, *target);
+                }
+            }
+            if (remaining_qubits.empty()) {
+                // the target wire carries exactly the parity of the terms
+                for (auto const term : terms) {
+                    qcir.append(qcir::PZGate(phases[term]), {*target});
+                }
+                continue;
+            }
+        } else if (remaining_qubits.empty()) {
+            continue;
+        }
+
+        auto const count_ones = [&](size_t qubit) {
+            return gsl::narrow<size_t>(std::ranges::count_if(terms, [&](size_t term) { return parities.get(qubit, term); }));
+        };
+        auto const split_qubit = std::ranges::max(remaining_qubits, {}, [&](size_t qubit) {
+            auto const n_ones = count_ones(qubit);
+            return std::max(n_ones, terms.size() - n_ones);
+        });
+
+        std::vector<size_t> zeros, ones;
+        for (auto const term : terms) {
+            (parities.get(split_qubit, term) ? ones : zeros).push_back(term);
+        }
+        std::erase(remaining_qubits, split_qubit);
+
+        stack.push_back({std::move(ones), remaining_qubits, target.value_or(split_qubit)});
+        stack.push_back({std::move(zeros), std::move(remaining_qubits), target});
+    }
+
+    // restore the wires to their original values
+    wire_parities.gaussian_elimination_skip(parity_network_block_size, true, true);
+    for (auto const& [ctrl, targ] : wire_parities.get_row_operations()) {
+        qcir.append(qcir::CXGate(), {ctrl, targ});
+    }
+
+    return true;
+}
+
+/**
+ * @brief Synthesize rotations that agree on the Pauli of every qubit they share.
+ *        The single-qubit basis changes of naive synthesis turn all of them into Z-rotations at once,
+ *        which are then synthesized as one phase polynomial.
+ *
+ * @param qcir the circuit to append to
+ * @param rotations the rotations
+ * @param basis the common non-identity Pauli on each qubit, or Pauli::i if no rotation acts on it
+ * @return true if successful, false if interrupted
+ */
+bool add_rotation_block(qcir::QCir& qcir, std::span<PauliRotation const> rotations, std::vector<Pauli> const& basis) {
+    auto const n_qubits = qcir.get_num_qubits();
+
+    // merge the rotations on the same parity; rotations on no qubit only contribute a global phase
+    std::unordered_map<std::vector<bool>, size_t> term_ids;
+    std::vector<std::vector<bool>> supports;
+    std::vector<dvlab::Phase> phases;
+    for (auto const& rotation : rotations) {
+        auto support = std::vector<bool>(n_qubits);
+        for (size_t qubit = 0; qubit < n_qubits; ++qubit) {
+            support[qubit] = !rotation.is_i(qubit);
+        }
+        if (std::find(support.begin(), support.end(), true) == support.end()) continue;
+        if (auto const it = term_ids.find(support); it != term_ids.end()) {
+            phases[it->second] += rotation.phase();
+        } else {
+            term_ids.emplace(support, supports.size());
+            supports.push_back(std::move(support));
+            phases.push_back(rotation.phase());
+        }
+    }
+
+    std::vector<dvlab::Phase> nonzero_phases;
+    std::vector<size_t> nonzero_terms;
+    for (size_t i = 0; i < phases.size(); ++i) {
+        if (phases[i] == dvlab::Phase(0)) continue;
+        nonzero_phases.push_back(phases[i]);
+        nonzero_terms.push_back(i);
+    }
+    if (nonzero_terms.empty()) return true;
+
+    ParityColumns parities{n_qubits, nonzero_terms.size()};
+    for (size_t i = 0; i < nonzero_terms.size(); ++i) {
+        for (size_t qubit = 0; qubit < n_qubits; ++qubit) {
+            if (supports[nonzero_terms[i]][qubit]) parities.set(qubit, i);
+        }
+    }
+
+    using COT = CliffordOperatorType;
+    CliffordOperatorString basis_change;
+    for (size_t qubit = 0; qubit < n_qubits; ++qubit) {
+        if (basis[qubit] == Pauli::x) {
+            basis_change.emplace_back(COT::h, std::array<size_t, 2>{qubit});
+        } else if (basis[qubit] == Pauli::y) {
+            basis_change.emplace_back(COT::v, std::array<size_t, 2>{qubit});
+        }
+    }
+
+    for (auto const& op : basis_change) {
+        add_clifford_gate(qcir, op);
+    }
+
+    if (!add_parity_network(qcir, std::move(parities), nonzero_phases)) {
+        return false;
+    }
+
+    adjoint_inplace(basis_change);
+    for (auto const& op : basis_change) {
+        add_clifford_gate(qcir, op);
+    }
+
+    return true;
+}
+
+}  // namespace
+
+/**
+ * @brief Synthesize the rotations with parity networks. Consecutive rotations are grouped into blocks in which
+ *        every qubit is acted on by the same Pauli; such rotations commute and share one basis change,
+ *        so each block becomes a phase polynomial synthesized with GraySynth.
+ *
+ * @param rotations
+ * @return std::optional<qcir::QCir>
+ */
+std::optional<qcir::QCir> TParPauliRotationsSynthesisStrategy::synthesize(std::vector<PauliRotation> const& rotations) const {
+    if (rotations.empty()) {
+        return qcir::QCir{0};
+    }
+
+    auto const n_qubits = rotations.front().n_qubits();
+    auto qcir           = qcir::QCir{n_qubits};
+
+    std::vector<Pauli> basis(n_qubits, Pauli::i);
+    auto const is_compatible = [&basis, n_qubits](PauliRotation const& rotation) {
+        return std::ranges::all_of(std::views::iota(0ul, n_qubits), [&](size_t qubit) {
+            return rotation.is_i(qubit) || basis[qubit] == Pauli::i || basis[qubit] == rotation.get_pauli_type(qubit);
+        });
+    };
+
+    size_t block_begin = 0;
+    for (size_t i = 0; i < rotations.size(); ++i) {
+        if (!is_compatible(rotations[i])) {
+            if (!add_rotation_block(qcir, std::span{rotations}.subspan(block_begin, i - block_begin), basis)) {
+                return std::nullopt;
+            }
+            block_begin = i;
+            std::ranges::fill(basis, Pauli::i);
+        }
+        for (size_t qubit = 0; qubit < n_qubits; ++qubit) {
+            if (!rotations[i].is_i(qubit)) basis[qubit] = rotations[i].get_pauli_type(qubit);
+        }
+    }
+    if (!add_rotation_block(qcir, std::span{rotations}.subspan(block_begin), basis)) {
+        return std::nullopt;
+    }
+
+    return qcir;
 }
 
 /**
@@ -26,18 +26,19 @@ namespace qsyn {
 
 namespace {
 
+template <std::floating_point T>
 class ZX2TSMapper {
 public:
     using Frontiers = dvlab::utils::ordered_hashmap<zx::EdgePair, size_t, zx::EdgePairHash>;
 
-    std::optional<tensor::QTensor<double>> map(zx::ZXGraph const& graph);
+    std::optional<tensor::QTensor<T>> map(zx::ZXGraph const& graph);
 
 private:
     std::vector<zx::EdgePair> _boundary_edges;  // EdgePairs of the boundaries
 
     struct FrontiersTensorPair {
         Frontiers frontiers;
-        tensor::QTensor<double> tensor;
+        tensor::QTensor<T> tensor;
     };
     std::vector<FrontiersTensorPair> _zx2ts_list;  // The tensor list for each set of frontiers
     size_t _current_tensor_id = 0;                 // Current tensor id for the _tensorId
@@ -66,7 +67,7 @@ private:
     // mapOneVertex Subroutines
     void _initialize_subgraph(zx::ZXGraph const& graph, zx::ZXVertex* v);
     MappingInfo _calculate_mapping_info(zx::ZXGraph const& graph, zx::ZXVertex* v);
-    tensor::QTensor<double> _dehadamardize(tensor::QTensor<double> const& ts, MappingInfo& info);
+    tensor::QTensor<T> _dehadamardize(tensor::QTensor<T> const& ts, MappingInfo& info);
     void _tensordot_vertex(zx::ZXGraph const& graph, zx::ZXVertex* v);
 
     size_t _get_tensor_id(zx::ZXGraph const& graph, zx::ZXVertex* v);
@@ -84,16 +85,27 @@ private:
 }  // namespace
 
 std::optional<tensor::QTensor<double>> to_tensor(zx::ZXGraph const& zxgraph) {
-    ZX2TSMapper mapper;
+    return to_tensor_as<double>(zxgraph);
+}
+
+/**
+ * @brief convert a zxgraph to a tensor with the given floating-point precision
+ *
+ * @tparam T floating-point type of the tensor elements
+ */
+template <std::floating_point T>
+std::optional<tensor::QTensor<T>> to_tensor_as(zx::ZXGraph const& zxgraph) {
+    ZX2TSMapper<T> mapper;
     return mapper.map(zxgraph);
 }
 
 /**
  * @brief convert a zxgraph to a tensor
  *
- * @return std::optional<QTensor<double>> containing a QTensor<double> if the conversion succeeds
+ * @return std::optional<QTensor<T>> containing a QTensor<T> if the conversion succeeds
  */
-std::optional<tensor::QTensor<double>> ZX2TSMapper::map(zx::ZXGraph const& graph) try {
+template <std::floating_point T>
+std::optional<tensor::QTensor<T>> ZX2TSMapper<T>::map(zx::ZXGraph const& graph) try {
     using namespace std::complex_literals;
     if (graph.is_empty()) {
         spdlog::error("The ZXGraph is empty!!");
@@ -111,8 +123,8 @@ std::optional<tensor::QTensor<double>> ZX2TSMapper::map(zx::ZXGraph const& graph
         return std::nullopt;
     }
 
-    tensor::QTensor<double> result =
-        tl::fold_left(_zx2ts_list, tensor::QTensor<double>(1. + 0.i),
+    tensor::QTensor<T> result =
+        tl::fold_left(_zx2ts_list, tensor::QTensor<T>(),
                       [](auto const& a, auto const& b) { return tensordot(a, b.tensor); });
 
     std::ranges::for_each(std::views::iota(0ul, _zx2ts_list.size()), [this](auto const i) {
@@ -136,24 +148,32 @@ std::optional<tensor::QTensor<double>> ZX2TSMapper::map(zx::ZXGraph const& graph
  * @brief Get Tensor form of Z, X spider, or H box
  *
  * @param v the ZXVertex
- * @return QTensor<double>
+ * @return QTensor<T>
  */
-tensor::QTensor<double> get_tensor_form(zx::ZXGraph const& graph, zx::ZXVertex* v) {
-    using namespace std::complex_literals;
-    switch (v->get_type()) {
-        case zx::VertexType::z:
-            return tensor::QTensor<double>::zspider(graph.get_num_neighbors(v), v->get_phase());
-        case zx::VertexType::x:
-            return tensor::QTensor<double>::xspider(graph.get_num_neighbors(v), v->get_phase());
-        case zx::VertexType::h_box:
-            return tensor::QTensor<double>::hbox(graph.get_num_neighbors(v));
-        case zx::VertexType::boundary:
-            return tensor::QTensor<double>::identity(graph.get_num_neighbors(v));
-    }
+template <std::floating_point T>
+tensor::QTensor<T> get_tensor_form(zx::ZXGraph const& graph, zx::ZXVertex* v) {
+    if constexpr (!std::same_as<T, double>) {
+        // vertex tensors are small; build them in double precision and cast
+        return get_tensor_form<double>(graph, v).template astype<T>();
+    } else {
+        switch (v->get_type()) {
+            case zx::VertexType::z:
+                return tensor::QTensor<T>::zspider(graph.get_num_neighbors(v), v->get_phase());
+            case zx::VertexType::x:
+                return tensor::QTensor<T>::xspider(graph.get_num_neighbors(v), v->get_phase());
+            case zx::VertexType::h_box:
+                return tensor::QTensor<T>::hbox(graph.get_num_neighbors(v));
+            case zx::VertexType::boundary:
+                return tensor::QTensor<T>::identity(graph.get_num_neighbors(v));
+        }
 
-    return tensor::QTensor<double>(1. + 0.i);
+        return tensor::QTensor<T>();
+    }
 }
 
+template tensor::QTensor<float> get_tensor_form(zx::ZXGraph const& graph, zx::ZXVertex* v);
+template tensor::QTensor<double> get_tensor_form(zx::ZXGraph const& graph, zx::ZXVertex* v);
+
 namespace {
 
 /**
@@ -161,7 +181,8 @@ namespace {
  *
  * @param v the tensor of whom
  */
-void ZX2TSMapper::_map_one_vertex(zx::ZXGraph const& graph, zx::ZXVertex* v) {
+template <std::floating_point T>
+void ZX2TSMapper<T>::_map_one_vertex(zx::ZXGraph const& graph, zx::ZXVertex* v) {
     if (stop_requested()) return;
     _current_tensor_id = _get_tensor_id(graph, v);
 
@@ -185,16 +206,17 @@ void ZX2TSMapper::_map_one_vertex(zx::ZXGraph const& graph, zx::ZXVertex* v) {
  *
  * @param v the boundary vertex to start the mapping
  */
-void ZX2TSMapper::_initialize_subgraph(zx::ZXGraph const& graph, zx::ZXVertex* v) {
+template <std::floating_point T>
+void ZX2TSMapper<T>::_initialize_subgraph(zx::ZXGraph const& graph, zx::ZXVertex* v) {
     using namespace std::complex_literals;
     assert(v->is_boundary());
     spdlog::debug("Mapping vertex {:>4} ({}): New Subgraph", v->get_id(), v->get_type());
     auto [nb, etype] = graph.get_first_neighbor(v);
 
     _current_tensor_id = _zx2ts_list.size();
-    _zx2ts_list.emplace_back(Frontiers(), tensor::QTensor<double>(1. + 0.i));
+    _zx2ts_list.emplace_back(Frontiers(), tensor::QTensor<T>());
 
-    _curr_tensor()      = tensordot(_curr_tensor(), tensor::QTensor<double>::identity(graph.get_num_neighbors(v)));
+    _curr_tensor()      = tensordot(_curr_tensor(), tensor::QTensor<T>::identity(graph.get_num_neighbors(v)));
     auto const edge_key = make_edge_pair(v, nb, etype);
     _boundary_edges.emplace_back(edge_key);
     _curr_frontiers().emplace(edge_key, 1);
@@ -206,7 +228,8 @@ void ZX2TSMapper::_initialize_subgraph(zx::ZXGraph const& graph, zx::ZXVertex* v
  * @param v vertex
  * @return the tensor id
  */
-size_t ZX2TSMapper::_get_tensor_id(zx::ZXGraph const& graph, zx::ZXVertex* v) {
+template <std::floating_point T>
+size_t ZX2TSMapper<T>::_get_tensor_id(zx::ZXGraph const& graph, zx::ZXVertex* v) {
     auto const it = std::ranges::find_if(
         graph.get_neighbors(v),
         [this](auto const& neighbor) {
@@ -226,7 +249,8 @@ size_t ZX2TSMapper::_get_tensor_id(zx::ZXGraph const& graph, zx::ZXVertex* v) {
  * @param zxgraph
  * @return std::pair<TensorAxisList, TensorAxisList> input and output tensor axis lists
  */
-ZX2TSMapper::InOutAxisList ZX2TSMapper::_get_axis_orders(zx::ZXGraph const& zxgraph) {
+template <std::floating_point T>
+typename ZX2TSMapper<T>::InOutAxisList ZX2TSMapper<T>::_get_axis_orders(zx::ZXGraph const& zxgraph) {
     InOutAxisList axis_lists{zxgraph.get_num_inputs(), zxgraph.get_num_outputs()};
 
     auto const get_table = [](auto vertex_list) -> std::map<size_t, size_t> {
@@ -280,7 +304,8 @@ ZX2TSMapper::InOutAxisList ZX2TSMapper::_get_axis_orders(zx::ZXGraph const& zxgr
  *
  * @param v the current vertex
  */
-ZX2TSMapper::MappingInfo ZX2TSMapper::_calculate_mapping_info(zx::ZXGraph const& graph, zx::ZXVertex* v) {
+template <std::floating_point T>
+typename ZX2TSMapper<T>::MappingInfo ZX2TSMapper<T>::_calculate_mapping_info(zx::ZXGraph const& graph, zx::ZXVertex* v) {
     MappingInfo info;
 
     for (auto& nbr : graph.get_neighbors(v)) {
@@ -309,9 +334,10 @@ ZX2TSMapper::MappingInfo ZX2TSMapper::_calculate_mapping_info(zx::ZXGraph const&
  * @param ts original tensor before converting
  * @return QTensor<double>
  */
-tensor::QTensor<double> ZX2TSMapper::_dehadamardize(tensor::QTensor<double> const& ts, MappingInfo& info) {
+template <std::floating_point T>
+tensor::QTensor<T> ZX2TSMapper<T>::_dehadamardize(tensor::QTensor<T> const& ts, MappingInfo& info) {
     auto const h_tensor_product = tensor_product_pow(
-        tensor::QTensor<double>::hbox(2), info.hadamard_edge_pins.size());
+        tensor::QTensor<T>::hbox(2), info.hadamard_edge_pins.size());
 
     qsyn::tensor::TensorAxisList connect_pin =
         std::views::iota(0ul, info.hadamard_edge_pins.size()) |
@@ -349,7 +375,8 @@ tensor::QTensor<double> ZX2TSMapper::_dehadamardize(tensor::QTensor<double> cons
  *
  * @param v current vertex
  */
-void ZX2TSMapper::_tensordot_vertex(zx::ZXGraph const& graph, zx::ZXVertex* v) {
+template <std::floating_point T>
+void ZX2TSMapper<T>::_tensordot_vertex(zx::ZXGraph const& graph, zx::ZXVertex* v) {
     auto info = _calculate_mapping_info(graph, v);
 
     if (v->is_boundary()) {
@@ -363,7 +390,7 @@ void ZX2TSMapper::_tensordot_vertex(zx::ZXGraph const& graph, zx::ZXVertex* v) {
     // we don't care which pins to connect because all vertices correspond to a symmetric tensor
     auto const vertex_pins_to_connect = std::views::iota(0ul, info.simple_edge_pins.size()) | tl::to<std::vector>();
 
-    _curr_tensor() = tensordot(dehadamarded, get_tensor_form(graph, v), info.simple_edge_pins, vertex_pins_to_connect);
+    _curr_tensor() = tensordot(dehadamarded, get_tensor_form<T>(graph, v), info.simple_edge_pins, vertex_pins_to_connect);
 
     for (auto const& edge : info.frontiers_to_remove) {
         _curr_frontiers().erase(edge);
@@ -383,4 +410,7 @@ void ZX2TSMapper::_tensordot_vertex(zx::ZXGraph const& graph, zx::ZXVertex* v) {
 
 }  // namespace
 
+template std::optional<tensor::QTensor<float>> to_tensor_as(zx::ZXGraph const& zxgraph);
+template std::optional<tensor::QTensor<double>> to_tensor_as(zx::ZXGraph const& zxgraph);
+
 }  // namespace qsyn
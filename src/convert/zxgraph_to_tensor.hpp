@@ -6,6 +6,7 @@
 ****************************************************************************/
 #pragma once
 
+#include <concepts>
 #include <cstddef>
 #include <vector>
 
@@ -23,6 +24,10 @@ class ZXVertex;
 
 std::optional<tensor::QTensor<double>> to_tensor(zx::ZXGraph const& zxgraph);
 
-tensor::QTensor<double> get_tensor_form(zx::ZXGraph const& graph, zx::ZXVertex* v);
+template <std::floating_point T>
+std::optional<tensor::QTensor<T>> to_tensor_as(zx::ZXGraph const& zxgraph);
+
+template <std::floating_point T = double>
+tensor::QTensor<T> get_tensor_form(zx::ZXGraph const& graph, zx::ZXVertex* v);
 
 }  // namespace qsyn
@@ -17,7 +17,6 @@
 #include <gsl/narrow>
 #include <ranges>
 #include <string>
-#include <tl/enumerate.hpp>
 #include <tl/to.hpp>
 #include <utility>
 
@@ -25,6 +24,7 @@
 #include "qcir/qcir_gate.hpp"
 #include "qsyn/qsyn_type.hpp"
 #include "util/dvlab_string.hpp"
+#include "util/parallel.hpp"
 #include "util/util.hpp"
 
 using namespace qsyn::qcir;
@@ -90,6 +90,18 @@ void Topology::add_adjacency_info(size_t a, size_t b, DeviceInfo info) {
     _adjacency_info[std::make_pair(a, b)] = info;
 }
 
+/**
+ * @brief Couple qubits a and b
+ *
+ * @param a Id of first qubit
+ * @param b Id of second qubit
+ */
+void Topology::add_adjacency(size_t a, size_t b) {
+    _adjacencies[a].emplace_back(b);
+    _adjacencies[b].emplace_back(a);
+    _clear_shortest_paths();
+}
+
 /**
  * @brief Add qubit information
  *
@@ -101,83 +113,81 @@ void Topology::add_qubit_info(size_t a, DeviceInfo info) {
 }
 
 /**
- * @brief Resize distance and predecessor lists
+ * @brief Get the number of hops from a to b
  *
+ * @param a
+ * @param b
+ * @return size_t, or default_max_dist if b is unreachable from a
  */
-void Topology::resize_to_num_qubit() {
-    _distance.resize(_num_qubit);
-    _predecessor.resize(_num_qubit);
-
-    for (size_t i = 0; i < _num_qubit; i++) {
-        _distance[i].resize(_num_qubit);
-        _predecessor[i].resize(_num_qubit, max_qubit_id);
-    }
+size_t Topology::get_distance(size_t a, size_t b) const {
+    auto const dist = _get_distances()[a * _num_qubit + b];
+    return dist == unreachable ? default_max_dist : dist;
 }
 
 /**
- * @brief Initialize predecessor and distance lists
+ * @brief Get the qubit next to `src` on a shortest path from `src` to `dest`.
+ *        The predecessors are not stored; the neighbor of `src` with the smallest id that is one hop closer to `dest` is taken.
  *
- * @param adjacency_matrix
- * @param qubit_list
+ * @param dest
+ * @param src
+ * @return size_t, or max_qubit_id if src == dest or dest is unreachable
  */
-void Topology::_init_predecessor_and_distance(const std::vector<std::vector<QubitIdType>>& adjacency_matrix, const std::vector<PhysicalQubit>& qubit_list) {
-    resize_to_num_qubit();
-    for (size_t i = 0; i < _num_qubit; i++) {
-        for (size_t j = 0; j < _num_qubit; j++) {
-            _distance[i][j] = adjacency_matrix[i][j];
-            if (_distance[i][j] != 0 && _distance[i][j] != _max_dist) {
-                _predecessor[i][j] = qubit_list[i].get_id();
-            }
-        }
+size_t Topology::get_predecessor(size_t dest, size_t src) const {
+    auto const* row = _get_distances() + dest * _num_qubit;
+    auto const dist = row[src];
+    if (dist == 0 || dist == unreachable) return max_qubit_id;
+    auto closer = std::views::filter(_adjacencies[src], [&](QubitIdType adj) { return row[adj] + 1 == dist; });
+    if (std::ranges::empty(closer)) {
+        DVLAB_UNREACHABLE("no neighbor is closer to the destination; the distances are inconsistent with the topology");
     }
+    return std::ranges::min(closer);
+}
+
+Topology::Distance const* Topology::_get_distances() const {
+    return _distance_file != nullptr
+               ? reinterpret_cast<Distance const*>(_distance_file->data().data() + _distance_offset)  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast) : the cache aligns the distances
+               : _distance.data();
+}
+
+void Topology::_clear_shortest_paths() {
+    _distance.clear();
+    _distance_file.reset();
 }
 
 /**
- * @brief Set weight of edge used in Floyd-Warshall
+ * @brief Fill in the distances from `source` to every qubit
  *
- * @param adjacency_matrix
- * @param qubit_list
+ * @param source
  */
-void Topology::_set_weight(std::vector<std::vector<QubitIdType>>& adjacency_matrix, const std::vector<PhysicalQubit>& qubit_list) const {
-    assert(adjacency_matrix.size() == _num_qubit);
-    for (size_t i = 0; i < _num_qubit; i++) {
-        for (auto const& adj : qubit_list[i].get_adjacencies()) {
-            adjacency_matrix[i][adj] = 1;
+void Topology::_breadth_first_search(size_t source) {
+    auto* row   = _distance.data() + source * _num_qubit;
+    row[source] = 0;
+    std::vector<QubitIdType> queue;
+    queue.reserve(_num_qubit);
+    queue.emplace_back(source);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        auto const curr = queue[head];
+        for (auto const next : _adjacencies[curr]) {
+            if (row[next] != unreachable) continue;
+            row[next] = static_cast<Distance>(row[curr] + 1);
+            queue.emplace_back(next);
         }
     }
 }
 
 /**
- * @brief Floyd-Warshall Algorithm. Solve All Pairs Shortest Path (APSP)
+ * @brief Solve All Pairs Shortest Path (APSP) by a BFS from every qubit. The coupling graph is sparse and every edge
+ *        counts as one hop, so this takes O(V(V + E)) time in place of the O(V^3) of Floyd-Warshall, and the sources are
+ *        independent of each other. The distances are kept as a flat V x V matrix of 16-bit integers.
  *
- * @param adjacency_matrix
- * @param qubit_list
+ * @param n_jobs number of threads to run the BFS on. 0 means using all hardware threads
  */
-void Topology::floyd_warshall(std::vector<std::vector<QubitIdType>>& adjacency_matrix, const std::vector<PhysicalQubit>& qubit_list) {
-    _set_weight(adjacency_matrix, qubit_list);
-    _init_predecessor_and_distance(adjacency_matrix, qubit_list);
-    for (size_t k = 0; k < _num_qubit; k++) {
-        spdlog::debug("Including vertex({}):", k);
-        for (size_t i = 0; i < _num_qubit; i++) {
-            for (size_t j = 0; j < _num_qubit; j++) {
-                if ((_distance[i][j] > _distance[i][k] + _distance[k][j]) && (_distance[i][k] != _max_dist)) {
-                    _distance[i][j]    = _distance[i][k] + _distance[k][j];
-                    _predecessor[i][j] = _predecessor[k][j];
-                }
-            }
-        }
+void Topology::calculate_shortest_paths(size_t n_jobs) {
+    DVLAB_ASSERT(_num_qubit < unreachable, fmt::format("The number of qubits should be less than {} to compute the shortest paths!!", unreachable));
 
-        spdlog::debug("Predecessor Matrix:");
-        for (auto& row : _predecessor) {
-            spdlog::debug("{:5}", fmt::join(
-                                      row | std::views::transform([](auto j) { return (j == max_qubit_id) ? std::string{"/"} : std::to_string(j); }), ""));
-        }
-        spdlog::debug("Distance Matrix:");
-        for (auto& row : _distance) {
-            spdlog::debug("{:5}", fmt::join(
-                                      row | std::views::transform([this](size_t j) { return (j == _max_dist) ? std::string{"X"} : std::to_string(j); }), ""));
-        }
-    }
+    _distance_file.reset();
+    _distance.assign(_num_qubit * _num_qubit, unreachable);
+    dvlab::utils::parallel_for(_num_qubit, [this](size_t source) { _breadth_first_search(source); }, n_jobs);
 }
 
 /**
@@ -208,40 +218,6 @@ std::ostream& operator<<(std::ostream& os, PhysicalQubit const& q) {
     return os << fmt::format("{}", q);
 }
 
-/**
- * @brief Mark qubit
- *
- * @param source false: from 0, true: from 1
- * @param pred predecessor
- */
-void PhysicalQubit::mark(bool source, QubitIdType pred) {
-    _marked = true;
-    _source = source;
-    _pred   = pred;
-}
-
-/**
- * @brief Take the route
- *
- * @param cost
- * @param swapTime
- */
-void PhysicalQubit::take_route(size_t cost, size_t swap_time) {
-    _cost      = cost;
-    _swap_time = swap_time;
-    _taken     = true;
-}
-
-/**
- * @brief Reset qubit
- *
- */
-void PhysicalQubit::reset() {
-    _marked = false;
-    _taken  = false;
-    _cost   = _occupied_time;
-}
-
 // SECTION - Class Device Member Functions
 
 /**
@@ -257,7 +233,7 @@ std::tuple<QubitIdType, QubitIdType> Device::get_next_swap_cost(QubitIdType sour
     auto const& q_next   = get_physical_qubit(next_idx);
     auto const cost      = std::max(q_source.get_occupied_time(), q_next.get_occupied_time());
 
-    assert(q_source.is_adjacency(q_next));
+    assert(is_adjacent(source, next_idx));
     return {next_idx, cost};
 }
 
@@ -268,14 +244,28 @@ std::tuple<QubitIdType, QubitIdType> Device::get_next_swap_cost(QubitIdType sour
  * @return size_t
  */
 QubitIdType Device::get_physical_by_logical(QubitIdType id) {
-    for (auto& phy : _qubit_list) {
-        if (phy.get_logical_qubit() == id) {
-            return phy.get_id();
+    for (size_t i = 0; i < _num_qubit; ++i) {
+        if (_qubit_list[i].get_logical_qubit() == id) {
+            return _qubit_list[i].get_id();
         }
     }
     return max_qubit_id;
 }
 
+/**
+ * @brief Replace the physical qubits with `num_qubits` unassigned ones
+ *
+ * @param num_qubits
+ */
+void Device::_reset_qubit_list(size_t num_qubits) {
+    std::vector<PhysicalQubit> qubits;
+    qubits.reserve(num_qubits);
+    for (size_t i = 0; i < num_qubits; ++i) {
+        qubits.emplace_back(PhysicalQubit(i));
+    }
+    _qubit_list = PhysicalQubitList{std::move(qubits)};
+}
+
 /**
  * @brief Add adjacency pair (a,b)
  *
@@ -284,8 +274,7 @@ QubitIdType Device::get_physical_by_logical(QubitIdType id) {
  */
 void Device::add_adjacency(QubitIdType a, QubitIdType b) {
     if (a > b) std::swap(a, b);
-    _qubit_list[a].add_adjacency(_qubit_list[b].get_id());
-    _qubit_list[b].add_adjacency(_qubit_list[a].get_id());
+    _topology->add_adjacency(a, b);
     constexpr DeviceInfo default_info = {._time = 0.0, ._error = 0.0};
     _topology->add_adjacency_info(a, b, default_info);
 }
@@ -297,8 +286,8 @@ void Device::add_adjacency(QubitIdType a, QubitIdType b) {
  */
 void Device::apply_gate(qcir::QCirGate const& op, size_t time_begin) {
     auto qubits = op.get_qubits();
-    auto& q0    = get_physical_qubit(qubits[0]);
-    auto& q1    = get_physical_qubit(qubits[1]);
+    auto& q0    = _qubit_list.get_mutable(qubits[0]);
+    auto& q1    = _qubit_list.get_mutable(qubits[1]);
 
     if (op.get_operation() == SwapGate{}) {
         auto temp = q0.get_logical_qubit();
@@ -320,8 +309,8 @@ void Device::apply_gate(qcir::QCirGate const& op, size_t time_begin) {
  * @param op
  */
 void Device::apply_swap_check(QubitIdType qid0, QubitIdType qid1) {
-    auto& q0  = get_physical_qubit(qid0);
-    auto& q1  = get_physical_qubit(qid1);
+    auto& q0  = _qubit_list.get_mutable(qid0);
+    auto& q1  = _qubit_list.get_mutable(qid1);
     auto temp = q0.get_logical_qubit();
     q0.set_logical_qubit(q1.get_logical_qubit());
     q1.set_logical_qubit(temp);
@@ -336,9 +325,8 @@ void Device::apply_swap_check(QubitIdType qid0, QubitIdType qid1) {
  * @param physicalId
  */
 void Device::apply_single_qubit_gate(QubitIdType physical_id) {
-    auto const start_time = _qubit_list[physical_id].get_occupied_time();
-    _qubit_list[physical_id].set_occupied_time(start_time + SINGLE_DELAY);
-    _qubit_list[physical_id].reset();
+    auto& qubit = _qubit_list.get_mutable(physical_id);
+    qubit.set_occupied_time(qubit.get_occupied_time() + SINGLE_DELAY);
 }
 
 /**
@@ -349,8 +337,8 @@ void Device::apply_single_qubit_gate(QubitIdType physical_id) {
 std::vector<std::optional<size_t>> Device::mapping() const {
     std::vector<std::optional<size_t>> ret;
     ret.resize(_qubit_list.size());
-    for (auto const& [id, qubit] : tl::views::enumerate(_qubit_list)) {
-        ret[id] = qubit.get_logical_qubit();
+    for (size_t i = 0; i < _qubit_list.size(); ++i) {
+        ret[i] = _qubit_list[i].get_logical_qubit();
     }
     return ret;
 }
@@ -363,29 +351,18 @@ std::vector<std::optional<size_t>> Device::mapping() const {
 void Device::place(std::vector<QubitIdType> const& assignment) {
     for (size_t i = 0; i < assignment.size(); ++i) {
         assert(_qubit_list[assignment[i]].get_logical_qubit() == std::nullopt);
-        _qubit_list[assignment[i]].set_logical_qubit(i);
+        set_logical_qubit(assignment[i], i);
     }
 }
 
 /**
- * @brief Calculate Shortest Path
+ * @brief Calculate Shortest Path. Does nothing if the topology already has them, so that once computed,
+ *        the shortest paths are only read by the copies of the device sharing the topology, e.g., on different threads.
  *
  */
 void Device::calculate_path() {
-    _topology->clear_predecessor();
-    _topology->clear_distance();
-
-    std::vector<std::vector<QubitIdType>> adjacency_matrix;
-    adjacency_matrix.resize(get_num_qubits());
-
-    for (size_t i = 0; i < get_num_qubits(); i++) {
-        adjacency_matrix[i].resize(get_num_qubits(), default_max_dist);
-        for (size_t j = 0; j < get_num_qubits(); j++) {
-            if (i == j)
-                adjacency_matrix[i][j] = 0;
-        }
-    }
-    _topology->floyd_warshall(adjacency_matrix, _qubit_list);
+    if (_topology->has_shortest_paths()) return;
+    _topology->calculate_shortest_paths();
 }
 
 /**
@@ -397,26 +374,33 @@ void Device::calculate_path() {
  */
 std::vector<PhysicalQubit> Device::get_path(QubitIdType src, QubitIdType dest) const {
     std::vector<PhysicalQubit> path;
-    path.emplace_back(_qubit_list.at(src));
+    path.emplace_back(_qubit_list[src]);
     if (src == dest) return path;
     auto new_pred = _topology->get_predecessor(dest, src);
+    if (new_pred == max_qubit_id) return path;
     path.emplace_back(new_pred);
     while (true) {
         new_pred = _topology->get_predecessor(dest, new_pred);
         if (new_pred == max_qubit_id) break;
-        path.emplace_back(_qubit_list.at(new_pred));
+        path.emplace_back(_qubit_list[new_pred]);
     }
     return path;
 }
 
 /**
- * @brief Read Device
+ * @brief Read Device. If `use_cache` is set, the topology is loaded from the cache file when the cache matches
+ *        the contents of the layout; otherwise, the layout is parsed and, for large devices, a new cache is written.
  *
  * @param filename
+ * @param use_cache
+ * @param cache_dir the directory of the cache file; if not specified, the cache is next to the layout file
  * @return true
  * @return false
  */
-bool Device::read_device(std::string const& filename) {
+bool Device::read_device(std::string const& filename, bool use_cache, std::optional<std::filesystem::path> const& cache_dir) {
+    auto const layout_hash = use_cache ? _hash_layout_file(filename) : std::nullopt;
+    if (layout_hash.has_value() && _read_cache(filename, cache_dir, *layout_hash)) return true;
+
     std::ifstream topo_file(filename);
     if (!topo_file.is_open()) {
         spdlog::error("Cannot open the file \"{}\"!!", filename);
@@ -479,11 +463,7 @@ bool Device::read_device(std::string const& filename) {
     if (!_parse_info(topo_file, cx_err, cx_delay, sg_err, sg_delay)) return false;
 
     // NOTE - Finish parsing, store the topology
-    _qubit_list.reserve(adj_list.size());
-
-    for (size_t i = 0; i < adj_list.size(); ++i) {
-        _qubit_list.emplace_back(PhysicalQubit(i));
-    }
+    _reset_qubit_list(adj_list.size());
 
     for (size_t i = 0; i < adj_list.size(); i++) {
         for (size_t j = 0; j < adj_list[i].size(); j++) {
@@ -500,6 +480,9 @@ bool Device::read_device(std::string const& filename) {
     }
 
     calculate_path();
+    if (layout_hash.has_value() && _num_qubit >= cache_min_qubits) {
+        _write_cache(filename, cache_dir, *layout_hash);
+    }
     return true;
 }
 
@@ -673,20 +656,15 @@ void Device::print_qubits(std::vector<size_t> candidates) const {
         }
     }
     fmt::println("");
-    std::vector<PhysicalQubit> qubits;
-    qubits.resize(_num_qubit);
-    for (auto const& [idx, info] : tl::views::enumerate(_qubit_list)) {
-        qubits[idx] = info;
-    }
     if (candidates.empty()) {
-        for (size_t i = 0; i < qubits.size(); i++) {
-            fmt::println("ID: {:>3}    {}Adjs: {:>3}", i, _topology->get_qubit_info(i), fmt::join(qubits[i].get_adjacencies(), " "));
+        for (size_t i = 0; i < _num_qubit; i++) {
+            fmt::println("ID: {:>3}    {}Adjs: {:>3}", i, _topology->get_qubit_info(i), fmt::join(get_adjacencies(i), " "));
         }
         fmt::println("Total #Qubits: {}", _num_qubit);
     } else {
         sort(candidates.begin(), candidates.end());
         for (auto& p : candidates) {
-            fmt::println("ID: {:>3}    {}Adjs: {:>3}", p, _topology->get_qubit_info(p), fmt::join(qubits[p].get_adjacencies(), " "));
+            fmt::println("ID: {:>3}    {}Adjs: {:>3}", p, _topology->get_qubit_info(p), fmt::join(get_adjacencies(p), " "));
         }
     }
 }
@@ -704,15 +682,10 @@ void Device::print_edges(std::vector<size_t> candidates) const {
         }
     }
     fmt::println("");
-    std::vector<PhysicalQubit> qubits;
-    qubits.resize(_num_qubit);
-    for (auto const& [idx, info] : tl::views::enumerate(_qubit_list)) {
-        qubits[idx] = info;
-    }
     if (candidates.empty()) {
         size_t cnt = 0;
         for (size_t i = 0; i < _num_qubit; i++) {
-            for (auto& q : qubits[i].get_adjacencies()) {
+            for (auto& q : get_adjacencies(i)) {
                 if (std::cmp_less(i, q)) {
                     cnt++;
                     _topology->print_single_edge(i, q);
@@ -722,10 +695,10 @@ void Device::print_edges(std::vector<size_t> candidates) const {
         assert(cnt == _topology->get_num_adjacencies());
         fmt::println("Total #Edges: {}", cnt);
     } else if (candidates.size() == 1) {
-        for (auto& q : qubits[candidates[0]].get_adjacencies()) {
+        for (auto& q : get_adjacencies(candidates[0])) {
             _topology->print_single_edge(candidates[0], q);
         }
-        fmt::println("Total #Edges: {}", qubits[candidates[0]].get_adjacencies().size());
+        fmt::println("Total #Edges: {}", get_adjacencies(candidates[0]).size());
     } else if (candidates.size() == 2) {
         _topology->print_single_edge(candidates[0], candidates[1]);
     }
@@ -756,7 +729,7 @@ void Device::print_path(QubitIdType src, QubitIdType dest) const {
         }
     }
     std::vector<PhysicalQubit> const& path = get_path(src, dest);
-    if (path.front().get_id() != src && path.back().get_id() != dest)
+    if (path.back().get_id() != dest)
         fmt::println("No path between {} and {}", src, dest);
     else {
         fmt::println("Path from {} to {}:", src, dest);
@@ -786,13 +759,8 @@ void Device::print_mapping() {
  */
 void Device::print_status() const {
     fmt::println("Device Status:");
-    std::vector<PhysicalQubit> qubits;
-    qubits.resize(_num_qubit);
-    for (auto const& [idx, info] : tl::views::enumerate(_qubit_list)) {
-        qubits[idx] = info;
-    }
-    for (size_t i = 0; i < qubits.size(); ++i) {
-        fmt::println("{}", qubits[i]);
+    for (size_t i = 0; i < _num_qubit; ++i) {
+        fmt::println("{}", _qubit_list[i]);
     }
     fmt::println("");
 }
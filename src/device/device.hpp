@@ -10,11 +10,17 @@
 #include <fmt/core.h>
 
 #include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 
 #include "qsyn/qsyn_type.hpp"
+#include "util/delta_vector.hpp"
+#include "util/mapped_file.hpp"
 #include "util/util.hpp"
 
 namespace qsyn::qcir {
@@ -53,21 +59,30 @@ public:
     Topology() {}
 
     std::string get_name() const { return _name; }
+    size_t get_num_qubits() const { return _num_qubit; }
     auto get_gate_set() const { return _gate_set; }
     DeviceInfo const& get_adjacency_pair_info(size_t a, size_t b);
     DeviceInfo const& get_qubit_info(size_t a);
     size_t get_num_adjacencies() const { return _adjacency_info.size(); }
-    size_t get_predecessor(size_t dest, size_t src) { return _predecessor[dest][src]; }
-    void set_num_qubits(size_t n) { _num_qubit = n; }
+    std::vector<QubitIdType> const& get_adjacencies(size_t a) const { return _adjacencies[a]; }
+    size_t get_distance(size_t a, size_t b) const;
+    size_t get_predecessor(size_t dest, size_t src) const;
+    void set_num_qubits(size_t n) {
+        _num_qubit = n;
+        _adjacencies.resize(n);
+        _clear_shortest_paths();
+    }
     void set_name(std::string n) { _name = std::move(n); }
     void add_gate_type(std::string const& gt) { _gate_set.emplace_back(gt); }
+    void add_adjacency(size_t a, size_t b);
     void add_adjacency_info(size_t a, size_t b, DeviceInfo info);
     void add_qubit_info(size_t a, DeviceInfo info);
 
-    void clear_predecessor() { _predecessor.clear(); }
-    void clear_distance() { _distance.clear(); }
-    void resize_to_num_qubit();
-    void floyd_warshall(std::vector<std::vector<QubitIdType>>& adjacency_matrix, const std::vector<PhysicalQubit>& qubit_list);
+    void calculate_shortest_paths(size_t n_jobs = 0);
+    bool has_shortest_paths() const { return _distance_file != nullptr || !_distance.empty() || _num_qubit == 0; }
+
+    bool read_cache(std::filesystem::path const& path, std::uint64_t layout_hash);
+    bool write_cache(std::filesystem::path const& path, std::uint64_t layout_hash) const;
 
     void print_single_edge(size_t a, size_t b) const;
 
@@ -77,83 +92,74 @@ private:
     std::vector<std::string> _gate_set;
     PhysicalQubitInfo _qubit_info;
     AdjacencyMap _adjacency_info;
-
-    // NOTE - Containers and helper functions for Floyd-Warshall
-    size_t _max_dist = default_max_dist;
-    std::vector<std::vector<QubitIdType>> _predecessor;  // _predecessor[i][j] = predecessor of j in path from i to j
-    std::vector<std::vector<size_t>> _distance;          // _distance[i][j] = distance from i to j
-    void _set_weight(std::vector<std::vector<QubitIdType>>& adjacency_matrix, const std::vector<PhysicalQubit>& qubit_list) const;
-    void _init_predecessor_and_distance(const std::vector<std::vector<QubitIdType>>& adjacency_matrix, const std::vector<PhysicalQubit>& qubit_list);
+    std::vector<std::vector<QubitIdType>> _adjacencies;  // _adjacencies[i] = qubits coupled with i, in the order they are added
+
+    // NOTE - Containers for all pairs shortest paths
+    using Distance                        = std::uint16_t;
+    constexpr static Distance unreachable = std::numeric_limits<Distance>::max();
+    std::vector<Distance> _distance;  // _distance[i * _num_qubit + j] = number of hops from i to j
+    // if set, the distances are read in place from this cache file, starting at byte _distance_offset, and _distance is empty
+    std::shared_ptr<dvlab::utils::MappedFile const> _distance_file;
+    size_t _distance_offset = 0;
+    Distance const* _get_distances() const;
+    void _clear_shortest_paths();
+    void _breadth_first_search(size_t source);
+    static bool _distances_match_adjacencies(Distance const* distances, std::vector<std::vector<QubitIdType>> const& adjacencies);
 };
 
+/**
+ * @brief The state of a physical qubit during routing. The couplings are stored in the Topology shared by all copies of a Device,
+ *        so that a PhysicalQubit holds no heap memory. The scratch state of route searches is kept by the router instead.
+ *
+ */
 class PhysicalQubit {
 public:
-    using Adjacencies = std::vector<QubitIdType>;
     PhysicalQubit() {}
     PhysicalQubit(QubitIdType id) : _id(id) {}
 
     void set_id(QubitIdType id) { _id = id; }
     void set_occupied_time(size_t t) { _occupied_time = t; }
     void set_logical_qubit(std::optional<size_t> id) { _logical_qubit = id; }
-    void add_adjacency(size_t adj) { _adjacencies.emplace_back(adj); }
 
     auto get_id() const { return _id; }
     auto get_occupied_time() const { return _occupied_time; }
-    auto is_adjacency(PhysicalQubit const& pq) const { return dvlab::contains(_adjacencies, pq.get_id()); }
-    auto const& get_adjacencies() const { return _adjacencies; }
     auto get_logical_qubit() const { return _logical_qubit; }
 
-    // traversal
-    auto get_cost() const { return _cost; }
-    auto is_marked() const { return _marked; }
-    auto is_taken() const { return _taken; }
-    auto get_source() const { return _source; }
-    auto get_predecessor() const { return _pred; }
-    auto get_swap_time() const { return _swap_time; }
-
-    // NOTE - Duostra functions
-    void mark(bool source, QubitIdType pred);
-    void take_route(size_t cost, size_t swap_time);
-    void reset();
-
 private:
     // NOTE - Device information
     QubitIdType _id = max_qubit_id;
-    Adjacencies _adjacencies;
 
     // NOTE - Duostra parameter
     std::optional<QubitIdType> _logical_qubit = std::nullopt;
     size_t _occupied_time                     = 0;
-
-    bool _marked      = false;
-    QubitIdType _pred = 0;
-    size_t _cost      = 0;
-    size_t _swap_time = 0;
-    bool _source      = false;  // false:0, true:1
-    bool _taken       = false;
 };
 
 class Device {
 public:
-    using PhysicalQubitList                  = std::vector<PhysicalQubit>;
+    // the copies of a device, e.g., for each node of the Duostra search tree, only store the qubits changed since they are copied
+    using PhysicalQubitList                  = dvlab::utils::DeltaVector<PhysicalQubit>;
     constexpr static size_t default_max_dist = 100000;
+    constexpr static size_t cache_min_qubits = 1024;  // only devices with at least this many qubits are cached by read_device
     Device() : _topology{std::make_shared<Topology>()} {}
 
     std::string get_name() const { return _topology->get_name(); }
     size_t get_num_qubits() const { return _num_qubit; }
-    PhysicalQubitList const& get_physical_qubit_list() const { return _qubit_list; }
-    PhysicalQubit& get_physical_qubit(QubitIdType id) { return _qubit_list[id]; }
+    PhysicalQubit const& get_physical_qubit(QubitIdType id) const { return _qubit_list[id]; }
     QubitIdType get_physical_by_logical(QubitIdType id);
     std::tuple<QubitIdType, QubitIdType> get_next_swap_cost(QubitIdType source, QubitIdType target);
     bool qubit_id_exists(QubitIdType id) { return id < _qubit_list.size(); }
+    std::vector<QubitIdType> const& get_adjacencies(QubitIdType id) const { return _topology->get_adjacencies(id); }
+    bool is_adjacent(QubitIdType a, QubitIdType b) const { return dvlab::contains(get_adjacencies(a), b); }
+    size_t get_distance(QubitIdType a, QubitIdType b) const { return _topology->get_distance(a, b); }
 
-    void add_physical_qubit(PhysicalQubit q) { _qubit_list[q.get_id()] = std::move(q); }
     void add_adjacency(QubitIdType a, QubitIdType b);
 
     // NOTE - Duostra
     void apply_gate(qcir::QCirGate const& op, size_t time_begin);
     void apply_single_qubit_gate(QubitIdType physical_id);
     void apply_swap_check(QubitIdType qid0, QubitIdType qid1);
+    void set_logical_qubit(QubitIdType physical_id, std::optional<QubitIdType> logical_id) { _qubit_list.get_mutable(physical_id).set_logical_qubit(logical_id); }
+    void set_occupied_time(QubitIdType physical_id, size_t t) { _qubit_list.get_mutable(physical_id).set_occupied_time(t); }
     std::vector<std::optional<size_t>> mapping() const;
     void place(std::vector<QubitIdType> const& assignment);
 
@@ -161,7 +167,12 @@ public:
     void calculate_path();
     std::vector<PhysicalQubit> get_path(QubitIdType src, QubitIdType dest) const;
 
-    bool read_device(std::string const& filename);
+    bool read_device(std::string const& filename, bool use_cache = true, std::optional<std::filesystem::path> const& cache_dir = std::nullopt);
+
+    // NOTE - Synthetic devices, e.g., for benchmarking
+    static Device grid(size_t rows, size_t cols);
+    static Device heavy_hex(size_t rows, size_t cols);
+    static Device all_to_all(size_t num_qubits);
 
     void print_qubits(std::vector<size_t> candidates = {}) const;
     void print_edges(std::vector<size_t> candidates = {}) const;
@@ -177,11 +188,17 @@ private:
     std::shared_ptr<Topology> _topology;
     PhysicalQubitList _qubit_list;
 
+    void _init_qubits(std::string name, size_t num_qubits);
+    void _reset_qubit_list(size_t num_qubits);
+
     // NOTE - Internal functions only used in reader
     bool _parse_gate_set(std::string const& gate_set_str);
     bool _parse_singles(std::string const& data, std::vector<float>& container);
     bool _parse_float_pairs(std::string const& data, std::vector<std::vector<float>>& containers);
     bool _parse_size_t_pairs(std::string const& data, std::vector<std::vector<size_t>>& containers);
+    static std::optional<std::uint64_t> _hash_layout_file(std::string const& filename);
+    bool _read_cache(std::string const& filename, std::optional<std::filesystem::path> const& cache_dir, std::uint64_t layout_hash);
+    void _write_cache(std::string const& filename, std::optional<std::filesystem::path> const& cache_dir, std::uint64_t layout_hash) const;
     bool _parse_info(std::ifstream& f, std::vector<std::vector<float>>& cx_error, std::vector<std::vector<float>>& cx_delay, std::vector<float>& single_error, std::vector<float>& single_delay);
 };
 
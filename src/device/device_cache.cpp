@@ -0,0 +1,336 @@
+/****************************************************************************
+  PackageName  [ device ]
+  Synopsis     [ Define the binary cache of preprocessed device topologies ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <fmt/ranges.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <ranges>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "device/device.hpp"
+#include "util/dvlab_string.hpp"
+
+// NOTE - The cache is a header followed by the sections below, each starting at a multiple of 8 bytes:
+//        name | gate set | adjacency offsets | adjacency targets | edge infos | qubit infos | distances
+//        The adjacency lists are stored in CSR form: the neighbors of qubit i are targets[offsets[i], offsets[i + 1]).
+//        All numbers are in the native byte order; a cache written on another platform is rejected by the header check.
+
+namespace qsyn::device {
+
+namespace {
+
+constexpr std::array<char, 8> cache_magic   = {'Q', 'S', 'Y', 'N', 'T', 'O', 'P', 'O'};
+constexpr std::uint32_t cache_version       = 1;
+constexpr std::uint64_t fnv_offset_basis    = 14695981039346656037ULL;
+constexpr std::uint64_t fnv_prime           = 1099511628211ULL;
+constexpr size_t cache_alignment            = 8;
+constexpr std::array<char, 8> cache_padding = {};
+
+struct CacheHeader {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t distance_size;  // sizeof(Topology::Distance)
+    std::uint64_t layout_hash;
+    std::uint64_t num_qubits;
+    std::uint64_t num_adjacencies;  // total length of the adjacency lists, i.e., twice the number of couplings
+    std::uint64_t num_edge_infos;
+    std::uint64_t num_qubit_infos;
+    std::uint64_t name_size;
+    std::uint64_t gate_set_size;
+};
+
+struct EdgeInfoRecord {
+    std::uint32_t a;
+    std::uint32_t b;
+    DeviceInfo info;
+};
+
+struct QubitInfoRecord {
+    std::uint64_t id;
+    DeviceInfo info;
+};
+
+struct CacheSections {
+    size_t name;
+    size_t gate_set;
+    size_t offsets;
+    size_t targets;
+    size_t edge_infos;
+    size_t qubit_infos;
+    size_t distances;
+    size_t end;
+};
+
+constexpr size_t align(size_t n_bytes) {
+    return (n_bytes + cache_alignment - 1) / cache_alignment * cache_alignment;
+}
+
+CacheSections get_cache_sections(CacheHeader const& header) {
+    auto pos  = align(sizeof(CacheHeader));
+    auto next = [&pos](size_t n_bytes) { return std::exchange(pos, pos + align(n_bytes)); };
+
+    auto sections        = CacheSections{};
+    sections.name        = next(header.name_size);
+    sections.gate_set    = next(header.gate_set_size);
+    sections.offsets     = next((header.num_qubits + 1) * sizeof(std::uint64_t));
+    sections.targets     = next(header.num_adjacencies * sizeof(std::uint32_t));
+    sections.edge_infos  = next(header.num_edge_infos * sizeof(EdgeInfoRecord));
+    sections.qubit_infos = next(header.num_qubit_infos * sizeof(QubitInfoRecord));
+    sections.distances   = next(header.num_qubits * header.num_qubits * header.distance_size);
+    sections.end         = pos;
+    return sections;
+}
+
+template <typename T>
+std::vector<T> read_section(std::span<std::byte const> bytes, size_t offset, size_t count) {
+    auto result = std::vector<T>(count);
+    std::memcpy(result.data(), bytes.data() + offset, count * sizeof(T));
+    return result;
+}
+
+std::filesystem::path get_cache_path(std::string const& filename, std::optional<std::filesystem::path> const& cache_dir) {
+    auto cache_name = std::filesystem::path{filename + ".cache"};
+    return cache_dir.has_value() ? *cache_dir / cache_name.filename() : cache_name;
+}
+
+}  // namespace
+
+/**
+ * @brief Load the topology, including the shortest paths, from a cache written by write_cache.
+ *        The distance table is not copied but read in place from the memory-mapped file.
+ *        The topology is left untouched if the cache is missing, corrupted, or made from a different layout.
+ *
+ * @param path
+ * @param layout_hash the hash of the layout file the cache should be made from
+ * @return true if the topology is loaded
+ */
+bool Topology::read_cache(std::filesystem::path const& path, std::uint64_t layout_hash) {
+    auto file = std::make_shared<dvlab::utils::MappedFile const>(path);
+    if (!file->is_open()) return false;
+    auto const bytes = file->data();
+
+    auto header = CacheHeader{};
+    if (bytes.size() < sizeof(CacheHeader)) return false;
+    std::memcpy(&header, bytes.data(), sizeof(CacheHeader));
+    if (header.magic != cache_magic || header.version != cache_version || header.distance_size != sizeof(Distance) ||
+        header.layout_hash != layout_hash || header.num_qubits >= unreachable) {
+        return false;
+    }
+    // bounds the counts so that computing the section sizes cannot overflow
+    if (std::ranges::any_of(std::array{header.num_adjacencies, header.num_edge_infos, header.num_qubit_infos, header.name_size, header.gate_set_size},
+                            [&](std::uint64_t count) { return count > bytes.size(); })) {
+        return false;
+    }
+    auto const sections = get_cache_sections(header);
+    if (sections.end != bytes.size()) return false;
+
+    auto const n_qubits = static_cast<size_t>(header.num_qubits);
+    auto const offsets  = read_section<std::uint64_t>(bytes, sections.offsets, n_qubits + 1);
+    auto const targets  = read_section<std::uint32_t>(bytes, sections.targets, header.num_adjacencies);
+    auto const edges    = read_section<EdgeInfoRecord>(bytes, sections.edge_infos, header.num_edge_infos);
+    auto const qubits   = read_section<QubitInfoRecord>(bytes, sections.qubit_infos, header.num_qubit_infos);
+    if (offsets.front() != 0 || offsets.back() != targets.size() || !std::ranges::is_sorted(offsets) ||
+        std::ranges::any_of(targets, [&](std::uint32_t q) { return q >= n_qubits; }) ||
+        std::ranges::any_of(edges, [&](EdgeInfoRecord const& e) { return e.a >= n_qubits || e.b >= n_qubits; })) {
+        return false;
+    }
+
+    auto adjacencies = std::vector<std::vector<QubitIdType>>(n_qubits);
+    for (size_t i = 0; i < n_qubits; ++i) {
+        adjacencies[i].assign(targets.begin() + static_cast<std::ptrdiff_t>(offsets[i]), targets.begin() + static_cast<std::ptrdiff_t>(offsets[i + 1]));
+    }
+    auto const* distances = reinterpret_cast<Distance const*>(bytes.data() + sections.distances);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast) : the cache aligns the distances
+    if (!_distances_match_adjacencies(distances, adjacencies)) return false;
+
+    auto const read_string = [&](size_t offset, size_t size) { return std::string{reinterpret_cast<char const*>(bytes.data() + offset), size}; };  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast) : reading characters from raw bytes
+    auto const gate_set    = read_string(sections.gate_set, header.gate_set_size);
+    _name                  = read_string(sections.name, header.name_size);
+    _gate_set.clear();
+    for (auto const& gate_type : dvlab::str::views::tokenize(gate_set, '\n')) {
+        _gate_set.emplace_back(gate_type);
+    }
+
+    _num_qubit   = n_qubits;
+    _adjacencies = std::move(adjacencies);
+    _adjacency_info.clear();
+    for (auto const& [a, b, info] : edges) {
+        _adjacency_info[std::make_pair(a, b)] = info;
+    }
+    _qubit_info.clear();
+    for (auto const& [id, info] : qubits) {
+        _qubit_info[id] = info;
+    }
+
+    _distance.clear();
+    _distance_file   = std::move(file);
+    _distance_offset = sections.distances;
+    return true;
+}
+
+/**
+ * @brief Check that a distance table is consistent with the couplings: every qubit is 0 hops from itself, exactly its neighbors
+ *        are 1 hop away, and no distance reaches the number of qubits unless it marks an unreachable pair.
+ *        This catches most corrupted caches in one pass over the table, which is much cheaper than recomputing the shortest paths.
+ *
+ * @param distances the row-major n x n distance table
+ * @param adjacencies the neighbors of each qubit
+ * @return true if the table is consistent
+ */
+bool Topology::_distances_match_adjacencies(Distance const* distances, std::vector<std::vector<QubitIdType>> const& adjacencies) {
+    auto const n_qubits = adjacencies.size();
+    for (size_t i = 0; i < n_qubits; ++i) {
+        auto const row = std::span{distances + i * n_qubits, n_qubits};
+        auto neighbors = adjacencies[i];
+        std::ranges::sort(neighbors);
+        neighbors.erase(std::ranges::unique(neighbors).begin(), neighbors.end());
+        if (row[i] != 0 ||
+            std::ranges::count(row, Distance{1}) != std::ssize(neighbors) ||
+            std::ranges::any_of(neighbors, [&](QubitIdType q) { return row[q] != 1; }) ||
+            std::ranges::any_of(row, [&](Distance d) { return d >= n_qubits && d != unreachable; })) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Write the topology, including the shortest paths, to a cache file. The file is written under a temporary name
+ *        and then renamed, so that other processes never read a partially written cache.
+ *
+ * @param path
+ * @param layout_hash the hash of the layout file the topology is read from
+ * @return true if the cache is written
+ */
+bool Topology::write_cache(std::filesystem::path const& path, std::uint64_t layout_hash) const {
+    if (!has_shortest_paths() || _num_qubit >= unreachable) return false;
+
+    std::vector<std::uint64_t> offsets{0};
+    std::vector<std::uint32_t> targets;
+    for (auto const& adjacencies : _adjacencies) {
+        targets.insert(targets.end(), adjacencies.begin(), adjacencies.end());
+        offsets.emplace_back(targets.size());
+    }
+    auto edges = std::vector<EdgeInfoRecord>{};
+    for (auto const& [pair, info] : _adjacency_info) {
+        edges.push_back({static_cast<std::uint32_t>(pair.first), static_cast<std::uint32_t>(pair.second), info});
+    }
+    std::ranges::sort(edges, {}, [](EdgeInfoRecord const& e) { return std::make_pair(e.a, e.b); });
+    auto qubits = std::vector<QubitInfoRecord>{};
+    for (auto const& [id, info] : _qubit_info) {
+        qubits.push_back({id, info});
+    }
+    std::ranges::sort(qubits, {}, &QubitInfoRecord::id);
+    auto const gate_set = fmt::format("{}", fmt::join(_gate_set, "\n"));
+
+    auto const header = CacheHeader{
+        .magic           = cache_magic,
+        .version         = cache_version,
+        .distance_size   = sizeof(Distance),
+        .layout_hash     = layout_hash,
+        .num_qubits      = _num_qubit,
+        .num_adjacencies = targets.size(),
+        .num_edge_infos  = edges.size(),
+        .num_qubit_infos = qubits.size(),
+        .name_size       = _name.size(),
+        .gate_set_size   = gate_set.size(),
+    };
+
+    auto tmp_path = path;
+    tmp_path += fmt::format(".tmp{}", std::random_device{}());
+    {
+        std::ofstream out(tmp_path, std::ios::binary);
+        auto const write_section = [&out](void const* data, size_t n_bytes) {
+            out.write(static_cast<char const*>(data), static_cast<std::streamsize>(n_bytes));
+            out.write(cache_padding.data(), static_cast<std::streamsize>(align(n_bytes) - n_bytes));
+        };
+        write_section(&header, sizeof(CacheHeader));
+        write_section(_name.data(), _name.size());
+        write_section(gate_set.data(), gate_set.size());
+        write_section(offsets.data(), offsets.size() * sizeof(std::uint64_t));
+        write_section(targets.data(), targets.size() * sizeof(std::uint32_t));
+        write_section(edges.data(), edges.size() * sizeof(EdgeInfoRecord));
+        write_section(qubits.data(), qubits.size() * sizeof(QubitInfoRecord));
+        write_section(_get_distances(), _num_qubit * _num_qubit * sizeof(Distance));
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tmp_path);
+            return false;
+        }
+    }
+
+    auto ec = std::error_code{};
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Hash the contents of a layout file with 64-bit FNV-1a
+ *
+ * @param filename
+ * @return std::optional<std::uint64_t> std::nullopt if the file cannot be read
+ */
+std::optional<std::uint64_t> Device::_hash_layout_file(std::string const& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return std::nullopt;
+
+    auto hash   = fnv_offset_basis;
+    auto buffer = std::array<char, 1 << 16>{};
+    while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0) {
+        for (auto const c : std::span{buffer.data(), static_cast<size_t>(file.gcount())}) {
+            hash = (hash ^ static_cast<std::uint8_t>(c)) * fnv_prime;
+        }
+    }
+    return hash;
+}
+
+/**
+ * @brief Load the device from the cache of the layout file `filename`
+ *
+ * @param cache_dir the directory of the cache; if not specified, the cache is next to the layout file
+ * @return true if the cache exists and matches the layout
+ */
+bool Device::_read_cache(std::string const& filename, std::optional<std::filesystem::path> const& cache_dir, std::uint64_t layout_hash) {
+    auto const cache_path = get_cache_path(filename, cache_dir);
+    if (!_topology->read_cache(cache_path, layout_hash)) return false;
+
+    _num_qubit = _topology->get_num_qubits();
+    _reset_qubit_list(_num_qubit);
+    spdlog::debug("Loaded the topology of \"{}\" from the cache \"{}\"", filename, cache_path.string());
+    return true;
+}
+
+/**
+ * @brief Write the cache of the layout file `filename`. Failing to write the cache is not an error.
+ *
+ * @param cache_dir the directory of the cache, created if missing; if not specified, the cache is written next to the layout file
+ */
+void Device::_write_cache(std::string const& filename, std::optional<std::filesystem::path> const& cache_dir, std::uint64_t layout_hash) const {
+    auto const cache_path = get_cache_path(filename, cache_dir);
+    if (cache_dir.has_value()) {
+        auto ec = std::error_code{};
+        std::filesystem::create_directories(*cache_dir, ec);
+    }
+    if (!_topology->write_cache(cache_path, layout_hash)) {
+        spdlog::warn("Cannot write the topology cache \"{}\"", cache_path.string());
+        return;
+    }
+    spdlog::debug("Saved the topology of \"{}\" to the cache \"{}\"", filename, cache_path.string());
+}
+
+}  // namespace qsyn::device
@@ -9,7 +9,9 @@
 
 #include <spdlog/spdlog.h>
 
+#include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "device/device.hpp"
@@ -82,13 +84,23 @@ dvlab::Command device_read_cmd(qsyn::device::DeviceMgr& device_mgr) {
                 parser.add_argument<bool>("-r", "--replace")
                     .action(store_true)
                     .help("if specified, replace the current device; otherwise store to a new one");
+
+                parser.add_argument<bool>("--no-cache")
+                    .action(store_true)
+                    .help("if specified, neither read nor write the topology cache");
+
+                parser.add_argument<std::string>("--cache-dir")
+                    .help("if specified, read and write the topology cache in this directory instead of next to the device file");
             },
             [&device_mgr](ArgumentParser const& parser) {
                 qsyn::device::Device buffer_device;
                 auto filepath = parser.get<std::string>("filepath");
                 auto replace  = parser.get<bool>("--replace");
 
-                if (!buffer_device.read_device(filepath)) {
+                auto const cache_dir = parser.parsed("--cache-dir")
+                                           ? std::make_optional<std::filesystem::path>(parser.get<std::string>("--cache-dir"))
+                                           : std::nullopt;
+                if (!buffer_device.read_device(filepath, !parser.get<bool>("--no-cache"), cache_dir)) {
                     spdlog::error("the format in \"{}\" has something wrong!!", filepath);
                     return CmdExecResult::error;
                 }
@@ -103,6 +115,77 @@ dvlab::Command device_read_cmd(qsyn::device::DeviceMgr& device_mgr) {
             }};
 }
 
+dvlab::Command device_generate_cmd(qsyn::device::DeviceMgr& device_mgr) {
+    return {"generate",
+            [](ArgumentParser& parser) {
+                parser.description("generate a synthetic device topology");
+
+                parser.add_argument<bool>("-r", "--replace")
+                    .action(store_true)
+                    .help("if specified, replace the current device; otherwise store to a new one");
+
+                auto subparsers = parser.add_subparsers("shape").required(true);
+
+                auto grid_parser = subparsers.add_parser("grid")
+                                       .description("generate a grid, where each qubit is coupled with its horizontal and vertical neighbors");
+                auto heavy_hex_parser = subparsers.add_parser("heavy-hex")
+                                            .description("generate a heavy-hex lattice in the layout of IBM devices");
+                auto all_to_all_parser = subparsers.add_parser("all-to-all")
+                                             .description("generate a device where every pair of qubits is coupled");
+
+                grid_parser.add_argument<size_t>("rows")
+                    .help("the number of rows");
+                grid_parser.add_argument<size_t>("cols")
+                    .nargs(NArgsOption::optional)
+                    .help("the number of columns. If not specified, generate a square grid");
+
+                heavy_hex_parser.add_argument<size_t>("rows")
+                    .help("the number of chains of qubits");
+                heavy_hex_parser.add_argument<size_t>("cols")
+                    .help("the number of qubits in each chain. Should be at least 3");
+
+                all_to_all_parser.add_argument<size_t>("num-qubits")
+                    .help("the number of qubits");
+            },
+            [&device_mgr](ArgumentParser const& parser) {
+                auto const shape = parser.get<std::string>("shape");
+
+                auto buffer_device = qsyn::device::Device{};
+                if (shape == "grid") {
+                    auto const rows = parser.get<size_t>("rows");
+                    auto const cols = parser.parsed("cols") ? parser.get<size_t>("cols") : rows;
+                    if (rows == 0 || cols == 0) {
+                        spdlog::error("The grid should have at least one row and one column!!");
+                        return CmdExecResult::error;
+                    }
+                    buffer_device = qsyn::device::Device::grid(rows, cols);
+                } else if (shape == "heavy-hex") {
+                    auto const rows = parser.get<size_t>("rows");
+                    auto const cols = parser.get<size_t>("cols");
+                    if (rows == 0 || cols < 3) {
+                        spdlog::error("The heavy-hex lattice should have at least one chain of at least 3 qubits!!");
+                        return CmdExecResult::error;
+                    }
+                    buffer_device = qsyn::device::Device::heavy_hex(rows, cols);
+                } else {
+                    auto const num_qubits = parser.get<size_t>("num-qubits");
+                    if (num_qubits == 0) {
+                        spdlog::error("The device should have at least one qubit!!");
+                        return CmdExecResult::error;
+                    }
+                    buffer_device = qsyn::device::Device::all_to_all(num_qubits);
+                }
+
+                if (device_mgr.empty() || !parser.get<bool>("--replace")) {
+                    device_mgr.add(device_mgr.get_next_id(), std::make_unique<qsyn::device::Device>(std::move(buffer_device)));
+                } else {
+                    device_mgr.set(std::make_unique<qsyn::device::Device>(std::move(buffer_device)));
+                }
+
+                return CmdExecResult::done;
+            }};
+}
+
 dvlab::Command device_list_cmd(qsyn::device::DeviceMgr& device_mgr) {
     return {"list",
             [](ArgumentParser& parser) {
@@ -172,6 +255,7 @@ dvlab::Command device_cmd(qsyn::device::DeviceMgr& device_mgr) {
     cmd.add_subcommand("device-cmd-group", device_print_cmd(device_mgr));
     cmd.add_subcommand("device-cmd-group", device_checkout_cmd(device_mgr));
     cmd.add_subcommand("device-cmd-group", device_read_cmd(device_mgr));
+    cmd.add_subcommand("device-cmd-group", device_generate_cmd(device_mgr));
     cmd.add_subcommand("device-cmd-group", dvlab::utils::mgr_delete_cmd(device_mgr));
     return cmd;
 }
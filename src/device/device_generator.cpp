@@ -0,0 +1,114 @@
+/****************************************************************************
+  PackageName  [ device ]
+  Synopsis     [ Define the generators of synthetic device topologies ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <fmt/core.h>
+
+#include <cassert>
+#include <string>
+#include <utility>
+
+#include "device/device.hpp"
+
+namespace qsyn::device {
+
+/**
+ * @brief Name the device and create its physical qubits, with no coupling. The single-qubit gates take no time and have no error.
+ *
+ * @param name
+ * @param num_qubits
+ */
+void Device::_init_qubits(std::string name, size_t num_qubits) {
+    _topology->set_name(std::move(name));
+    for (auto const& gate_type : {"x", "rz", "h", "id", "sx", "cx"}) {
+        _topology->add_gate_type(gate_type);
+    }
+    _num_qubit = num_qubits;
+    _topology->set_num_qubits(num_qubits);
+    _reset_qubit_list(num_qubits);
+    for (size_t i = 0; i < num_qubits; ++i) {
+        _topology->add_qubit_info(i, {._time = 0.0, ._error = 0.0});
+    }
+}
+
+/**
+ * @brief Generate a rows x cols grid. Qubit r * cols + c is coupled with its horizontal and vertical neighbors.
+ *
+ * @param rows
+ * @param cols
+ * @return Device
+ */
+Device Device::grid(size_t rows, size_t cols) {
+    Device device;
+    device._init_qubits(fmt::format("grid_{}x{}", rows, cols), rows * cols);
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t c = 0; c < cols; ++c) {
+            auto const qubit = r * cols + c;
+            if (c + 1 < cols) device.add_adjacency(qubit, qubit + 1);
+            if (r + 1 < rows) device.add_adjacency(qubit, qubit + cols);
+        }
+    }
+    return device;
+}
+
+/**
+ * @brief Generate a heavy-hex lattice in the layout of IBM devices: `rows` chains of `cols` qubits,
+ *        where consecutive chains are joined by bridge qubits at every 4th column, alternately starting from columns 0 and 2.
+ *        The qubits are numbered chain by chain, each chain followed by the bridges below it.
+ *        `cols` should be at least 3 for the lattice to be connected.
+ *
+ * @param rows
+ * @param cols
+ * @return Device
+ */
+Device Device::heavy_hex(size_t rows, size_t cols) {
+    assert(rows == 1 || cols >= 3);
+    auto const bridge_offset = [](size_t gap) -> size_t { return gap % 2 == 0 ? 0 : 2; };
+    auto const num_bridges   = [&](size_t gap) -> size_t { return bridge_offset(gap) < cols ? (cols - bridge_offset(gap) + 3) / 4 : 0; };
+
+    size_t num_qubits = rows * cols;
+    for (size_t gap = 0; gap + 1 < rows; ++gap) {
+        num_qubits += num_bridges(gap);
+    }
+
+    Device device;
+    device._init_qubits(fmt::format("heavy_hex_{}", num_qubits), num_qubits);
+    size_t row_start = 0;
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t c = 0; c + 1 < cols; ++c) {
+            device.add_adjacency(row_start + c, row_start + c + 1);
+        }
+        if (r + 1 == rows) break;
+
+        auto bridge               = row_start + cols;
+        auto const next_row_start = bridge + num_bridges(r);
+        for (auto c = bridge_offset(r); c < cols; c += 4, ++bridge) {
+            device.add_adjacency(row_start + c, bridge);
+            device.add_adjacency(bridge, next_row_start + c);
+        }
+        row_start = next_row_start;
+    }
+    return device;
+}
+
+/**
+ * @brief Generate a device where every pair of qubits is coupled
+ *
+ * @param num_qubits
+ * @return Device
+ */
+Device Device::all_to_all(size_t num_qubits) {
+    Device device;
+    device._init_qubits(fmt::format("all_to_all_{}", num_qubits), num_qubits);
+    for (size_t i = 0; i < num_qubits; ++i) {
+        for (size_t j = i + 1; j < num_qubits; ++j) {
+            device.add_adjacency(i, j);
+        }
+    }
+    return device;
+}
+
+}  // namespace qsyn::device
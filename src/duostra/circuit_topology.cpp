@@ -10,21 +10,30 @@
 
 #include <fmt/ranges.h>
 
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <optional>
 #include <ranges>
 
 using namespace qsyn::qcir;
 
 namespace qsyn::duostra {
 
+/**
+ * @brief Check if all the predecessors of the gate are executed, i.e., the gate is the first unexecuted gate on each of its qubits
+ *
+ * @param gate_idx
+ * @return true if the gate is ready to execute
+ */
 bool CircuitTopology::_is_available(size_t gate_idx) const {
-    auto const preds = _dependency_graph->get_predecessors(gate_idx);  // circumvents g++ 11.4 compiler bug
-    return std::ranges::all_of(
-        preds |
-            std::views::filter([](std::optional<size_t> const& id) { return id.has_value(); }) |
-            std::views::transform([&](std::optional<size_t> const& id) { return id.value(); }),
-        [&](size_t prev) -> bool {
-            return _executed_gates.contains(prev);
-        });
+    auto const& seq = *_sequences;
+    for (auto i = seq.gate_offsets[gate_idx]; i < seq.gate_offsets[gate_idx + 1]; ++i) {
+        auto const qubit  = seq.gate_qubits[i];
+        auto const cursor = _wire_cursors[qubit];
+        if (cursor == seq.wire_offsets[qubit + 1] || seq.wire_gates[cursor] != gate_idx) return false;
+    }
+    return true;
 }
 
 // SECTION - Class CircuitTopo Member Functions
@@ -34,9 +43,46 @@ bool CircuitTopology::_is_available(size_t gate_idx) const {
  *
  * @param dep
  */
-CircuitTopology::CircuitTopology(std::shared_ptr<qcir::QCir> const& dep) : _dependency_graph(dep), _available_gates({}), _executed_gates({}) {
-    for (size_t i = 0; i < _dependency_graph->get_gates().size(); i++) {
-        if (_is_available(_dependency_graph->get_gate(i)->get_id()))
+CircuitTopology::CircuitTopology(std::shared_ptr<qcir::QCir> const& dep) : _dependency_graph(dep) {
+    auto const& gates   = _dependency_graph->get_gates();  // topologically ordered
+    auto const n_qubits = _dependency_graph->get_num_qubits();
+    auto const n_ids    = gates.empty() ? 0 : std::ranges::max(gates | std::views::transform([](QCirGate const* g) { return g->get_id(); })) + 1;
+
+    auto seq = std::make_shared<GateSequences>();
+    seq->gate_offsets.assign(n_ids + 1, 0);
+    seq->wire_offsets.assign(n_qubits + 1, 0);
+    for (auto const* gate : gates) {
+        seq->gate_offsets[gate->get_id() + 1] = gate->get_num_qubits();
+        for (auto const qubit : gate->get_qubits()) {
+            ++seq->wire_offsets[qubit + 1];
+        }
+    }
+    std::partial_sum(seq->gate_offsets.begin(), seq->gate_offsets.end(), seq->gate_offsets.begin());
+    std::partial_sum(seq->wire_offsets.begin(), seq->wire_offsets.end(), seq->wire_offsets.begin());
+
+    seq->gate_qubits.resize(seq->gate_offsets.back());
+    seq->wire_gates.resize(seq->wire_offsets.back());
+    _wire_cursors.assign(seq->wire_offsets.begin(), seq->wire_offsets.end() - 1);
+    for (auto const* gate : gates) {
+        std::ranges::copy(gate->get_qubits(), seq->gate_qubits.begin() + static_cast<std::ptrdiff_t>(seq->gate_offsets[gate->get_id()]));
+        for (auto const qubit : gate->get_qubits()) {
+            seq->wire_gates[_wire_cursors[qubit]++] = gate->get_id();
+        }
+    }
+    _sequences = std::move(seq);
+    _reset_available_gates();
+}
+
+/**
+ * @brief Mark all gates as unexecuted and collect the gates that are available from the start
+ *
+ */
+void CircuitTopology::_reset_available_gates() {
+    auto const& seq = *_sequences;
+    _wire_cursors.assign(seq.wire_offsets.begin(), seq.wire_offsets.end() - 1);
+    _available_gates.clear();
+    for (size_t i = 0; i + 1 < seq.gate_offsets.size(); i++) {
+        if (_dependency_graph->get_gate(i) != nullptr && _is_available(i))
             _available_gates.emplace_back(i);
     }
 }
@@ -51,33 +97,72 @@ std::unique_ptr<CircuitTopology> CircuitTopology::clone() const {
 }
 
 /**
- * @brief Update available gates by the executed gate
+ * @brief Get the topology of the circuit executed backwards, with no gate executed. The gate ids are unchanged.
+ *
+ * @return CircuitTopology
+ */
+CircuitTopology CircuitTopology::reversed() const {
+    auto seq = std::make_shared<GateSequences>(*_sequences);
+    for (size_t q = 0; q + 1 < seq->wire_offsets.size(); ++q) {
+        std::reverse(seq->wire_gates.begin() + static_cast<std::ptrdiff_t>(seq->wire_offsets[q]),
+                     seq->wire_gates.begin() + static_cast<std::ptrdiff_t>(seq->wire_offsets[q + 1]));
+    }
+
+    auto result       = *this;
+    result._sequences = std::move(seq);
+    result._reset_available_gates();
+    return result;
+}
+
+/**
+ * @brief Get the qubits of a gate, in the order of its pins
+ *
+ * @param gate_idx
+ * @return std::span<QubitIdType const>
+ */
+std::span<QubitIdType const> CircuitTopology::get_gate_qubits(size_t gate_idx) const {
+    auto const& seq = *_sequences;
+    return {seq.gate_qubits.data() + seq.gate_offsets[gate_idx], seq.gate_qubits.data() + seq.gate_offsets[gate_idx + 1]};
+}
+
+/**
+ * @brief Get the unexecuted gates on a qubit in execution order. If the qubit is not idle, the first one is the next gate to execute on it.
+ *
+ * @param qubit
+ * @return std::span<size_t const>
+ */
+std::span<size_t const> CircuitTopology::get_pending_gates(QubitIdType qubit) const {
+    auto const& seq = *_sequences;
+    return {seq.wire_gates.data() + _wire_cursors[qubit], seq.wire_gates.data() + seq.wire_offsets[qubit + 1]};
+}
+
+/**
+ * @brief Update available gates by the executed gate. The successors that become available are appended in the order of the executed gate's qubits.
  *
  * @param executed
  */
 void CircuitTopology::update_available_gates(size_t executed) {
-    auto const& gate_executed = get_gate(executed);
-    _available_gates.erase(remove(begin(_available_gates), end(_available_gates), executed), end(_available_gates));
-    assert(gate_executed.get_id() == executed);
-
-    _executed_gates[executed] = 0;
-    for (auto next : _dependency_graph->get_successors(executed)) {
-        if (!next) continue;
-        if (_is_available(_dependency_graph->get_gate(*next)->get_id()))
-            _available_gates.emplace_back(*next);
-    }
+    assert(_is_available(executed));
+    _available_gates.erase(std::ranges::find(_available_gates, executed));
 
-    std::vector<size_t> gates_to_trim;
-    for (auto prev_id : _dependency_graph->get_predecessors(executed)) {
-        if (!prev_id) continue;
-        ++_executed_gates[*prev_id];
-        auto tmp                  = _dependency_graph->get_successors(prev_id);  // circumvents g++ 11.4 compiler bug
-        auto prev_gate_successors = tmp | std::views::filter([](std::optional<size_t> const& id) { return id.has_value(); }) | tl::to<std::vector>();
-        if (_executed_gates[*prev_id] >= prev_gate_successors.size())
-            gates_to_trim.emplace_back(*prev_id);
+    auto const& seq         = *_sequences;
+    auto const qubits_begin = seq.gate_qubits.begin() + static_cast<std::ptrdiff_t>(seq.gate_offsets[executed]);
+    auto const qubits_end   = seq.gate_qubits.begin() + static_cast<std::ptrdiff_t>(seq.gate_offsets[executed + 1]);
+    for (auto it = qubits_begin; it != qubits_end; ++it) {
+        ++_wire_cursors[*it];
+    }
+    auto const next_gate = [&](QubitIdType qubit) -> std::optional<size_t> {
+        auto const cursor = _wire_cursors[qubit];
+        return cursor == seq.wire_offsets[qubit + 1] ? std::nullopt : std::make_optional(seq.wire_gates[cursor]);
+    };
+    for (auto it = qubits_begin; it != qubits_end; ++it) {
+        auto const next = next_gate(*it);
+        if (!next.has_value()) continue;
+        // a successor on several qubits of the executed gate is appended only once
+        auto const seen = std::any_of(qubits_begin, it, [&](QubitIdType qubit) { return next_gate(qubit) == next; });
+        if (!seen && _is_available(*next))
+            _available_gates.emplace_back(*next);
     }
-    for (auto gate_id : gates_to_trim)
-        _executed_gates.erase(gate_id);
 }
 
 }  // namespace qsyn::duostra
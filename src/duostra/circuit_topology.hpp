@@ -8,7 +8,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include <span>
 #include <vector>
 
 #include "qcir/qcir.hpp"
@@ -16,25 +18,42 @@
 
 namespace qsyn::duostra {
 
+/**
+ * @brief The gates of the dependency graph that are ready to execute. The graph is flattened once into per-qubit gate sequences,
+ *        which all clones share; a clone only copies one cursor per qubit and the ready gates.
+ *
+ */
 class CircuitTopology {
 public:
     CircuitTopology(std::shared_ptr<qcir::QCir> const& dep);
 
     std::unique_ptr<CircuitTopology> clone() const;
+    CircuitTopology reversed() const;
 
     void update_available_gates(size_t executed);
     size_t get_num_qubits() const { return _dependency_graph->get_num_qubits(); }
     size_t get_num_gates() const { return _dependency_graph->get_num_gates(); }
     qcir::QCirGate const& get_gate(size_t i) const { return *_dependency_graph->get_gate(i); }
     std::vector<size_t> const& get_available_gates() const { return _available_gates; }
+    std::span<QubitIdType const> get_gate_qubits(size_t gate_idx) const;
+    std::span<size_t const> get_pending_gates(QubitIdType qubit) const;
 
 protected:
+    // NOTE - the dependency graph in CSR form, indexed by gate id
+    struct GateSequences {
+        std::vector<size_t> gate_offsets;  // the qubits of gate i are gate_qubits[gate_offsets[i], gate_offsets[i + 1])
+        std::vector<QubitIdType> gate_qubits;
+        std::vector<size_t> wire_offsets;  // the gates on qubit q, in execution order, are wire_gates[wire_offsets[q], wire_offsets[q + 1])
+        std::vector<size_t> wire_gates;
+    };
+
     std::shared_ptr<qcir::QCir const> _dependency_graph;
+    std::shared_ptr<GateSequences const> _sequences;
     std::vector<size_t> _available_gates;
+    std::vector<size_t> _wire_cursors;  // _wire_cursors[q] = the position in wire_gates of the first unexecuted gate on qubit q
 
     bool _is_available(size_t gate_idx) const;
-
-    std::unordered_map<size_t, size_t> _executed_gates;  //  maps gate index to number of gates executed next
+    void _reset_available_gates();
 };
 
 }  // namespace qsyn::duostra
@@ -10,11 +10,17 @@
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <ranges>
+
 #include "./placer.hpp"
 #include "duostra/mapping_eqv_checker.hpp"
 #include "qcir/basic_gate_type.hpp"
 #include "qcir/qcir.hpp"
 #include "qsyn/qsyn_type.hpp"
+#include "util/parallel.hpp"
 
 extern bool stop_requested();
 
@@ -33,7 +39,7 @@ namespace qsyn::duostra {
  */
 Duostra::Duostra(QCir* cir, Device dev, DuostraExecutionOptions const& config)
     : _device(std::move(dev)), _check(config.verify_result),
-      _tqdm{!config.silent && config.use_tqdm}, _silent{config.silent}, _logical_circuit{std::make_shared<qcir::QCir>(*cir)} {}
+      _tqdm{!config.silent && config.use_tqdm}, _silent{config.silent}, _num_threads{config.num_threads.value_or(DuostraConfig::NUM_THREADS)}, _logical_circuit{std::make_shared<qcir::QCir>(*cir)} {}
 
 /**
  * @brief Main flow of Duostra mapper
@@ -52,21 +58,39 @@ bool Duostra::map(bool use_device_as_placement) {
         return false;
     }
 
+    auto phase_start     = std::chrono::steady_clock::now();
+    auto const end_phase = [&phase_start](std::chrono::duration<double>& phase_time) {
+        auto const now = std::chrono::steady_clock::now();
+        phase_time     = now - phase_start;
+        phase_start    = now;
+    };
+
     std::vector<QubitIdType> assign;
     if (!use_device_as_placement) {
         spdlog::info("Calculating Initial Placement...");
         auto placer = get_placer();
         assign      = placer->place_and_assign(_device);
     }
+    end_phase(_phase_times.placement);
+
+    auto cost_strategy = (DuostraConfig::SCHEDULER_TYPE == SchedulerType::greedy) ? Router::CostStrategyType::end
+                                                                                  : Router::CostStrategyType::start;
+    // computed ahead of the router and the scheduler, which then reuse the shared paths, so that the time is measured on its own
+    if (cost_strategy == Router::CostStrategyType::end ||
+        DuostraConfig::ROUTER_TYPE == RouterType::shortest_path ||
+        DuostraConfig::SCHEDULER_TYPE == SchedulerType::sabre) {
+        spdlog::info("Calculating Shortest Paths...");
+        _device.calculate_path();
+    }
+    end_phase(_phase_times.shortest_paths);
+
     // scheduler
     spdlog::info("Creating Scheduler...");
-    auto scheduler = get_scheduler(std::move(topo), _tqdm);
+    auto scheduler = get_scheduler(std::move(topo), _tqdm, _num_threads);
 
     // router
     spdlog::info("Creating Router...");
-    auto cost_strategy = (DuostraConfig::SCHEDULER_TYPE == SchedulerType::greedy) ? Router::CostStrategyType::end
-                                                                                  : Router::CostStrategyType::start;
-    auto router        = std::make_unique<Router>(std::move(_device), cost_strategy, DuostraConfig::TIE_BREAKING_STRATEGY);
+    auto router = std::make_unique<Router>(std::move(_device), cost_strategy, DuostraConfig::TIE_BREAKING_STRATEGY);
 
     // routing
     if (!_silent) {
@@ -77,6 +101,11 @@ bool Duostra::map(bool use_device_as_placement) {
         spdlog::warn("Warning: mapping interrupted");
         return false;
     }
+    if (scheduler->has_failed()) {
+        spdlog::error("Error: failed to route the circuit on {}!!", _device.get_name());
+        return false;
+    }
+    end_phase(_phase_times.scheduling);
 
     assert(scheduler->is_sorted());
     // assert(scheduler->get_order().size() == _logical_circuit->get_gates().size());
@@ -84,18 +113,37 @@ bool Duostra::map(bool use_device_as_placement) {
     for (auto const& [gate, _] : scheduler->get_operations())
         _result.emplace_back(gate);
 
+    _mapping_depth = _result.empty() ? 0 : scheduler->get_final_cost();
+    _total_time    = scheduler->get_total_time();
+    _num_swaps     = scheduler->get_num_swaps();
+
     // store_order_info(scheduler->get_order());
     build_circuit_by_result();
+    end_phase(_phase_times.result_building);
 
     if (_check) {
         if (!_silent) {
             fmt::println("Checking...");
-            fmt::println("");
         }
-        auto checker = MappingEquivalenceChecker(_physical_circuit.get(), _logical_circuit.get(), check_device);
-        if (!checker.check()) {
+        // SABRE refines the placement, so its checker starts from the placement the result is routed from;
+        // the other schedulers keep the placer's assignment, against which a drifting device mapping is still caught
+        if (DuostraConfig::SCHEDULER_TYPE == SchedulerType::sabre) {
+            auto refined = _get_refined_placement();
+            if (!refined.has_value()) {
+                return false;
+            }
+            assign = std::move(*refined);
+        }
+        auto checker          = MappingEquivalenceChecker(_physical_circuit.get(), _logical_circuit.get(), check_device, assign);
+        auto const equivalent = checker.check();
+        end_phase(_phase_times.checking);
+        if (!equivalent) {
             return false;
         }
+        if (!_silent) {
+            fmt::println("Equivalent up to permutation");
+            fmt::println("");
+        }
     }
 
     if (!_silent) {
@@ -105,15 +153,39 @@ bool Duostra::map(bool use_device_as_placement) {
         fmt::println("Router:         {}", get_router_type_str(DuostraConfig::ROUTER_TYPE));
         fmt::println("Placer:         {}", get_placer_type_str(DuostraConfig::PLACER_TYPE));
         fmt::println("");
-        fmt::println("Mapping Depth:  {}", scheduler->get_final_cost());
-        fmt::println("Total Time:     {}", scheduler->get_total_time());
-        fmt::println("#SWAP:          {}", scheduler->get_num_swaps());
+        fmt::println("Mapping Depth:  {}", _mapping_depth);
+        fmt::println("Total Time:     {}", _total_time);
+        fmt::println("#SWAP:          {}", _num_swaps);
         fmt::println("");
     }
 
     return true;
 }
 
+/**
+ * @brief Get the placement the result is routed from, by undoing the SWAPs of the result on the final placement
+ *
+ * @return std::optional<std::vector<QubitIdType>> the physical qubit of each logical qubit, or std::nullopt if the final placement is incomplete
+ */
+std::optional<std::vector<QubitIdType>> Duostra::_get_refined_placement() const {
+    auto physical_to_logical = _device.mapping();
+    for (auto const& operation : _result | std::views::reverse) {
+        if (operation.get_operation().is<SwapGate>()) {
+            std::swap(physical_to_logical[operation.get_qubit(0)], physical_to_logical[operation.get_qubit(1)]);
+        }
+    }
+
+    std::vector<QubitIdType> placement(physical_to_logical.size());
+    for (size_t i = 0; i < physical_to_logical.size(); ++i) {
+        if (!physical_to_logical[i].has_value()) {
+            spdlog::error("Physical qubit {} is not assigned a logical qubit after mapping!!", i);
+            return std::nullopt;
+        }
+        placement[*physical_to_logical[i]] = i;
+    }
+    return placement;
+}
+
 /**
  * @brief Convert index to full information of gate
  *
@@ -153,4 +225,46 @@ void Duostra::build_circuit_by_result() {
     }
 }
 
+/**
+ * @brief Map many logical circuits to the same device concurrently. The device is copied for each circuit,
+ *        while its topology, including the shortest paths, is computed once and shared by all copies.
+ *        The threads are split between the circuits first; the leftover threads evaluate the search tree of each circuit.
+ *
+ * @param logical_circuits
+ * @param device
+ * @param verify_result check the equivalence of each physical circuit to its logical circuit
+ * @param n_jobs number of threads to use. 0 means using all hardware threads
+ * @return std::vector<DuostraBatchResult> the results in the order of the logical circuits
+ */
+std::vector<DuostraBatchResult> map_batch(std::span<qcir::QCir* const> logical_circuits, qsyn::device::Device device, bool verify_result, size_t n_jobs) {
+    if (n_jobs == 0) n_jobs = dvlab::utils::hardware_concurrency();
+    // computed here so that the threads only read the shared topology
+    device.calculate_path();
+
+    auto const n_search_jobs = std::max(size_t{1}, n_jobs / std::max(size_t{1}, logical_circuits.size()));
+
+    // copying a QCir refreshes the topological order cached in the original, so the mappers are constructed on this thread
+    std::vector<Duostra> mappers;
+    mappers.reserve(logical_circuits.size());
+    for (auto* logical_circuit : logical_circuits) {
+        mappers.emplace_back(logical_circuit, device, Duostra::DuostraExecutionOptions{.verify_result = verify_result, .silent = true, .use_tqdm = false, .num_threads = n_search_jobs});
+    }
+
+    std::vector<DuostraBatchResult> results(mappers.size());
+    dvlab::utils::parallel_for(
+        mappers.size(),
+        [&](size_t i) {
+            auto const start   = std::chrono::steady_clock::now();
+            auto const success = mappers[i].map();
+            results[i].runtime = std::chrono::steady_clock::now() - start;
+            if (!success) return;
+            results[i].physical_circuit = std::move(mappers[i].get_physical_circuit());
+            results[i].mapping_depth    = mappers[i].get_mapping_depth();
+            results[i].num_swaps        = mappers[i].get_num_swaps();
+        },
+        n_jobs);
+
+    return results;
+}
+
 }  // namespace qsyn::duostra
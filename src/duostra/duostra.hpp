@@ -8,7 +8,10 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <optional>
+#include <span>
 
 #include "./duostra_def.hpp"
 #include "./scheduler.hpp"
@@ -28,11 +31,20 @@ class Duostra {
 public:
     using Device = qsyn::device::Device;
     struct DuostraExecutionOptions {
-        bool verify_result = false;
-        bool silent        = false;
-        bool use_tqdm      = true;
+        bool verify_result                = false;
+        bool silent                       = false;
+        bool use_tqdm                     = true;
+        std::optional<size_t> num_threads = std::nullopt;  // number of threads to evaluate the search tree on. If not set, use DuostraConfig::NUM_THREADS
     };
-    Duostra(qcir::QCir* qcir, Device dev, DuostraExecutionOptions const& config = {.verify_result = false, .silent = false, .use_tqdm = true});
+    // NOTE - the time spent in each phase of map(). The shortest paths are only computed if the router or the scheduler needs them
+    struct PhaseTimes {
+        std::chrono::duration<double> placement{};
+        std::chrono::duration<double> shortest_paths{};
+        std::chrono::duration<double> scheduling{};
+        std::chrono::duration<double> result_building{};
+        std::chrono::duration<double> checking{};
+    };
+    Duostra(qcir::QCir* qcir, Device dev, DuostraExecutionOptions const& config = {.verify_result = false, .silent = false, .use_tqdm = true, .num_threads = std::nullopt});
     // Duostra(std::vector<device::Operation> const& cir, size_t n_qubit, Device dev, DuostraExecutionOptions const& config = {.verify_result = false, .silent = false, .use_tqdm = true});
 
     std::unique_ptr<qcir::QCir> const& get_physical_circuit() const { return _physical_circuit; }
@@ -40,6 +52,10 @@ public:
     std::vector<qcir::QCirGate> const& get_result() const { return _result; }
     // auto const& get_order() const { return _order; }
     Device get_device() const { return _device; }
+    size_t get_mapping_depth() const { return _mapping_depth; }
+    size_t get_total_time() const { return _total_time; }
+    size_t get_num_swaps() const { return _num_swaps; }
+    PhaseTimes const& get_phase_times() const { return _phase_times; }
 
     void make_dependency();
     // void make_dependency(std::vector<Operation> const& ops, size_t n_qubits);
@@ -53,12 +69,28 @@ private:
     bool _check;
     bool _tqdm;
     bool _silent;
+    size_t _num_threads;
+    size_t _mapping_depth = 0;
+    size_t _total_time    = 0;
+    size_t _num_swaps     = 0;
+    PhaseTimes _phase_times;
     std::unique_ptr<BaseScheduler> _scheduler;
     std::shared_ptr<qcir::QCir> _logical_circuit;
     std::vector<qcir::QCirGate> _result;
     // std::vector<qcir::QCirGate> _order;
+
+    std::optional<std::vector<QubitIdType>> _get_refined_placement() const;
 };
 
+struct DuostraBatchResult {
+    std::unique_ptr<qcir::QCir> physical_circuit;  // nullptr if the mapping fails
+    size_t mapping_depth = 0;
+    size_t num_swaps     = 0;
+    std::chrono::duration<double> runtime{};
+};
+
+std::vector<DuostraBatchResult> map_batch(std::span<qcir::QCir* const> logical_circuits, qsyn::device::Device device, bool verify_result = false, size_t n_jobs = 0);
+
 }  // namespace duostra
 
 }  // namespace qsyn
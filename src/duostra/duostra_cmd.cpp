@@ -8,9 +8,11 @@
 
 #include <spdlog/spdlog.h>
 
+#include <chrono>
 #include <cstddef>
 #include <gsl/util>
 #include <string>
+#include <string_view>
 
 #include "./duostra.hpp"
 #include "./mapping_eqv_checker.hpp"
@@ -34,8 +36,8 @@ Command duostra_config_cmd() {
                 parser.description("set Duostra parameter(s)");
 
                 parser.add_argument<std::string>("--scheduler")
-                    .choices({"base", "naive", "random", "greedy", "search"})
-                    .help("<base | naive | random | greedy | search>");
+                    .choices({"base", "naive", "random", "greedy", "search", "sabre"})
+                    .help("<base | naive | random | greedy | search | sabre>");
                 parser.add_argument<std::string>("--router")
                     .choices({"shortest_path", "duostra"})
                     .help("<shortest_path | duostra>");
@@ -70,6 +72,18 @@ Command duostra_config_cmd() {
                 parser.add_argument<bool>("--single-immediately")
                     .help("execute the single gates when they are available");
 
+                parser.add_argument<size_t>("--jobs")
+                    .help("number of threads to evaluate the search tree on. 0 means using all hardware threads");
+
+                parser.add_argument<size_t>("--sabre-extended-set")
+                    .help("number of two-qubit gates the SABRE scheduler looks ahead beyond the front layer");
+
+                parser.add_argument<double>("--sabre-weight")
+                    .help("weight of the extended set in the SABRE swap score");
+
+                parser.add_argument<size_t>("--sabre-iterations")
+                    .help("number of forward-backward passes of the SABRE scheduler to refine the initial placement");
+
                 parser.add_argument<bool>("-v", "--verbose")
                     .help("print detailed information. This option only has effect when other options are not set")
                     .action(store_true);
@@ -144,6 +158,26 @@ Command duostra_config_cmd() {
                     printing_config                                = false;
                 }
 
+                if (parser.parsed("--jobs")) {
+                    DuostraConfig::NUM_THREADS = parser.get<size_t>("--jobs");
+                    printing_config            = false;
+                }
+
+                if (parser.parsed("--sabre-extended-set")) {
+                    DuostraConfig::SABRE_EXTENDED_SET_SIZE = parser.get<size_t>("--sabre-extended-set");
+                    printing_config                        = false;
+                }
+
+                if (parser.parsed("--sabre-weight")) {
+                    DuostraConfig::SABRE_EXTENDED_SET_WEIGHT = parser.get<double>("--sabre-weight");
+                    printing_config                          = false;
+                }
+
+                if (parser.parsed("--sabre-iterations")) {
+                    DuostraConfig::SABRE_ITERATIONS = parser.get<size_t>("--sabre-iterations");
+                    printing_config                 = false;
+                }
+
                 if (printing_config) {
                     fmt::println("");
                     fmt::println("Scheduler:         {}", get_scheduler_type_str(DuostraConfig::SCHEDULER_TYPE));
@@ -161,6 +195,10 @@ Command duostra_config_cmd() {
                         fmt::println("Cost Selector:     {}", get_minmax_type_str(DuostraConfig::COST_SELECTION_STRATEGY));
                         fmt::println("Never Cache:       {}", ((DuostraConfig::NEVER_CACHE) ? "true" : "false"));
                         fmt::println("Single Immed.:     {}", ((DuostraConfig::EXECUTE_SINGLE_QUBIT_GATES_ASAP == 1) ? "true" : "false"));
+                        fmt::println("# Threads:         {}", ((DuostraConfig::NUM_THREADS == 0) ? "all" : std::to_string(DuostraConfig::NUM_THREADS)));
+                        fmt::println("SABRE Ext. Set:    {}", DuostraConfig::SABRE_EXTENDED_SET_SIZE);
+                        fmt::println("SABRE Weight:      {}", DuostraConfig::SABRE_EXTENDED_SET_WEIGHT);
+                        fmt::println("SABRE Iterations:  {}", DuostraConfig::SABRE_ITERATIONS);
                     }
                 }
 
@@ -203,6 +241,85 @@ Command mapping_equivalence_check_cmd(qcir::QCirMgr& qcir_mgr, device::DeviceMgr
         }};
 }
 
+Command duostra_batch_cmd(qcir::QCirMgr& qcir_mgr, device::DeviceMgr& device_mgr) {
+    return {"batch",
+            [](ArgumentParser& parser) {
+                parser.description("map many logical circuits to the current device concurrently");
+                parser.add_argument<size_t>("ids")
+                    .nargs(NArgsOption::zero_or_more)
+                    .metavar("id")
+                    .help("the IDs of the logical QCirs to map. If not specified, map every QCir in the list");
+                parser.add_argument<bool>("-c", "--check")
+                    .default_value(false)
+                    .action(store_true)
+                    .help("check whether the mapping results are correct");
+                parser.add_argument<size_t>("-j", "--jobs")
+                    .default_value(0)
+                    .help("number of threads to map the circuits on. 0 means using all hardware threads");
+                parser.add_argument<bool>("--timing")
+                    .default_value(false)
+                    .action(store_true)
+                    .help("report the time spent on each circuit and on the whole batch");
+            },
+            [&](ArgumentParser const& parser) {
+                if (!dvlab::utils::mgr_has_data(qcir_mgr) || !dvlab::utils::mgr_has_data(device_mgr)) return CmdExecResult::error;
+
+                auto ids = parser.get<std::vector<size_t>>("ids");
+                if (ids.empty()) {
+                    for (size_t id = 0; id < qcir_mgr.get_next_id(); ++id) {
+                        if (qcir_mgr.is_id(id)) ids.emplace_back(id);
+                    }
+                }
+
+                std::vector<qcir::QCir*> logical_circuits;
+                for (auto const id : ids) {
+                    auto* logical_qcir = qcir_mgr.find_by_id(id);
+                    if (logical_qcir == nullptr) return CmdExecResult::error;
+                    logical_circuits.emplace_back(logical_qcir);
+                }
+
+                auto const start   = std::chrono::steady_clock::now();
+                auto results       = map_batch(logical_circuits, *device_mgr.get(), parser.get<bool>("--check"), parser.get<size_t>("--jobs"));
+                auto const runtime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+                // the runtimes are only reported on request, so that the results are the same in every run
+                auto const timing    = parser.get<bool>("--timing");
+                auto const print_row = [timing](auto const& logical_id, auto const& physical_id, auto const& depth, auto const& num_swaps, auto const& runtime, std::string_view filename) {
+                    if (timing) {
+                        fmt::println("{:>7}  {:>8}  {:>8}  {:>8}  {:>10}  {}", logical_id, physical_id, depth, num_swaps, runtime, filename);
+                    } else {
+                        fmt::println("{:>7}  {:>8}  {:>8}  {:>8}  {}", logical_id, physical_id, depth, num_swaps, filename);
+                    }
+                };
+
+                print_row("Logical", "Physical", "Depth", "#SWAP", "Time (s)", "Filename");
+                size_t n_mapped = 0;
+                for (size_t i = 0; i < results.size(); ++i) {
+                    auto const logical_id    = ids[i];
+                    auto const* logical_qcir = logical_circuits[i];
+                    auto& result             = results[i];
+                    if (result.physical_circuit == nullptr) {
+                        print_row(logical_id, "failed", "-", "-", fmt::format("{:.3f}", result.runtime.count()), logical_qcir->get_filename());
+                        continue;
+                    }
+                    auto const physical_id = qcir_mgr.get_next_id();
+                    qcir_mgr.add(physical_id, std::move(result.physical_circuit));
+                    qcir_mgr.get()->set_filename(logical_qcir->get_filename());
+                    qcir_mgr.get()->add_procedures(logical_qcir->get_procedures());
+                    qcir_mgr.get()->add_procedure("Duostra");
+                    ++n_mapped;
+                    print_row(logical_id, physical_id, result.mapping_depth, result.num_swaps, fmt::format("{:.3f}", result.runtime.count()), logical_qcir->get_filename());
+                }
+                if (timing) {
+                    fmt::println("Mapped {} of {} circuits in {:.3f} s", n_mapped, results.size(), runtime.count());
+                } else {
+                    fmt::println("Mapped {} of {} circuits", n_mapped, results.size());
+                }
+
+                return n_mapped == results.size() ? CmdExecResult::done : CmdExecResult::error;
+            }};
+}
+
 Command duostra_cmd(qcir::QCirMgr& qcir_mgr, device::DeviceMgr& device_mgr) {
     auto cmd = Command{"duostra",
                        [](ArgumentParser& parser) {
@@ -219,6 +336,10 @@ Command duostra_cmd(qcir::QCirMgr& qcir_mgr, device::DeviceMgr& device_mgr) {
                                .default_value(false)
                                .action(store_true)
                                .help("mute all messages");
+                           parser.add_argument<bool>("--timing")
+                               .default_value(false)
+                               .action(store_true)
+                               .help("report the time spent in placement, shortest paths, scheduling, result building and checking");
                        },
 
                        [&](ArgumentParser const& parser) {
@@ -245,6 +366,16 @@ Command duostra_cmd(qcir::QCirMgr& qcir_mgr, device::DeviceMgr& device_mgr) {
                                return CmdExecResult::error;
                            }
 
+                           if (parser.get<bool>("--timing")) {
+                               auto const& times = duo.get_phase_times();
+                               fmt::println("Placement:      {:.4f} seconds", times.placement.count());
+                               fmt::println("APSP:           {:.4f} seconds", times.shortest_paths.count());
+                               fmt::println("Scheduling:     {:.4f} seconds", times.scheduling.count());
+                               fmt::println("Result:         {:.4f} seconds", times.result_building.count());
+                               fmt::println("Checking:       {:.4f} seconds", times.checking.count());
+                               fmt::println("");
+                           }
+
                            if (duo.get_physical_circuit() == nullptr) {
                                spdlog::error("Detected error in Duostra Mapping!!");
                            }
@@ -259,6 +390,7 @@ Command duostra_cmd(qcir::QCirMgr& qcir_mgr, device::DeviceMgr& device_mgr) {
                        }};
 
     cmd.add_subcommand("duostra-cmd", duostra_config_cmd());
+    cmd.add_subcommand("duostra-cmd", duostra_batch_cmd(qcir_mgr, device_mgr));
     return cmd;
 }
 
@@ -25,6 +25,8 @@ std::string get_scheduler_type_str(SchedulerType const& type) {
             return "random";
         case SchedulerType::greedy:
             return "greedy";
+        case SchedulerType::sabre:
+            return "sabre";
         case SchedulerType::search:
         default:
             return "search";
@@ -90,6 +92,7 @@ std::optional<SchedulerType> get_scheduler_type(std::string const& str) {
     if (str == "random") return SchedulerType::random;
     if (str == "greedy") return SchedulerType::greedy;
     if (str == "search") return SchedulerType::search;
+    if (str == "sabre") return SchedulerType::sabre;
 
     return std::nullopt;
 }
@@ -147,5 +150,11 @@ MinMaxOptionType DuostraConfig::COST_SELECTION_STRATEGY = MinMaxOptionType::min;
 size_t DuostraConfig::SEARCH_DEPTH                  = 4;  // depth of searching region
 bool DuostraConfig::NEVER_CACHE                     = 1;  // never cache any children unless children() is called
 bool DuostraConfig::EXECUTE_SINGLE_QUBIT_GATES_ASAP = 0;  // execute the single gates when they are available
+size_t DuostraConfig::NUM_THREADS                   = 1;  // number of threads to evaluate the search tree on, 0: all hardware threads
+
+// SECTION - Initialize in SABRE Scheduler
+size_t DuostraConfig::SABRE_EXTENDED_SET_SIZE   = 20;   // number of two-qubit gates looked ahead beyond the front layer
+double DuostraConfig::SABRE_EXTENDED_SET_WEIGHT = 0.5;  // weight of the extended set in the swap score
+size_t DuostraConfig::SABRE_ITERATIONS          = 1;    // number of forward-backward passes to refine the initial placement
 
 }  // namespace qsyn::duostra
@@ -25,6 +25,7 @@ enum class SchedulerType : std::uint8_t {
     random,
     greedy,
     search,
+    sabre,
 };
 
 enum class PlacerType : std::uint8_t {
@@ -69,6 +70,12 @@ struct DuostraConfig {
     static size_t SEARCH_DEPTH;                   // depth of searching region
     static bool NEVER_CACHE;                      // never cache any children unless children() is called
     static bool EXECUTE_SINGLE_QUBIT_GATES_ASAP;  // execute the single gates when they are available
+    static size_t NUM_THREADS;                    // number of threads to evaluate the search tree on, 0: all hardware threads
+
+    // SECTION - Initialize in SABRE Scheduler
+    static size_t SABRE_EXTENDED_SET_SIZE;    // number of two-qubit gates looked ahead beyond the front layer
+    static double SABRE_EXTENDED_SET_WEIGHT;  // weight of the extended set in the swap score
+    static size_t SABRE_ITERATIONS;           // number of forward-backward passes to refine the initial placement
 };
 
 }  // namespace qsyn::duostra
@@ -7,230 +7,310 @@
 
 #include "./mapping_eqv_checker.hpp"
 
-#include <tl/enumerate.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
 
 #include "./placer.hpp"
 #include "qcir/basic_gate_type.hpp"
 #include "qcir/qcir.hpp"
 #include "qcir/qcir_gate.hpp"
-#include "qcir/qcir_qubit.hpp"
 #include "qsyn/qsyn_type.hpp"
 
 using namespace qsyn::qcir;
 
 namespace qsyn::duostra {
 
+namespace {
+
+constexpr auto no_gate = SIZE_MAX;
+
+}  // namespace
+
 /**
  * @brief Construct a new Ext Checker:: Ext Checker object
  *
  * @param phy
  * @param log
  * @param dev
- * @param init
+ * @param init the physical qubit of each logical qubit. If empty, the placer of Duostra is used
  * @param reverse check reversily if true
  */
 MappingEquivalenceChecker::MappingEquivalenceChecker(QCir* phy, QCir* log, Device dev, std::vector<QubitIdType> init, bool reverse) : _physical(phy), _logical(log), _device(std::move(dev)), _reverse(reverse) {
     if (init.empty()) {
         auto placer = get_placer();
         init        = placer->place_and_assign(_device);
-    } else
-        _device.place(init);
-    for (auto const& [i, qubit] : tl::views::enumerate(_logical->get_qubits())) {
-        _dependency[i] = _reverse ? qubit.get_last_gate() : qubit.get_first_gate();
+    }
+
+    auto const num_physical_qubits = std::max(_physical->get_num_qubits(), _device.get_num_qubits());
+    auto const num_logical_qubits  = std::max(_logical->get_num_qubits(), init.size());
+    _physical_sequences            = _flatten(*_physical, num_physical_qubits);
+    _logical_sequences             = _flatten(*_logical, num_logical_qubits);
+    _physical_cursors.assign(_physical_sequences.wire_offsets.begin(), _physical_sequences.wire_offsets.end() - 1);
+    _logical_cursors.assign(_logical_sequences.wire_offsets.begin(), _logical_sequences.wire_offsets.end() - 1);
+
+    _physical_to_logical.assign(num_physical_qubits, max_qubit_id);
+    for (size_t i = 0; i < init.size(); ++i) {
+        _physical_to_logical[init[i]] = i;
     }
 }
 
 /**
- * @brief Check physical circuit
+ * @brief Check physical circuit. The first mismatch, if any, is reported as an error.
  *
  * @return true
  * @return false
  */
 bool MappingEquivalenceChecker::check() {
-    auto execute_order = _physical->get_gates();
-    if (_reverse) std::ranges::reverse(execute_order);  // NOTE - Now the order starts from back
+    auto const& gates = _physical_sequences.gates;
     // NOTE - Traverse all physical gates, should match dependency of logical gate
-    std::unordered_set<QCirGate*> swaps;
-    for (auto const& phys_gate : execute_order) {
-        if (swaps.contains(phys_gate)) {
-            continue;
+    std::vector<bool> swaps(gates.size(), false);
+    for (size_t i = 0; i < gates.size(); ++i) {
+        auto const* phys_gate = gates[i];
+        if (!swaps[i]) {
+            if (phys_gate->get_num_qubits() == 2) {
+                if (_is_swap(i)) {
+                    if (!_execute_swap(i, swaps)) return false;
+                } else {
+                    if (!_execute_double(i)) return false;
+                }
+            } else if (phys_gate->get_num_qubits() > 1) {
+                spdlog::error("Gate {} acts on more than two qubits!!", phys_gate->get_id());
+                return false;
+            } else if (!_execute_single(i))
+                return false;
         }
-        if (phys_gate->get_num_qubits() == 2) {
-            if (is_swap(phys_gate)) {
-                if (!execute_swap(phys_gate, swaps)) return false;
-            } else {
-                if (!execute_double(phys_gate)) return false;
-            }
-        } else if (phys_gate->get_num_qubits() > 1) {
-            return false;
-        } else if (!execute_single(phys_gate))
-            return false;
+        _advance(_physical_sequences, _physical_cursors, i);
     }
-    // REVIEW - check remaining gates in logical are swaps
-    check_remaining();
-    // Should end with all qubits in _dependency = nullptr;
-    return true;
+    return _check_remaining();
+}
+
+/**
+ * @brief Flatten a circuit into its gates in execution order and the positions of the gates on each qubit
+ *
+ * @param qcir
+ * @param num_qubits
+ * @return GateSequences
+ */
+MappingEquivalenceChecker::GateSequences MappingEquivalenceChecker::_flatten(QCir const& qcir, size_t num_qubits) const {
+    GateSequences seq;
+    seq.gates = qcir.get_gates();  // topologically ordered
+    if (_reverse) std::ranges::reverse(seq.gates);  // NOTE - Now the order starts from back
+
+    seq.wire_offsets.assign(num_qubits + 1, 0);
+    for (auto const* gate : seq.gates) {
+        for (auto const qubit : gate->get_qubits()) {
+            ++seq.wire_offsets[qubit + 1];
+        }
+    }
+    std::partial_sum(seq.wire_offsets.begin(), seq.wire_offsets.end(), seq.wire_offsets.begin());
+
+    seq.wire_gates.resize(seq.wire_offsets.back());
+    std::vector<size_t> fill(seq.wire_offsets.begin(), seq.wire_offsets.end() - 1);
+    for (size_t i = 0; i < seq.gates.size(); ++i) {
+        for (auto const qubit : seq.gates[i]->get_qubits()) {
+            seq.wire_gates[fill[qubit]++] = i;
+        }
+    }
+    return seq;
+}
+
+/**
+ * @brief Get the position of the next logical gate to match on a logical qubit
+ *
+ * @param logical
+ * @return size_t the position in the logical gates, or SIZE_MAX if all the gates on the qubit are matched
+ */
+size_t MappingEquivalenceChecker::_get_logical_frontier(QubitIdType logical) const {
+    if (logical >= _logical_cursors.size()) return no_gate;
+    auto const cursor = _logical_cursors[logical];
+    return cursor == _logical_sequences.wire_offsets[logical + 1] ? no_gate : _logical_sequences.wire_gates[cursor];
+}
+
+/**
+ * @brief Get the physical gate some steps after the one being checked on a physical qubit
+ *
+ * @param physical
+ * @param steps
+ * @return size_t the position in the physical gates, or SIZE_MAX if the qubit has no such gate
+ */
+size_t MappingEquivalenceChecker::_get_physical_next(QubitIdType physical, size_t steps) const {
+    auto const cursor = _physical_cursors[physical] + steps;
+    return cursor >= _physical_sequences.wire_offsets[physical + 1] ? no_gate : _physical_sequences.wire_gates[cursor];
 }
 
 /**
- * @brief Check the gate and its previous two gates constitute a swap
+ * @brief Move the cursors on the qubits of a gate past it
  *
- * @param candidate
+ * @param seq
+ * @param cursors
+ * @param position
+ */
+void MappingEquivalenceChecker::_advance(GateSequences const& seq, std::vector<size_t>& cursors, size_t position) const {
+    for (auto const qubit : seq.gates[position]->get_qubits()) {
+        assert(seq.wire_gates[cursors[qubit]] == position);
+        ++cursors[qubit];
+    }
+}
+
+/**
+ * @brief Check the gate and its next two gates constitute a swap
+ *
+ * @param position
  * @return true
  * @return false
  */
-bool MappingEquivalenceChecker::is_swap(QCirGate* candidate) {
-    if (candidate->get_operation() != CXGate()) return false;
-    QCirGate* q0_gate = get_next(*_physical, candidate->get_id(), 0);
-    QCirGate* q1_gate = get_next(*_physical, candidate->get_id(), 1);
-
-    if (q0_gate != q1_gate || q0_gate == nullptr || q1_gate == nullptr) return false;
-    if (q0_gate->get_operation() != CXGate()) return false;
-    // q1gate == q0 gate
-    if (candidate->get_qubit(0) != q1_gate->get_qubit(1) ||
-        candidate->get_qubit(1) != q0_gate->get_qubit(0)) return false;
-
-    candidate = q0_gate;
-    q0_gate   = get_next(*_physical, candidate->get_id(), 0);
-    q1_gate   = get_next(*_physical, candidate->get_id(), 1);
-
-    if (q0_gate != q1_gate || q0_gate == nullptr || q1_gate == nullptr) return false;
-    if (q0_gate->get_operation() != CXGate()) return false;
-    // q1 gate == q0 gate
-    if (candidate->get_qubit(0) != q1_gate->get_qubit(1) ||
-        candidate->get_qubit(1) != q0_gate->get_qubit(0)) return false;
+bool MappingEquivalenceChecker::_is_swap(size_t position) const {
+    auto const& gates = _physical_sequences.gates;
+    auto const* first = gates[position];
+    if (first->get_operation() != CXGate()) return false;
+    auto const q0 = first->get_qubit(0);
+    auto const q1 = first->get_qubit(1);
+
+    // NOTE - the second CX is reversed and the third is the same as the first, with no other gate on the two qubits in between
+    for (size_t steps = 1; steps <= 2; ++steps) {
+        auto const next = _get_physical_next(q0, steps);
+        if (next == no_gate || next != _get_physical_next(q1, steps)) return false;
+        auto const* gate = gates[next];
+        if (gate->get_operation() != CXGate()) return false;
+        auto const reversed = steps == 1;
+        if (gate->get_qubit(0) != (reversed ? q1 : q0) || gate->get_qubit(1) != (reversed ? q0 : q1)) return false;
+    }
 
     // NOTE - If it is actually a gate in dependency, it can not be changed into swap
-    auto logical_gate_ctrl_id = _device.get_physical_qubit(candidate->get_qubit(0)).get_logical_qubit();
-    auto logical_gate_targ_id = _device.get_physical_qubit(candidate->get_qubit(1)).get_logical_qubit();
+    auto const logical_ctrl_id = _physical_to_logical[q0];
+    auto const logical_targ_id = _physical_to_logical[q1];
 
-    assert(logical_gate_ctrl_id.has_value());
-    assert(logical_gate_targ_id.has_value());
+    assert(logical_ctrl_id != max_qubit_id);
+    assert(logical_targ_id != max_qubit_id);
 
-    QCirGate* log_gate0 = _dependency[logical_gate_ctrl_id.value()];
-    QCirGate* log_gate1 = _dependency[logical_gate_targ_id.value()];
+    auto const log_gate0 = _get_logical_frontier(logical_ctrl_id);
+    auto const log_gate1 = _get_logical_frontier(logical_targ_id);
 
-    return log_gate0 != log_gate1 || log_gate0 == nullptr || log_gate0->get_operation() != CXGate();
+    return log_gate0 != log_gate1 || log_gate0 == no_gate || _logical_sequences.gates[log_gate0]->get_operation() != CXGate();
 }
 
 /**
  * @brief Execute swap gate
  *
- * @param first first gate of swap
+ * @param position the first gate of swap
  * @param swaps container to mark
  * @return true
  * @return false
  */
-bool MappingEquivalenceChecker::execute_swap(QCirGate* first, std::unordered_set<QCirGate*>& swaps) {
-    if (!_device.get_physical_qubit(first->get_qubit(0)).is_adjacency(_device.get_physical_qubit(first->get_qubit(1)))) return false;
-
-    swaps.emplace(first);
-    auto next_gate = get_next(*_physical, first->get_id(), 0);
-    swaps.emplace(next_gate);
-    swaps.emplace(get_next(*_physical, next_gate->get_id(), 0));
-    _device.apply_swap_check(first->get_qubit(0), first->get_qubit(1));
+bool MappingEquivalenceChecker::_execute_swap(size_t position, std::vector<bool>& swaps) {
+    auto const* first = _physical_sequences.gates[position];
+    auto const q0     = first->get_qubit(0);
+    auto const q1     = first->get_qubit(1);
+    if (!_device.is_adjacent(q0, q1)) {
+        spdlog::error("SWAP at gate {} acts on non-adjacent qubits {} and {}!!", first->get_id(), q0, q1);
+        return false;
+    }
+
+    swaps[_get_physical_next(q0, 1)] = true;
+    swaps[_get_physical_next(q0, 2)] = true;
+    std::swap(_physical_to_logical[q0], _physical_to_logical[q1]);
     return true;
 }
 
 /**
  * @brief Execute single-qubit gate
  *
- * @param gate
+ * @param position
  * @return true
  * @return false
  */
-bool MappingEquivalenceChecker::execute_single(QCirGate* gate) {
-    auto const& logical_qubit = _device.get_physical_qubit(gate->get_qubit(0)).get_logical_qubit();
+bool MappingEquivalenceChecker::_execute_single(size_t position) {
+    auto const* gate         = _physical_sequences.gates[position];
+    auto const logical_qubit = _physical_to_logical[gate->get_qubit(0)];
 
-    assert(logical_qubit.has_value());
+    assert(logical_qubit != max_qubit_id);
 
-    QCirGate* logical = _dependency[logical_qubit.value()];
-    if (logical == nullptr) {
+    auto const logical_position = _get_logical_frontier(logical_qubit);
+    if (logical_position == no_gate) {
         spdlog::error("Corresponding logical gate of gate {} is nullptr!!", gate->get_id());
         return false;
     }
+    auto const* logical = _logical_sequences.gates[logical_position];
 
     if (logical->get_operation() != gate->get_operation()) {
         spdlog::error("Type of gate {} mismatches!!", gate->get_id());
         return false;
     }
 
-    if (logical->get_qubit(0) != logical_qubit.value()) {
+    if (logical->get_qubit(0) != logical_qubit) {
         spdlog::error("Target qubit of gate {} mismatches!!", gate->get_id());
         return false;
     }
 
-    _dependency[logical->get_qubit(0)] = get_next(*_logical, logical->get_id(), 0);
+    _advance(_logical_sequences, _logical_cursors, logical_position);
     return true;
 }
 
 /**
  * @brief Execute double-qubit gate
  *
- * @param gate
+ * @param position
  * @return true
  * @return false
  */
-bool MappingEquivalenceChecker::execute_double(QCirGate* gate) {
-    auto logical_ctrl_id = _device.get_physical_qubit(gate->get_qubit(0)).get_logical_qubit();
-    auto logical_targ_id = _device.get_physical_qubit(gate->get_qubit(1)).get_logical_qubit();
+bool MappingEquivalenceChecker::_execute_double(size_t position) {
+    auto const* gate           = _physical_sequences.gates[position];
+    auto const logical_ctrl_id = _physical_to_logical[gate->get_qubit(0)];
+    auto const logical_targ_id = _physical_to_logical[gate->get_qubit(1)];
 
-    assert(logical_ctrl_id.has_value());
-    assert(logical_targ_id.has_value());
+    assert(logical_ctrl_id != max_qubit_id);
+    assert(logical_targ_id != max_qubit_id);
 
-    if (_dependency[logical_ctrl_id.value()] != _dependency[logical_targ_id.value()]) {
+    auto const logical_position = _get_logical_frontier(logical_targ_id);
+    if (_get_logical_frontier(logical_ctrl_id) != logical_position) {
         spdlog::error("Gate {} violates dependency graph!!", gate->get_id());
         return false;
     }
-    QCirGate* logical_gate = _dependency[logical_targ_id.value()];
-    if (logical_gate == nullptr) {
+    if (logical_position == no_gate) {
         spdlog::error("Corresponding logical gate of gate {} is nullptr!!", gate->get_id());
         return false;
     }
+    auto const* logical_gate = _logical_sequences.gates[logical_position];
 
     if (logical_gate->get_operation() != gate->get_operation()) {
         spdlog::error("Type of gate {} mismatches!!", gate->get_id());
         return false;
     }
-    if (logical_gate->get_qubit(0) != logical_ctrl_id.value()) {
+    if (logical_gate->get_qubit(0) != logical_ctrl_id) {
         spdlog::error("Control qubit of gate {} mismatches!!", gate->get_id());
         return false;
     }
-    if (logical_gate->get_qubit(1) != logical_targ_id.value()) {
+    if (logical_gate->get_qubit(1) != logical_targ_id) {
         spdlog::error("Target qubit of gate {} mismatches!!", gate->get_id());
         return false;
     }
 
-    if (!_device.get_physical_qubit(gate->get_qubit(0)).is_adjacency(_device.get_physical_qubit(gate->get_qubit(1)))) return false;
-
-    _dependency[logical_gate->get_qubit(0)] = get_next(*_logical, logical_gate->get_id(), 0);
-    _dependency[logical_gate->get_qubit(1)] = get_next(*_logical, logical_gate->get_id(), 1);
+    if (!_device.is_adjacent(gate->get_qubit(0), gate->get_qubit(1))) {
+        spdlog::error("Gate {} acts on non-adjacent qubits {} and {}!!", gate->get_id(), gate->get_qubit(0), gate->get_qubit(1));
+        return false;
+    }
 
+    _advance(_logical_sequences, _logical_cursors, logical_position);
     return true;
 }
 
 /**
- * @brief Check gates in remaining logical circuit are all swaps
+ * @brief Check that every gate of the logical circuit has been matched by the physical circuit
  *
- * @return true
- * @return false
+ * @return true if no logical gate is left
  */
-void MappingEquivalenceChecker::check_remaining() {
-    for (auto const& [q, g] : _dependency) {
-        if (g != nullptr) {
-            spdlog::warn("Note: qubit {} has gates remaining", q);
+bool MappingEquivalenceChecker::_check_remaining() const {
+    for (size_t q = 0; q < _logical_cursors.size(); ++q) {
+        if (_get_logical_frontier(q) != no_gate) {
+            spdlog::error("Logical qubit {} has gates that are not executed in the physical circuit!!", q);
+            return false;
         }
     }
-}
-
-/**
- * @brief Get next gate
- *
- * @param info
- * @return QCirGate*
- */
-QCirGate* MappingEquivalenceChecker::get_next(qcir::QCir const& qcir, size_t gate_id, size_t pin) const {
-    return qcir.get_gate(_reverse ? qcir.get_predecessor(gate_id, pin) : qcir.get_successor(gate_id, pin));
+    return true;
 }
 
 }  // namespace qsyn::duostra
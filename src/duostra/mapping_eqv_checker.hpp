@@ -8,8 +8,7 @@
 #pragma once
 
 #include <cstddef>
-#include <optional>
-#include <unordered_set>
+#include <vector>
 
 #include "device/device.hpp"
 #include "qsyn/qsyn_type.hpp"
@@ -20,33 +19,55 @@ namespace qcir {
 
 class QCir;
 class QCirGate;
-struct QubitInfo;
 
 }  // namespace qcir
 
 namespace duostra {
 
+/**
+ * @brief Check that a physical circuit executes the gates of a logical circuit in dependency order, up to the SWAPs inserted by mapping.
+ *        Both circuits are flattened once into per-qubit gate sequences, and the logical-physical permutation is kept in dense arrays,
+ *        so that the check takes linear time in the number of gates.
+ *
+ */
 class MappingEquivalenceChecker {
 public:
     using Device = qsyn::device::Device;
     MappingEquivalenceChecker(qcir::QCir* phy, qcir::QCir* log, Device dev, std::vector<QubitIdType> init = {}, bool reverse = false);
 
     bool check();
-    bool is_swap(qcir::QCirGate* candidate);
-    bool execute_swap(qcir::QCirGate* first, std::unordered_set<qcir::QCirGate*>& swaps);
-    bool execute_single(qcir::QCirGate* gate);
-    bool execute_double(qcir::QCirGate* gate);
-
-    void check_remaining();
-    qcir::QCirGate* get_next(qcir::QCir const& qcir, size_t gate_id, size_t pin) const;
 
 private:
+    // NOTE - the gates of a circuit in execution order, with the positions of the gates on each qubit in CSR form
+    struct GateSequences {
+        std::vector<qcir::QCirGate*> gates;
+        std::vector<size_t> wire_offsets;  // the positions on qubit q are wire_gates[wire_offsets[q] .. wire_offsets[q + 1])
+        std::vector<size_t> wire_gates;    // positions in `gates`
+    };
+
     qcir::QCir* _physical;
     qcir::QCir* _logical;
     Device _device;
     bool _reverse;
-    // <qubit, gate to execute (from back)> for logical circuit
-    std::unordered_map<QubitIdType, qcir::QCirGate*> _dependency;
+
+    GateSequences _physical_sequences;
+    GateSequences _logical_sequences;
+    std::vector<size_t> _physical_cursors;  // _physical_cursors[p] = the position in wire_gates of the physical gate being checked on qubit p
+    std::vector<size_t> _logical_cursors;   // _logical_cursors[l] = the position in wire_gates of the next logical gate to match on qubit l
+
+    std::vector<QubitIdType> _physical_to_logical;
+
+    GateSequences _flatten(qcir::QCir const& qcir, size_t num_qubits) const;
+    size_t _get_logical_frontier(QubitIdType logical) const;
+    size_t _get_physical_next(QubitIdType physical, size_t steps) const;
+    void _advance(GateSequences const& seq, std::vector<size_t>& cursors, size_t position) const;
+
+    bool _is_swap(size_t position) const;
+    bool _execute_swap(size_t position, std::vector<bool>& swaps);
+    bool _execute_single(size_t position);
+    bool _execute_double(size_t position);
+
+    bool _check_remaining() const;
 };
 
 }  // namespace duostra
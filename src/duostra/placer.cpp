@@ -113,16 +113,16 @@ void DFSPlacer::_dfs_device(QubitIdType current, Device& device, std::vector<Qub
     qubit_marks[current] = true;
     assign.emplace_back(current);
 
-    auto const& q = device.get_physical_qubit(current);
+    auto const& adjacencies = device.get_adjacencies(current);
     std::vector<QubitIdType> adjacency_waitlist;
 
-    for (auto& adj : q.get_adjacencies()) {
+    for (auto& adj : adjacencies) {
         // already marked
         if (qubit_marks[adj])
             continue;
-        assert(!q.get_adjacencies().empty());
+        assert(!adjacencies.empty());
         // corner
-        if (q.get_adjacencies().size() == 1)
+        if (adjacencies.size() == 1)
             _dfs_device(adj, device, assign, qubit_marks);
         else
             adjacency_waitlist.emplace_back(adj);
@@ -10,8 +10,10 @@
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <gsl/narrow>
 #include <gsl/util>
+#include <limits>
 
 #include "device/device.hpp"
 #include "duostra/duostra_def.hpp"
@@ -35,6 +37,72 @@ namespace qsyn::duostra {
 AStarNode::AStarNode(size_t cost, QubitIdType id, bool source)
     : _estimated_cost(cost), _id(id), _source(source) {}
 
+// SECTION - Class AStarWorkspace Member Functions
+
+/**
+ * @brief Start a new search. Only grows the arrays if the device has more qubits than any device seen before.
+ *
+ * @param num_qubits
+ */
+void AStarWorkspace::start(size_t num_qubits) {
+    if (_stamps.size() < num_qubits) {
+        _stamps.resize(num_qubits, _epoch);
+        _sources.resize(num_qubits);
+        _taken.resize(num_qubits);
+        _predecessors.resize(num_qubits);
+        _costs.resize(num_qubits);
+        _swap_times.resize(num_qubits);
+    }
+    // the stamps of all qubits are at most the current epoch, so no qubit is marked in the next one
+    if (_epoch == std::numeric_limits<std::uint32_t>::max()) {
+        std::ranges::fill(_stamps, 0);
+        _epoch = 0;
+    }
+    ++_epoch;
+    _heap.clear();
+}
+
+/**
+ * @brief Mark qubit
+ *
+ * @param q
+ * @param source false: from 0, true: from 1
+ * @param pred predecessor
+ */
+void AStarWorkspace::mark(QubitIdType q, bool source, QubitIdType pred) {
+    _stamps[q]       = _epoch;
+    _sources[q]      = source;
+    _taken[q]        = false;
+    _predecessors[q] = pred;
+}
+
+/**
+ * @brief Take the route
+ *
+ * @param q
+ * @param cost
+ * @param swap_time
+ */
+void AStarWorkspace::take_route(QubitIdType q, size_t cost, size_t swap_time) {
+    assert(is_marked(q));
+    _costs[q]      = cost;
+    _swap_times[q] = swap_time;
+    _taken[q]      = true;
+}
+
+void AStarWorkspace::push(AStarNode const& node) {
+    _heap.push_back(node);
+    std::ranges::push_heap(_heap, AStarComp{});
+}
+
+AStarNode AStarWorkspace::pop() {
+    assert(!_heap.empty());
+    std::ranges::pop_heap(_heap, AStarComp{});
+    auto const node = _heap.back();
+    _heap.pop_back();
+    return node;
+}
+
 // SECTION - Class Router Member Functions
 
 /**
@@ -47,7 +115,6 @@ AStarNode::AStarNode(size_t cost, QubitIdType id, bool source)
 Router::Router(Device device, Router::CostStrategyType cost_strategy, MinMaxOptionType tie_breaking_strategy)
     : _tie_breaking_strategy(tie_breaking_strategy),
       _device(std::move(device)),
-      _logical_to_physical({}),
       _apsp(DuostraConfig::ROUTER_TYPE == RouterType::shortest_path || cost_strategy == CostStrategyType::end),
       _duostra(DuostraConfig::ROUTER_TYPE == RouterType::duostra) {
     _initialize();
@@ -74,12 +141,13 @@ void Router::_initialize() {
     }
 
     auto const num_qubits = _device.get_num_qubits();
-    _logical_to_physical.resize(num_qubits);
+    std::vector<QubitIdType> logical_to_physical(num_qubits);
     for (size_t i = 0; i < num_qubits; ++i) {
         auto const& qubit = _device.get_physical_qubit(i).get_logical_qubit();
         assert(qubit.has_value());
-        _logical_to_physical[qubit.value()] = i;
+        logical_to_physical[qubit.value()] = i;
     }
+    _logical_to_physical = dvlab::utils::DeltaVector<QubitIdType>{std::move(logical_to_physical)};
 }
 
 /**
@@ -139,9 +207,7 @@ bool Router::is_executable(qcir::QCirGate const& gate) {
 
     auto physical_qubits_ids{_get_physical_qubits(gate)};
     assert(get<1>(physical_qubits_ids) != max_qubit_id);
-    PhysicalQubit const& q0 = _device.get_physical_qubit(get<0>(physical_qubits_ids));
-    PhysicalQubit const& q1 = _device.get_physical_qubit(get<1>(physical_qubits_ids));
-    return q0.is_adjacency(q1);
+    return _device.is_adjacent(get<0>(physical_qubits_ids), get<1>(physical_qubits_ids));
 }
 
 /**
@@ -153,11 +219,9 @@ bool Router::is_executable(qcir::QCirGate const& gate) {
  * @return Operation
  */
 GateInfo Router::execute_single(qcir::QCirGate const& gate, QubitIdType q) {
-    auto& qubit           = _device.get_physical_qubit(q);
-    auto const start_time = qubit.get_occupied_time();
+    auto const start_time = _device.get_physical_qubit(q).get_occupied_time();
     auto const end_time   = start_time + gate.get_delay();
-    qubit.set_occupied_time(end_time);
-    qubit.reset();
+    _device.set_occupied_time(q, end_time);
     auto op = qcir::QCirGate{0, gate.get_operation(), QubitIdList{q, max_qubit_id}};
     return {op, {start_time, end_time}};
 }
@@ -192,36 +256,35 @@ std::vector<GateInfo> Router::duostra_routing(qcir::QCirGate const& gate, std::t
         }
     }
 
-    PhysicalQubit& t0 = _device.get_physical_qubit(q0_id);  // target 0
-    PhysicalQubit& t1 = _device.get_physical_qubit(q1_id);  // target 1
-    // priority queue: pop out the node with the smallest cost from both the sources
-    PriorityQueue priority_queue;
+    auto const t0_id = q0_id;  // target 0
+    auto const t1_id = q1_id;  // target 1
+    // the workspace is reused by every routing on this thread, so that no memory is allocated per gate
+    thread_local AStarWorkspace workspace;
+    workspace.start(_device.get_num_qubits());
 
     // init conditions for the sources
-    t0.mark(false, t0.get_id());
-    t0.take_route(t0.get_cost(), 0);
-    t1.mark(true, t1.get_id());
-    t1.take_route(t1.get_cost(), 0);
-    auto const touch0 = _touch_adjacency(t0, priority_queue, false);
+    workspace.mark(t0_id, false, t0_id);
+    workspace.take_route(t0_id, _device.get_physical_qubit(t0_id).get_occupied_time(), 0);
+    workspace.mark(t1_id, true, t1_id);
+    workspace.take_route(t1_id, _device.get_physical_qubit(t1_id).get_occupied_time(), 0);
+    auto const touch0 = _touch_adjacency(t0_id, workspace, false);
     auto is_adjacent  = get<0>(touch0);
-    _touch_adjacency(t1, priority_queue, true);
+    _touch_adjacency(t1_id, workspace, true);
 
     // the two paths from the two sources propagate until the two paths meet each other
     while (!is_adjacent) {
-        // each iteration gets an element from the priority queue
-        auto const next{priority_queue.top()};
-        priority_queue.pop();
+        // each iteration gets the node with the smallest cost from both the sources
+        auto const next      = workspace.pop();
         auto const q_next_id = next.get_id();
-        auto& q_next         = _device.get_physical_qubit(q_next_id);
         // FIXME - swtch to source
-        assert(q_next.get_source() == next.get_source());
+        assert(workspace.get_source(q_next_id) == next.get_source());
 
         // mark the element as visited and check its neighbors
         auto const cost = next.get_cost();
         assert(cost >= SWAP_DELAY);
         auto const operation_time = cost - SWAP_DELAY;
-        q_next.take_route(cost, operation_time);
-        auto const touch = _touch_adjacency(q_next, priority_queue, next.get_source());
+        workspace.take_route(q_next_id, cost, operation_time);
+        auto const touch = _touch_adjacency(q_next_id, workspace, next.get_source());
         is_adjacent      = get<0>(touch);
         if (is_adjacent) {
             if (next.get_source())  // 0 get true means touch 1's set
@@ -234,14 +297,8 @@ std::vector<GateInfo> Router::duostra_routing(qcir::QCirGate const& gate, std::t
             }
         }
     }
-    auto operation_list =
-        _traceback(gate, _device.get_physical_qubit(q0_id), _device.get_physical_qubit(q1_id), t0, t1, swap_ids);
+    auto operation_list = _traceback(gate, q0_id, q1_id, t0_id, t1_id, swap_ids, workspace);
 
-    for (size_t i = 0; i < _device.get_num_qubits(); ++i) {
-        auto& qubit = _device.get_physical_qubit(i);
-        qubit.reset();
-        assert(qubit.get_logical_qubit() < _device.get_num_qubits());
-    }
     return operation_list;
 }
 
@@ -262,7 +319,7 @@ std::vector<GateInfo> Router::apsp_routing(qcir::QCirGate const& gate, std::tupl
     auto q0_id       = s0_id;
     auto q1_id       = s1_id;
 
-    while (!_device.get_physical_qubit(q0_id).is_adjacency(_device.get_physical_qubit(q1_id))) {
+    while (!_device.is_adjacent(q0_id, q1_id)) {
         auto const [q0_next, q0_cost] = _device.get_next_swap_cost(q0_id, s1_id);
         auto const [q1_next, q1_cost] = _device.get_next_swap_cost(q1_id, s0_id);
 
@@ -282,7 +339,7 @@ std::vector<GateInfo> Router::apsp_routing(qcir::QCirGate const& gate, std::tupl
             q1_id = q1_next;
         }
     }
-    assert(_device.get_physical_qubit(q1_id).is_adjacency(_device.get_physical_qubit(q0_id)));
+    assert(_device.is_adjacent(q1_id, q0_id));
 
     auto const gate_cost = std::max(_device.get_physical_qubit(q0_id).get_occupied_time(),
                                     _device.get_physical_qubit(q1_id).get_occupied_time());
@@ -299,33 +356,30 @@ std::vector<GateInfo> Router::apsp_routing(qcir::QCirGate const& gate, std::tupl
  * @brief Find adjacencies and put into priority queue until touched
  *
  * @param qubit
- * @param pq
+ * @param workspace
  * @param source
  * @return tuple<bool, size_t>
  */
-std::tuple<bool, QubitIdType> Router::_touch_adjacency(PhysicalQubit& qubit, PriorityQueue& pq, bool source) {
+std::tuple<bool, QubitIdType> Router::_touch_adjacency(QubitIdType qubit, AStarWorkspace& workspace, bool source) const {
     // mark all the adjacent qubits as seen and push them into the priority queue
-    for (auto& i : qubit.get_adjacencies()) {
-        PhysicalQubit& adj = _device.get_physical_qubit(i);
+    for (auto const adj : _device.get_adjacencies(qubit)) {
         // see if already in the queue
-        if (adj.is_marked()) {
+        if (workspace.is_marked(adj)) {
             // see if the taken one is from different path from the original qubit
             // if yes, means the two paths meet each other
-            if (adj.is_taken()) {
+            if (workspace.is_taken(adj)) {
                 // touch target
-                if (adj.get_source() != source) {
-                    assert(adj.get_id() == i);
-                    return std::make_tuple(true, adj.get_id());
+                if (workspace.get_source(adj) != source) {
+                    return std::make_tuple(true, adj);
                 }
             }
             continue;
         }
 
         // push the node into the priority queue
-        auto const cost = std::max(qubit.get_cost(), adj.get_occupied_time()) + SWAP_DELAY;
-        adj.mark(source, qubit.get_id());
-
-        pq.push(AStarNode(cost, adj.get_id(), source));
+        auto const cost = std::max(workspace.get_cost(qubit), _device.get_physical_qubit(adj).get_occupied_time()) + SWAP_DELAY;
+        workspace.mark(adj, source, qubit);
+        workspace.push(AStarNode(cost, adj, source));
     }
     return std::make_tuple(false, max_qubit_id);
 }
@@ -333,59 +387,42 @@ std::tuple<bool, QubitIdType> Router::_touch_adjacency(PhysicalQubit& qubit, Pri
 /**
  * @brief Traceback the paths
  *
- * @param gt
- * @param ph
- * @param q0
- * @param q1
+ * @param gate
+ * @param q0 the qubit where the path from t0 ends
+ * @param q1 the qubit where the path from t1 ends
  * @param t0
  * @param t1
- * @param swapIds
- * @param swapped if the qubits of gate are swapped when added into Duostra
+ * @param swap_ids if the qubits of gate are swapped when added into Duostra
+ * @param workspace the state of the search that found the paths
  * @return vector<Operation>
  */
-std::vector<GateInfo> Router::_traceback(qcir::QCirGate const& gate, PhysicalQubit& q0, PhysicalQubit& q1, PhysicalQubit& t0, PhysicalQubit& t1, bool swap_ids) {
-    assert(t0.get_id() == t0.get_predecessor());
-    assert(t1.get_id() == t1.get_predecessor());
+std::vector<GateInfo> Router::_traceback(qcir::QCirGate const& gate, QubitIdType q0, QubitIdType q1, QubitIdType t0, QubitIdType t1, bool swap_ids, AStarWorkspace const& workspace) {
+    assert(t0 == workspace.get_predecessor(t0));
+    assert(t1 == workspace.get_predecessor(t1));
 
-    assert(q0.is_adjacency(q1));
+    assert(_device.is_adjacent(q0, q1));
     std::vector<GateInfo> operation_list;
 
-    auto const operation_time = std::max(q0.get_cost(), q1.get_cost());
+    auto const operation_time = std::max(workspace.get_cost(q0), workspace.get_cost(q1));
 
     assert(gate.get_num_qubits() == 2);
 
     // NOTE - Order of qubits in CX matters
-    auto const qids = swap_ids ? QubitIdList{q1.get_id(), q0.get_id()} : QubitIdList{q0.get_id(), q1.get_id()};
+    auto const qids = swap_ids ? QubitIdList{q1, q0} : QubitIdList{q0, q1};
 
     auto cx_gate       = qcir::QCirGate(0, gate.get_operation(), qids);
     GateInfo gate_info = {cx_gate, {operation_time, operation_time + gate.get_delay()}};
     operation_list.emplace_back(std::move(gate_info));
 
     // traceback by tracing the parent iteratively
-    auto trace0 = q0.get_id();
-    auto trace1 = q1.get_id();
-    // traceback by tracing the parent iteratively
-    // trace 0
-    while (trace0 != t0.get_id()) {
-        auto const& q_trace0   = _device.get_physical_qubit(trace0);
-        auto const trace_pred0 = q_trace0.get_predecessor();
-
-        auto const swap_time = q_trace0.get_swap_time();
-        auto op              = qcir::QCirGate(0, SwapGate{}, QubitIdList{trace0, trace_pred0});
-        GateInfo gate_info   = {op, {swap_time, swap_time + SWAP_DELAY}};
-        operation_list.emplace_back(std::move(gate_info));
-        trace0 = trace_pred0;
-    }
-    while (trace1 != t1.get_id())  // trace 1
-    {
-        auto& q_trace1         = _device.get_physical_qubit(trace1);
-        auto const trace_pred1 = q_trace1.get_predecessor();
-
-        auto const swap_time = q_trace1.get_swap_time();
-        auto op              = qcir::QCirGate(0, SwapGate{}, QubitIdList{trace1, trace_pred1});
-        GateInfo gate_info   = {op, {swap_time, swap_time + SWAP_DELAY}};
-        operation_list.emplace_back(std::move(gate_info));
-        trace1 = trace_pred1;
+    for (auto const& [trace, target] : {std::pair{q0, t0}, std::pair{q1, t1}}) {
+        for (auto curr = trace; curr != target;) {
+            auto const pred      = workspace.get_predecessor(curr);
+            auto const swap_time = workspace.get_swap_time(curr);
+            auto op              = qcir::QCirGate(0, SwapGate{}, QubitIdList{curr, pred});
+            operation_list.push_back({op, {swap_time, swap_time + SWAP_DELAY}});
+            curr = pred;
+        }
     }
     // REVIEW - Check time, now the start time
     std::ranges::sort(operation_list, [](GateInfo const& a, GateInfo const& b) -> bool {
@@ -416,17 +453,50 @@ std::vector<GateInfo> Router::assign_gate(qcir::QCirGate const& gate) {
         _duostra
             ? duostra_routing(gate, physical_qubits_ids, _tie_breaking_strategy)
             : apsp_routing(gate, physical_qubits_ids, _tie_breaking_strategy);
-    auto const change_list = _device.mapping();
 
-    // i is the idx of device qubit
-    for (size_t i = 0; i < change_list.size(); ++i) {
-        auto logical_qubit_id = change_list[i];
-        if (logical_qubit_id == std::nullopt) {
-            continue;
+    // only the qubits touched by the operations may have changed their logical qubits
+    for (auto const& [op, _] : operation_list) {
+        for (auto const physical_id : op.get_qubits()) {
+            if (auto const logical_id = _device.get_physical_qubit(physical_id).get_logical_qubit(); logical_id.has_value()) {
+                _logical_to_physical.set(*logical_id, physical_id);
+            }
         }
-        _logical_to_physical[logical_qubit_id.value()] = i;
     }
     return operation_list;
 }
 
+/**
+ * @brief Swap the logical qubits on two adjacent physical qubits as soon as both are free
+ *
+ * @param q0
+ * @param q1
+ * @return GateInfo the SWAP operation
+ */
+GateInfo Router::apply_swap(QubitIdType q0, QubitIdType q1) {
+    assert(_device.is_adjacent(q0, q1));
+    auto const swap_time = std::max(_device.get_physical_qubit(q0).get_occupied_time(), _device.get_physical_qubit(q1).get_occupied_time());
+    auto op              = qcir::QCirGate(0, SwapGate{}, QubitIdList{q0, q1});
+    _device.apply_gate(op, swap_time);
+
+    for (auto const physical_id : {q0, q1}) {
+        if (auto const logical_id = _device.get_physical_qubit(physical_id).get_logical_qubit(); logical_id.has_value()) {
+            _logical_to_physical.set(*logical_id, physical_id);
+        }
+    }
+    return {op, {swap_time, swap_time + SWAP_DELAY}};
+}
+
+/**
+ * @brief Replace the placement of the logical qubits. Every physical qubit must be assigned.
+ *
+ * @param logical_to_physical the physical qubit of each logical qubit
+ */
+void Router::place(std::vector<QubitIdType> const& logical_to_physical) {
+    assert(logical_to_physical.size() == _device.get_num_qubits());
+    for (size_t i = 0; i < logical_to_physical.size(); ++i) {
+        _device.set_logical_qubit(logical_to_physical[i], i);
+    }
+    _logical_to_physical = dvlab::utils::DeltaVector<QubitIdType>{logical_to_physical};
+}
+
 }  // namespace qsyn::duostra
@@ -8,12 +8,14 @@
 
 #pragma once
 
-#include <queue>
+#include <cstdint>
+#include <vector>
 
 #include "./duostra_def.hpp"
 #include "device/device.hpp"
 #include "qcir/qcir_gate.hpp"
 #include "qsyn/qsyn_type.hpp"
+#include "util/delta_vector.hpp"
 
 namespace qsyn::duostra {
 
@@ -34,13 +36,48 @@ private:
 
 class AStarComp {
 public:
-    bool operator()(AStarNode const& a, AStarNode const& b) {
+    bool operator()(AStarNode const& a, AStarNode const& b) const {
         if (a._estimated_cost == b._estimated_cost)
             return a._id > b._id;
         return a._estimated_cost > b._estimated_cost;
     }
 };
 
+/**
+ * @brief The scratch state of the bidirectional search in Router::duostra_routing, stored as one array per field.
+ *        A qubit is marked in the current search iff its stamp equals the epoch, so starting a new search bumps the epoch
+ *        instead of clearing the arrays, and each search only costs time in the region it explores.
+ *        The arrays and the heap keep their capacity across searches.
+ *
+ */
+class AStarWorkspace {
+public:
+    void start(size_t num_qubits);
+
+    bool is_marked(QubitIdType q) const { return _stamps[q] == _epoch; }
+    bool is_taken(QubitIdType q) const { return _taken[q]; }
+    bool get_source(QubitIdType q) const { return _sources[q]; }
+    QubitIdType get_predecessor(QubitIdType q) const { return _predecessors[q]; }
+    size_t get_cost(QubitIdType q) const { return _costs[q]; }
+    size_t get_swap_time(QubitIdType q) const { return _swap_times[q]; }
+
+    void mark(QubitIdType q, bool source, QubitIdType pred);
+    void take_route(QubitIdType q, size_t cost, size_t swap_time);
+
+    void push(AStarNode const& node);
+    AStarNode pop();
+
+private:
+    std::uint32_t _epoch = 0;
+    std::vector<std::uint32_t> _stamps;
+    std::vector<std::uint8_t> _sources;  // false: from q0, true: from q1
+    std::vector<std::uint8_t> _taken;
+    std::vector<QubitIdType> _predecessors;
+    std::vector<size_t> _costs;
+    std::vector<size_t> _swap_times;
+    std::vector<AStarNode> _heap;  // a binary heap that pops the node with the smallest cost first
+};
+
 class Router {
 public:
     using Device        = qsyn::device::Device;
@@ -51,7 +88,6 @@ public:
         end
     };
 
-    using PriorityQueue = std::priority_queue<AStarNode, std::vector<AStarNode>, AStarComp>;
     Router(Device device, CostStrategyType cost_strategy, MinMaxOptionType tie_breaking_strategy);
 
     std::unique_ptr<Router> clone() const;
@@ -67,19 +103,21 @@ public:
     std::vector<GateInfo> duostra_routing(qcir::QCirGate const& gate, std::tuple<QubitIdType, QubitIdType> qubit_pair, MinMaxOptionType tie_breaking_strategy);
     std::vector<GateInfo> apsp_routing(qcir::QCirGate const& gate, std::tuple<QubitIdType, QubitIdType> qs, MinMaxOptionType tie_breaking_strategy);
     std::vector<GateInfo> assign_gate(qcir::QCirGate const& gate);
+    GateInfo apply_swap(QubitIdType q0, QubitIdType q1);
+    void place(std::vector<QubitIdType> const& logical_to_physical);
 
 private:
     MinMaxOptionType _tie_breaking_strategy;
     Device _device;
-    std::vector<QubitIdType> _logical_to_physical;
+    dvlab::utils::DeltaVector<QubitIdType> _logical_to_physical;  // shares its unchanged entries with the router it is cloned from
     bool _apsp : 1;
     bool _duostra : 1;
 
     void _initialize();
     std::tuple<QubitIdType, QubitIdType> _get_physical_qubits(qcir::QCirGate const& gate) const;
 
-    std::tuple<bool, QubitIdType> _touch_adjacency(PhysicalQubit& qubit, PriorityQueue& pq, bool source);  // return <if touch target, target id>, swtch: false q0 propagate, true q1 propagate
-    std::vector<GateInfo> _traceback(qcir::QCirGate const& gate, PhysicalQubit& q0, PhysicalQubit& q1, PhysicalQubit& t0, PhysicalQubit& t1, bool swap_ids);
+    std::tuple<bool, QubitIdType> _touch_adjacency(QubitIdType qubit, AStarWorkspace& workspace, bool source) const;  // return <if touch target, target id>, swtch: false q0 propagate, true q1 propagate
+    std::vector<GateInfo> _traceback(qcir::QCirGate const& gate, QubitIdType q0, QubitIdType q1, QubitIdType t0, QubitIdType t1, bool swap_ids, AStarWorkspace const& workspace);
 };
 
 }  // namespace qsyn::duostra
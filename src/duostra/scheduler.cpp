@@ -24,9 +24,10 @@ namespace qsyn::duostra {
  * @param typ
  * @param topo
  * @param tqdm
+ * @param n_jobs number of threads to evaluate the search tree on, 0: all hardware threads. Only used by the search scheduler
  * @return unique_ptr<BaseScheduler>
  */
-std::unique_ptr<BaseScheduler> get_scheduler(std::unique_ptr<CircuitTopology> topo, bool tqdm) {
+std::unique_ptr<BaseScheduler> get_scheduler(std::unique_ptr<CircuitTopology> topo, bool tqdm, size_t n_jobs) {
     // 0:base 1:static 2:random 3:greedy 4:search
     if (DuostraConfig::SCHEDULER_TYPE == SchedulerType::random) {
         return std::make_unique<RandomScheduler>(*topo, tqdm);
@@ -35,7 +36,9 @@ std::unique_ptr<BaseScheduler> get_scheduler(std::unique_ptr<CircuitTopology> to
     } else if (DuostraConfig::SCHEDULER_TYPE == SchedulerType::greedy) {
         return std::make_unique<GreedyScheduler>(*topo, tqdm);
     } else if (DuostraConfig::SCHEDULER_TYPE == SchedulerType::search) {
-        return std::make_unique<SearchScheduler>(*topo, tqdm);
+        return std::make_unique<SearchScheduler>(*topo, tqdm, n_jobs);
+    } else if (DuostraConfig::SCHEDULER_TYPE == SchedulerType::sabre) {
+        return std::make_unique<SabreScheduler>(*topo, tqdm);
     } else if (DuostraConfig::SCHEDULER_TYPE == SchedulerType::base) {
         return std::make_unique<BaseScheduler>(*topo, tqdm);
     }
@@ -44,6 +44,7 @@ public:
     std::optional<size_t> get_executable_gate(Router& router) const;
     size_t get_operations_cost() const;
     bool is_sorted() const { return _sorted; }
+    bool has_failed() const { return _failed; }
     std::vector<size_t> const& get_available_gates() const { return _circuit_topology.get_available_gates(); }
     std::vector<GateInfo> const& get_operations() const { return _operations; }
 
@@ -54,6 +55,7 @@ protected:
     CircuitTopology _circuit_topology;
     std::vector<GateInfo> _operations;
     bool _sorted = false;
+    bool _failed = false;
     bool _tqdm   = true;
     virtual Device _assign_gates(std::unique_ptr<Router> router);
     void _sort();
@@ -155,8 +157,8 @@ public:
     bool is_leaf() const { return _children.empty(); }
     bool can_grow() const { return !scheduler().get_available_gates().empty(); }
 
-    TreeNode best_child(size_t depth);
-    size_t best_cost(size_t depth);
+    TreeNode best_child(size_t depth, size_t n_jobs = 1);
+    size_t best_cost(size_t depth, size_t n_jobs = 1);
     size_t best_cost() const;
 
     Router const& router() const { return *_router; }
@@ -182,6 +184,7 @@ private:
     std::unique_ptr<BaseScheduler> _scheduler;
 
     void _grow();
+    std::vector<size_t> _children_costs(size_t depth, size_t n_children, size_t n_jobs);
     std::optional<size_t> _immediate_next() const;
     void _route_internal_gates();
 };
@@ -189,7 +192,7 @@ private:
 class SearchScheduler : public GreedyScheduler {  // NOLINT(hicpp-special-member-functions, cppcoreguidelines-special-member-functions) : copy-swap idiom
 public:
     using Device = GreedyScheduler::Device;
-    SearchScheduler(CircuitTopology const& topo, bool tqdm = true);
+    SearchScheduler(CircuitTopology const& topo, bool tqdm = true, size_t n_jobs = DuostraConfig::NUM_THREADS);
 
     std::unique_ptr<BaseScheduler> clone() const override;
 
@@ -197,11 +200,33 @@ protected:
     bool _never_cache;
     bool _execute_single;
     size_t _lookahead;
+    size_t _n_jobs;
 
     Device _assign_gates(std::unique_ptr<Router> /*unused*/) override;
     void _cache_when_necessary();
 };
 
-std::unique_ptr<BaseScheduler> get_scheduler(std::unique_ptr<CircuitTopology> topo, bool tqdm = true);
+/**
+ * @brief A SABRE-style scheduler: it inserts the SWAP that most reduces the distances of the front layer and of an extended set of upcoming gates,
+ *        and refines the initial placement by routing the circuit forward and backward. The swap scores are updated incrementally,
+ *        so that the time per SWAP does not grow with the circuit.
+ *
+ */
+class SabreScheduler : public BaseScheduler {
+public:
+    using Device = BaseScheduler::Device;
+    SabreScheduler(CircuitTopology const& topo, bool tqdm);
+
+    std::unique_ptr<BaseScheduler> clone() const override;
+
+protected:
+    size_t _extended_set_size;
+    double _extended_set_weight;
+    size_t _num_iterations;
+
+    Device _assign_gates(std::unique_ptr<Router> router) override;
+};
+
+std::unique_ptr<BaseScheduler> get_scheduler(std::unique_ptr<CircuitTopology> topo, bool tqdm = true, size_t n_jobs = DuostraConfig::NUM_THREADS);
 
 }  // namespace qsyn::duostra
@@ -0,0 +1,481 @@
+/****************************************************************************
+  PackageName  [ duostra ]
+  Synopsis     [ Define class SABRE Scheduler member functions ]
+  Author       [ Design Verification Lab ]
+  Paper        [ https://arxiv.org/abs/1809.02573 ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "./scheduler.hpp"
+#include "util/util.hpp"
+
+extern bool stop_requested();
+
+namespace qsyn::duostra {
+
+namespace {
+
+constexpr double decay_increment    = 0.001;  // the decay of a physical qubit grows by this much every time it is swapped
+constexpr size_t decay_reset_period = 5;      // the decays are reset after this many SWAPs, or when a gate is executed
+
+/**
+ * @brief One SABRE routing pass over a circuit topology. The pass keeps its own placement and reports every gate it executes and every SWAP it inserts,
+ *        so that it serves both the trial passes that only refine the placement and the final pass that emits the operations.
+ *
+ *        The swap score is a weighted sum of the distances of the gates in the front layer and in the extended set. Both sums are kept up to date,
+ *        and each logical qubit knows its partners in both sets, so that scoring a SWAP only touches the gates on the two swapped qubits.
+ */
+class SabrePass {
+public:
+    using Device = qsyn::device::Device;
+
+    SabrePass(Device const& device, CircuitTopology& topo, std::vector<QubitIdType> logical_to_physical, size_t extended_set_size, double extended_set_weight);
+
+    template <typename OnExecute, typename OnSwap>
+    bool run(OnExecute&& on_execute, OnSwap&& on_swap);
+
+    std::vector<QubitIdType> const& get_logical_to_physical() const { return _logical_to_physical; }
+
+private:
+    using Delta = std::pair<std::int64_t, std::int64_t>;  // the changes of the front-layer and extended-set distance sums
+
+    Device const& _device;
+    CircuitTopology& _topo;
+    size_t _extended_set_size;
+    double _extended_set_weight;
+
+    std::vector<QubitIdType> _logical_to_physical;
+    std::vector<QubitIdType> _physical_to_logical;
+
+    // NOTE - the front layer: the available two-qubit gates whose qubits are not adjacent
+    std::vector<size_t> _front_gates;          // _front_gates[l] = the gate of logical qubit l in the front layer, or SIZE_MAX
+    std::vector<QubitIdType> _front_partners;  // _front_partners[l] = the other qubit of that gate, or max_qubit_id
+    size_t _front_size           = 0;
+    std::int64_t _front_distance = 0;
+
+    // NOTE - the extended set: the upcoming two-qubit gates beyond the front layer
+    std::vector<std::vector<QubitIdType>> _extended_partners;  // _extended_partners[l] = the other qubits of l's gates in the extended set
+    std::vector<QubitIdType> _extended_qubits;                 // the logical qubits with any partner in the extended set
+    std::vector<size_t> _extended_gates;
+    std::int64_t _extended_distance = 0;
+    bool _extended_set_dirty        = true;
+
+    std::vector<double> _decays;        // indexed by physical qubits
+    std::vector<QubitIdType> _decayed;  // the physical qubits whose decay may not be 1
+    size_t _swaps_since_reset = 0;
+
+    std::vector<size_t> _executable;  // the available gates that are ready to execute on the current placement
+
+    std::int64_t _distance(QubitIdType p0, QubitIdType p1) const { return static_cast<std::int64_t>(_device.get_distance(p0, p1)); }
+    std::int64_t _logical_distance(QubitIdType l0, QubitIdType l1) const { return _distance(_logical_to_physical[l0], _logical_to_physical[l1]); }
+
+    void _add_available_gate(size_t gate_idx);
+    void _remove_front_gate(QubitIdType logical);
+    template <typename OnExecute>
+    void _execute_all(OnExecute&& on_execute);
+
+    void _rebuild_extended_set();
+    void _add_extended_gate(size_t gate_idx);
+
+    Delta _get_swap_delta(QubitIdType p0, QubitIdType p1) const;
+    double _get_swap_score(QubitIdType p0, QubitIdType p1) const;
+    std::pair<QubitIdType, QubitIdType> _choose_swap() const;
+    template <typename OnSwap>
+    void _apply_swap(QubitIdType p0, QubitIdType p1, OnSwap&& on_swap);
+    void _reset_decays();
+
+    size_t _get_closest_front_gate() const;
+    template <typename OnSwap>
+    bool _release_closest_front_gate(OnSwap&& on_swap);
+};
+
+SabrePass::SabrePass(Device const& device, CircuitTopology& topo, std::vector<QubitIdType> logical_to_physical, size_t extended_set_size, double extended_set_weight)
+    : _device(device),
+      _topo(topo),
+      _extended_set_size(extended_set_size),
+      _extended_set_weight(extended_set_weight),
+      _logical_to_physical(std::move(logical_to_physical)),
+      _physical_to_logical(_logical_to_physical.size()),
+      _front_gates(_logical_to_physical.size(), SIZE_MAX),
+      _front_partners(_logical_to_physical.size(), max_qubit_id),
+      _extended_partners(_logical_to_physical.size()),
+      _decays(_logical_to_physical.size(), 1.0) {
+    for (size_t i = 0; i < _logical_to_physical.size(); ++i) {
+        _physical_to_logical[_logical_to_physical[i]] = i;
+    }
+    for (auto const gate_idx : _topo.get_available_gates()) {
+        _add_available_gate(gate_idx);
+    }
+}
+
+/**
+ * @brief Route all the gates of the topology
+ *
+ * @param on_execute called with the id of each gate, right before it is executed
+ * @param on_swap called with the physical qubits of each SWAP, right after it is applied
+ * @return false if interrupted, or if a gate acts on qubits that are not connected on the device
+ */
+template <typename OnExecute, typename OnSwap>
+bool SabrePass::run(OnExecute&& on_execute, OnSwap&& on_swap) {
+    size_t num_stalled_swaps = 0;  // the number of SWAPs since a gate is executed
+    size_t release_threshold = 0;
+    while (!_topo.get_available_gates().empty()) {
+        if (stop_requested()) return false;
+
+        if (!_executable.empty()) {
+            _execute_all(on_execute);
+            num_stalled_swaps = 0;
+            continue;
+        }
+        if (_extended_set_dirty) _rebuild_extended_set();
+
+        // the scores may cycle without executing any gate; if the SWAPs wander too long, route the closest gate along a shortest path
+        // if even the closest gate is unreachable, no SWAP helps, so it is released at once to report the error
+        if (num_stalled_swaps == 0) {
+            auto const closest  = _topo.get_gate_qubits(_get_closest_front_gate());
+            auto const distance = static_cast<size_t>(_logical_distance(closest[0], closest[1]));
+            release_threshold   = distance >= Device::default_max_dist ? 0 : 10 + 3 * distance;
+        }
+        if (num_stalled_swaps >= release_threshold) {
+            if (!_release_closest_front_gate(on_swap)) return false;
+            continue;
+        }
+
+        auto const [p0, p1] = _choose_swap();
+        _apply_swap(p0, p1, on_swap);
+        ++num_stalled_swaps;
+    }
+    return true;
+}
+
+/**
+ * @brief Put a newly available gate into the front layer, or into the executable gates if its qubits are adjacent
+ *
+ * @param gate_idx
+ */
+void SabrePass::_add_available_gate(size_t gate_idx) {
+    auto const qubits = _topo.get_gate_qubits(gate_idx);
+    if (qubits.size() != 2) {
+        _executable.emplace_back(gate_idx);
+        return;
+    }
+    auto const distance = _logical_distance(qubits[0], qubits[1]);
+    if (distance == 1) {
+        _executable.emplace_back(gate_idx);
+        return;
+    }
+    _front_gates[qubits[0]]    = gate_idx;
+    _front_gates[qubits[1]]    = gate_idx;
+    _front_partners[qubits[0]] = qubits[1];
+    _front_partners[qubits[1]] = qubits[0];
+    ++_front_size;
+    _front_distance += distance;
+}
+
+/**
+ * @brief Move the front-layer gate on `logical` to the executable gates. Its qubits must be adjacent.
+ *
+ * @param logical
+ */
+void SabrePass::_remove_front_gate(QubitIdType logical) {
+    auto const partner = _front_partners[logical];
+    assert(_logical_distance(logical, partner) == 1);
+    _executable.emplace_back(_front_gates[logical]);
+    _front_gates[logical]    = SIZE_MAX;
+    _front_gates[partner]    = SIZE_MAX;
+    _front_partners[logical] = max_qubit_id;
+    _front_partners[partner] = max_qubit_id;
+    --_front_size;
+    _front_distance -= 1;
+}
+
+/**
+ * @brief Execute the executable gates, and the gates that become executable after them
+ *
+ * @param on_execute
+ */
+template <typename OnExecute>
+void SabrePass::_execute_all(OnExecute&& on_execute) {
+    // _executable grows as the successors of the executed gates become available
+    for (size_t i = 0; i < _executable.size(); ++i) {
+        auto const gate_idx = _executable[i];
+        on_execute(gate_idx);
+        // CircuitTopology erases the executed gate and appends the new available gates
+        auto const first_new = _topo.get_available_gates().size() - 1;
+        _topo.update_available_gates(gate_idx);
+        auto const& available = _topo.get_available_gates();
+        for (auto j = first_new; j < available.size(); ++j) {
+            _add_available_gate(available[j]);
+        }
+    }
+    _executable.clear();
+    _extended_set_dirty = true;
+    _reset_decays();
+}
+
+/**
+ * @brief Collect the extended set by walking the qubits of the front layer in lockstep, until the set is full or the circuit ends
+ *
+ */
+void SabrePass::_rebuild_extended_set() {
+    for (auto const logical : _extended_qubits) {
+        _extended_partners[logical].clear();
+    }
+    _extended_qubits.clear();
+    _extended_gates.clear();
+    _extended_distance  = 0;
+    _extended_set_dirty = false;
+
+    auto const& front = _topo.get_available_gates();
+    for (size_t depth = 1; _extended_gates.size() < _extended_set_size; ++depth) {
+        auto reached = false;
+        for (auto const gate_idx : front) {
+            for (auto const qubit : _topo.get_gate_qubits(gate_idx)) {
+                auto const pending = _topo.get_pending_gates(qubit);
+                if (depth >= pending.size()) continue;
+                reached = true;
+                if (_topo.get_gate_qubits(pending[depth]).size() == 2 && !dvlab::contains(_extended_gates, pending[depth])) {
+                    _add_extended_gate(pending[depth]);
+                    if (_extended_gates.size() == _extended_set_size) return;
+                }
+            }
+        }
+        if (!reached) return;
+    }
+}
+
+void SabrePass::_add_extended_gate(size_t gate_idx) {
+    auto const qubits = _topo.get_gate_qubits(gate_idx);
+    for (auto const& [q, partner] : {std::pair{qubits[0], qubits[1]}, std::pair{qubits[1], qubits[0]}}) {
+        if (_extended_partners[q].empty()) _extended_qubits.emplace_back(q);
+        _extended_partners[q].emplace_back(partner);
+    }
+    _extended_gates.emplace_back(gate_idx);
+    _extended_distance += _logical_distance(qubits[0], qubits[1]);
+}
+
+/**
+ * @brief Get the changes of the distance sums if the logical qubits on two physical qubits are swapped
+ *
+ * @param p0
+ * @param p1
+ * @return Delta
+ */
+SabrePass::Delta SabrePass::_get_swap_delta(QubitIdType p0, QubitIdType p1) const {
+    auto delta = Delta{0, 0};
+    // the logical qubit on `from` moves to `to`, while `other` moves the opposite way; gates between the two keep their distances
+    auto const add_move = [&](QubitIdType from, QubitIdType to) {
+        auto const logical = _physical_to_logical[from];
+        auto const other   = _physical_to_logical[to];
+        if (auto const partner = _front_partners[logical]; partner != max_qubit_id && partner != other) {
+            auto const p = _logical_to_physical[partner];
+            delta.first += _distance(to, p) - _distance(from, p);
+        }
+        for (auto const partner : _extended_partners[logical]) {
+            if (partner == other) continue;
+            auto const p = _logical_to_physical[partner];
+            delta.second += _distance(to, p) - _distance(from, p);
+        }
+    };
+    add_move(p0, p1);
+    add_move(p1, p0);
+    return delta;
+}
+
+/**
+ * @brief Get the SABRE score of swapping two physical qubits. The lower, the better.
+ *
+ */
+double SabrePass::_get_swap_score(QubitIdType p0, QubitIdType p1) const {
+    auto const [front_delta, extended_delta] = _get_swap_delta(p0, p1);
+    auto score                               = static_cast<double>(_front_distance + front_delta) / static_cast<double>(_front_size);
+    if (!_extended_gates.empty()) {
+        score += _extended_set_weight * static_cast<double>(_extended_distance + extended_delta) / static_cast<double>(_extended_gates.size());
+    }
+    return std::max(_decays[p0], _decays[p1]) * score;
+}
+
+/**
+ * @brief Choose the best SWAP among the couplings on the qubits of the front layer. Ties are broken by the order they are found.
+ *
+ * @return std::pair<QubitIdType, QubitIdType>
+ */
+std::pair<QubitIdType, QubitIdType> SabrePass::_choose_swap() const {
+    auto best       = std::pair{max_qubit_id, max_qubit_id};
+    auto best_score = std::numeric_limits<double>::max();
+    for (auto const gate_idx : _topo.get_available_gates()) {
+        for (auto const qubit : _topo.get_gate_qubits(gate_idx)) {
+            auto const physical = _logical_to_physical[qubit];
+            for (auto const adj : _device.get_adjacencies(physical)) {
+                if (auto const score = _get_swap_score(physical, adj); score < best_score) {
+                    best_score = score;
+                    best       = {physical, adj};
+                }
+            }
+        }
+    }
+    assert(best.first != max_qubit_id);
+    return best;
+}
+
+/**
+ * @brief Swap the logical qubits on two adjacent physical qubits and move the front-layer gates that become executable
+ *
+ */
+template <typename OnSwap>
+void SabrePass::_apply_swap(QubitIdType p0, QubitIdType p1, OnSwap&& on_swap) {
+    auto const [front_delta, extended_delta] = _get_swap_delta(p0, p1);
+    _front_distance += front_delta;
+    _extended_distance += extended_delta;
+
+    auto const l0 = _physical_to_logical[p0];
+    auto const l1 = _physical_to_logical[p1];
+    std::swap(_physical_to_logical[p0], _physical_to_logical[p1]);
+    _logical_to_physical[l0] = p1;
+    _logical_to_physical[l1] = p0;
+    on_swap(p0, p1);
+
+    for (auto const p : {p0, p1}) {
+        _decays[p] += decay_increment;
+        _decayed.emplace_back(p);
+    }
+    if (++_swaps_since_reset == decay_reset_period) _reset_decays();
+
+    for (auto const logical : {l0, l1}) {
+        if (auto const partner = _front_partners[logical]; partner != max_qubit_id && _logical_distance(logical, partner) == 1) {
+            _remove_front_gate(logical);
+        }
+    }
+}
+
+void SabrePass::_reset_decays() {
+    for (auto const p : _decayed) {
+        _decays[p] = 1.0;
+    }
+    _decayed.clear();
+    _swaps_since_reset = 0;
+}
+
+/**
+ * @brief Get the front-layer gate with the shortest distance. Ties are broken by the order of the available gates.
+ *
+ * @return size_t
+ */
+size_t SabrePass::_get_closest_front_gate() const {
+    auto const& front = _topo.get_available_gates();
+    return std::ranges::min(front, {}, [this](size_t gate_idx) {
+        auto const qubits = _topo.get_gate_qubits(gate_idx);
+        return _logical_distance(qubits[0], qubits[1]);
+    });
+}
+
+/**
+ * @brief Move the first qubit of the closest front-layer gate along a shortest path until the gate becomes executable
+ *
+ * @param on_swap
+ * @return false if the qubits of the gate are not connected on the device
+ */
+template <typename OnSwap>
+bool SabrePass::_release_closest_front_gate(OnSwap&& on_swap) {
+    auto const gate_idx = _get_closest_front_gate();
+    auto const qubits   = _topo.get_gate_qubits(gate_idx);
+    auto const moving   = qubits[0];
+    auto const target   = qubits[1];
+    while (_front_gates[moving] == gate_idx) {
+        auto const physical = _logical_to_physical[moving];
+        auto const goal     = _logical_to_physical[target];
+        auto const distance = _distance(physical, goal);
+        auto const next     = std::ranges::find_if(_device.get_adjacencies(physical), [&](QubitIdType adj) { return _distance(adj, goal) + 1 == distance; });
+        if (next == _device.get_adjacencies(physical).end()) {
+            spdlog::error("Cannot route gate {}: physical qubits {} and {} are not connected!!", gate_idx, physical, goal);
+            return false;
+        }
+        _apply_swap(physical, *next, on_swap);
+    }
+    return true;
+}
+
+}  // namespace
+
+// SECTION - Class SabreScheduler Member Functions
+
+/**
+ * @brief Construct a new Sabre Scheduler:: Sabre Scheduler object
+ *
+ * @param topo
+ * @param tqdm
+ */
+SabreScheduler::SabreScheduler(CircuitTopology const& topo, bool tqdm)
+    : BaseScheduler(topo, tqdm),
+      _extended_set_size(DuostraConfig::SABRE_EXTENDED_SET_SIZE),
+      _extended_set_weight(DuostraConfig::SABRE_EXTENDED_SET_WEIGHT),
+      _num_iterations(DuostraConfig::SABRE_ITERATIONS) {}
+
+/**
+ * @brief Clone scheduler
+ *
+ * @return unique_ptr<BaseScheduler>
+ */
+std::unique_ptr<BaseScheduler> SabreScheduler::clone() const {
+    return std::make_unique<SabreScheduler>(*this);
+}
+
+/**
+ * @brief Assign gates. The placement of the router is first refined by routing the circuit forward and backward without recording the operations,
+ *        then the circuit is routed forward from the refined placement.
+ *
+ * @param router
+ * @return Device
+ */
+SabreScheduler::Device SabreScheduler::_assign_gates(std::unique_ptr<Router> router) {
+    auto& device = router->get_device();
+    device.calculate_path();
+
+    std::vector<QubitIdType> logical_to_physical(device.get_num_qubits());
+    for (size_t i = 0; i < device.get_num_qubits(); ++i) {
+        auto const logical = device.get_physical_qubit(i).get_logical_qubit();
+        assert(logical.has_value());
+        logical_to_physical[*logical] = i;
+    }
+
+    auto const reversed_topology = _circuit_topology.reversed();
+    for (size_t i = 0; i < _num_iterations; ++i) {
+        for (auto const* topology : std::array<CircuitTopology const*, 2>{&_circuit_topology, &reversed_topology}) {
+            auto trial_topology = *topology;
+            auto pass           = SabrePass(device, trial_topology, std::move(logical_to_physical), _extended_set_size, _extended_set_weight);
+            if (!pass.run([](size_t) {}, [](QubitIdType, QubitIdType) {})) {
+                _failed = !stop_requested();
+                return router->get_device();
+            }
+            logical_to_physical = pass.get_logical_to_physical();
+        }
+    }
+    router->place(logical_to_physical);
+
+    dvlab::TqdmWrapper bar{_circuit_topology.get_num_gates(), _tqdm};
+    auto pass = SabrePass(device, _circuit_topology, std::move(logical_to_physical), _extended_set_size, _extended_set_weight);
+    auto const success = pass.run(
+        [&](size_t gate_idx) {
+            auto const ops = router->assign_gate(_circuit_topology.get_gate(gate_idx));
+            _operations.insert(_operations.end(), ops.begin(), ops.end());
+            ++bar;
+        },
+        [&](QubitIdType p0, QubitIdType p1) {
+            _operations.emplace_back(router->apply_swap(p0, p1));
+        });
+    _failed = !success && !stop_requested();
+    return router->get_device();
+}
+
+}  // namespace qsyn::duostra
@@ -6,13 +6,11 @@
   Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
 ****************************************************************************/
 
-#include <omp.h>
-
 #include <algorithm>
-#include <tl/enumerate.hpp>
 #include <vector>
 
 #include "./scheduler.hpp"
+#include "util/parallel.hpp"
 #include "util/util.hpp"
 
 extern bool stop_requested();
@@ -131,24 +129,41 @@ void TreeNode::_route_internal_gates() {
 }
 
 /**
- * @brief Get best child
+ * @brief Evaluate best_cost(depth) of the first `n_children` children on up to `n_jobs` threads.
+ *        The subtrees own their routers and schedulers, so they are evaluated independently.
+ *        The threads are split among the children, so new threads are only spawned near the root
+ *        and the leaves are always evaluated sequentially.
+ *
+ * @param depth
+ * @param n_children
+ * @param n_jobs
+ * @return std::vector<size_t> the cost of each child
+ */
+std::vector<size_t> TreeNode::_children_costs(size_t depth, size_t n_children, size_t n_jobs) {
+    assert(n_children <= _children.size());
+    auto costs = std::vector<size_t>(n_children, SIZE_MAX);
+    if (n_children == 0) return costs;
+
+    auto const child_jobs = std::max(size_t{1}, n_jobs / n_children);
+    dvlab::utils::parallel_for(
+        n_children, [&](size_t i) { costs[i] = _children[i].best_cost(depth, child_jobs); },
+        depth > 1 ? n_jobs : 1);
+    return costs;
+}
+
+/**
+ * @brief Get best child. Ties are broken by the order of the children, regardless of the number of threads.
  *
  * @param depth
+ * @param n_jobs number of threads to evaluate the children on
  * @return TreeNode
  */
-TreeNode TreeNode::best_child(size_t depth) {
+TreeNode TreeNode::best_child(size_t depth, size_t n_jobs) {
     if (is_leaf()) _grow();
+    assert(depth >= 1);
     // NOTE - best_cost(depth) is computationally expensive, so we don't use std::min_element here to avoid calling it twice.
-    size_t best_idx  = 0;
-    size_t best_cost = SIZE_MAX;
-    for (auto&& [idx, node] : tl::views::enumerate(_children)) {
-        assert(depth >= 1);
-        auto cost = node.best_cost(depth);
-        if (cost < best_cost) {
-            best_idx  = idx;
-            best_cost = cost;
-        }
-    }
+    auto const costs    = _children_costs(depth, _children.size(), n_jobs);
+    auto const best_idx = std::ranges::distance(costs.begin(), std::ranges::min_element(costs));
     return std::move(_children[best_idx]);
 }
 
@@ -156,9 +171,10 @@ TreeNode TreeNode::best_child(size_t depth) {
  * @brief Cost recursively calls children's cost, and selects the best one.
  *
  * @param depth
+ * @param n_jobs number of threads to evaluate the children on
  * @return size_t
  */
-size_t TreeNode::best_cost(size_t depth) {
+size_t TreeNode::best_cost(size_t depth, size_t n_jobs) {
     // Grow if remaining depth >= 2.
     // Terminates on leaf nodes.
     if (is_leaf()) {
@@ -176,20 +192,17 @@ size_t TreeNode::best_cost(size_t depth) {
     assert(depth > 1);
     assert(!_children.empty());
 
-    auto end = _children.end();
-    if (_conf._candidates < _children.size()) {
-        end = _children.begin() + static_cast<std::ptrdiff_t>(_conf._candidates);
-        std::nth_element(_children.begin(), end, _children.end(),
+    auto const n_candidates = std::min(_conf._candidates, _children.size());
+    if (n_candidates < _children.size()) {
+        std::nth_element(_children.begin(), _children.begin() + static_cast<std::ptrdiff_t>(n_candidates), _children.end(),
                          [](TreeNode const& a, TreeNode const& b) {
                              return a._max_cost < b._max_cost;
                          });
     }
 
     // Calculates the best cost for each children.
-    size_t best_cost = SIZE_MAX;
-    for (auto& child : _children | std::views::take(_conf._candidates)) {
-        best_cost = std::min(best_cost, child.best_cost(depth - 1));
-    }
+    auto const costs     = _children_costs(depth - 1, n_candidates, n_jobs);
+    auto const best_cost = costs.empty() ? SIZE_MAX : std::ranges::min(costs);
 
     // Clear the cache if specified.
     if (_conf._neverCache)
@@ -206,7 +219,6 @@ size_t TreeNode::best_cost(size_t depth) {
 size_t TreeNode::best_cost() const {
     size_t best = SIZE_MAX;
 
-    // #pragma omp parallel for reduction(min : best)
     for (auto& gate : scheduler().get_available_gates()) {
         TreeNode const child_node{_conf, gate, router().clone(),
                                   scheduler().clone(), _max_cost};
@@ -223,12 +235,14 @@ size_t TreeNode::best_cost() const {
  *
  * @param topo
  * @param tqdm
+ * @param n_jobs number of threads to evaluate the search tree on, 0: all hardware threads
  */
-SearchScheduler::SearchScheduler(CircuitTopology const& topo, bool tqdm)
+SearchScheduler::SearchScheduler(CircuitTopology const& topo, bool tqdm, size_t n_jobs)
     : GreedyScheduler(topo, tqdm),
       _never_cache(DuostraConfig::NEVER_CACHE),
       _execute_single(DuostraConfig::EXECUTE_SINGLE_QUBIT_GATES_ASAP),
-      _lookahead(DuostraConfig::SEARCH_DEPTH) {
+      _lookahead(DuostraConfig::SEARCH_DEPTH),
+      _n_jobs(n_jobs == 0 ? dvlab::utils::hardware_concurrency() : n_jobs) {
     _cache_when_necessary();
 }
 
@@ -273,7 +287,7 @@ SearchScheduler::Device SearchScheduler::_assign_gates(std::unique_ptr<Router> r
         if (stop_requested()) {
             return router->get_device();
         }
-        auto selected_node = std::make_unique<TreeNode>(root->best_child(static_cast<int>(_lookahead)));
+        auto selected_node = std::make_unique<TreeNode>(root->best_child(_lookahead, _n_jobs));
         root               = std::move(selected_node);
 
         for (auto const& gate_id : root->get_executed_gates()) {
@@ -685,6 +685,10 @@ Command qcir_equiv_cmd(QCirMgr& qcir_mgr) {
                 .nargs(1, 2)
                 .constraint(valid_qcir_id(qcir_mgr))
                 .help("Compare the two QCirs. If only one is specified, compare with the QCir in focus");
+
+            parser.add_argument<bool>("--normal-form")
+                .action(store_true)
+                .help("only compare the tableau normal forms of the circuits. This scales to many qubits, but may report equivalent circuits as not equivalent");
         },
         [&](ArgumentParser const& parser) {
             if (!dvlab::utils::mgr_has_data(qcir_mgr))
@@ -696,13 +700,15 @@ Command qcir_equiv_cmd(QCirMgr& qcir_mgr) {
                 (ids.size() == 1 && qcir_mgr.focused_id() == ids[0])) {
                 spdlog::info("Note: comparing the same circuit...");
             }
+            auto const check = parser.parsed("--normal-form") ? have_same_normal_form : is_equivalent;
+
             auto const is_equiv = [&]() -> bool {
                 if (ids.size() == 1) {
-                    return is_equivalent(
+                    return check(
                         *qcir_mgr.get(),
                         *qcir_mgr.find_by_id(ids[0]));
                 } else {
-                    return is_equivalent(
+                    return check(
                         *qcir_mgr.find_by_id(ids[0]),
                         *qcir_mgr.find_by_id(ids[1]));
                 }
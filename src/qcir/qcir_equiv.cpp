@@ -7,6 +7,8 @@
 
 #include "qcir/qcir_equiv.hpp"
 
+#include <optional>
+
 #include "convert/qcir_to_tableau.hpp"
 #include "convert/qcir_to_tensor.hpp"
 #include "convert/tableau_to_qcir.hpp"
@@ -16,12 +18,55 @@
 
 namespace qsyn::qcir {
 
+namespace {
+
+/**
+ * @brief Check the equivalence of two Clifford circuits. Two Clifford circuits are equivalent up to a global phase
+ *        iff they have the same stabilizer tableau, so we compare the tableaux word by word without composing the circuits.
+ *
+ * @return std::nullopt if either circuit is not made of Clifford gates
+ */
+std::optional<bool> is_clifford_equivalent(QCir const& qcir1, QCir const& qcir2) {
+    auto const tableau1 = experimental::to_packed_stabilizer_tableau(qcir1);
+    if (!tableau1) {
+        return std::nullopt;
+    }
+    auto const tableau2 = experimental::to_packed_stabilizer_tableau(qcir2);
+    if (!tableau2) {
+        return std::nullopt;
+    }
+    return *tableau1 == *tableau2;
+}
+
+}  // namespace
+
+/**
+ * @brief Check if the two circuits have the same tableau normal form, which implies that they are equivalent.
+ *        Unlike tensor contraction, this works for circuits with many qubits, but may fail to prove the equivalence.
+ *
+ */
+bool have_same_normal_form(QCir const& qcir1, QCir const& qcir2) {
+    auto tableau1 = experimental::to_tableau(qcir1);
+    auto tableau2 = experimental::to_tableau(qcir2);
+    if (!tableau1 || !tableau2) {
+        return false;
+    }
+    experimental::normalize(*tableau1);
+    experimental::normalize(*tableau2);
+    return *tableau1 == *tableau2;
+}
+
 bool is_equivalent(QCir const& qcir1, QCir const& qcir2) {
     if (qcir1.get_num_qubits() != qcir2.get_num_qubits()) {
         spdlog::info("The two circuits have different numbers of qubits.");
         return false;
     }
 
+    if (auto const result = is_clifford_equivalent(qcir1, qcir2)) {
+        spdlog::info("Both circuits are Clifford; checked equivalence by comparing their stabilizer tableaux.");
+        return *result;
+    }
+
     spdlog::info("Trying to verify equivalence via tableau optimization...");
 
     auto adjoint_composed = qcir1;
@@ -39,6 +84,11 @@ bool is_equivalent(QCir const& qcir1, QCir const& qcir2) {
         return true;
     }
 
+    spdlog::info("Trying to verify equivalence via the normal forms of the tableaux...");
+    if (have_same_normal_form(qcir1, qcir2)) {
+        return true;
+    }
+
     if (adjoint_composed.get_num_qubits() > 7) {
         spdlog::warn("The number of qubits is too large to check equivalence via tensor contraction.");
         spdlog::warn("Please note that this may be a false negative.");
@@ -13,6 +13,7 @@ namespace qsyn {
 namespace qcir {
 
 bool is_equivalent(QCir const& qcir1, QCir const& qcir2);
+bool have_same_normal_form(QCir const& qcir1, QCir const& qcir2);
 
 }
 }  // namespace qsyn
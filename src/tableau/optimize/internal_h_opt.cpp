@@ -4,6 +4,8 @@
  * @copyright Copyright(c) 2024 DVLab, GIEE, NTU, Taiwan
  */
 
+#include <algorithm>
+
 #include "../tableau_optimization.hpp"
 #include "tableau/pauli_rotation.hpp"
 #include "tableau/stabilizer_tableau.hpp"
@@ -32,13 +34,15 @@ void apply_clifford(Tableau& tableau, CliffordOperatorString const& clifford, si
 
             // suppose the Pauli rotation is R_P(θ), and the clifford is C, then we have
             // C R_P(θ) = R_P(θ) C if and only if CPC^† = P
-            auto copy_rotations = subtableau;
-            for (auto& rotation : copy_rotations) {
-                rotation.apply(clifford);
-            }
+            // conjugate one rotation at a time so that we can stop at the first one that changes
+            auto const commutes_with_clifford = [&clifford](PauliRotation const& rotation) {
+                auto copy = rotation;
+                copy.apply(clifford);
+                return copy == rotation;
+            };
 
             // Case I: some rotations does not commute with the clifford
-            if (copy_rotations != subtableau) {
+            if (!std::ranges::all_of(subtableau, commutes_with_clifford)) {
                 tableau.push_back(StabilizerTableau{n_qubits}.apply(clifford));
                 return;
             }
@@ -4,7 +4,10 @@
  * @copyright Copyright(c) 2024 DVLab, GIEE, NTU, Taiwan
  */
 
+#include <chrono>
+#include <optional>
 #include <ranges>
+#include <sul/dynamic_bitset.hpp>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -14,6 +17,7 @@
 #include "util/boolean_matrix.hpp"
 #include "util/ordered_hashmap.hpp"
 #include "util/phase.hpp"
+#include "util/reduced_echelon_basis.hpp"
 #include "util/util.hpp"
 
 extern bool stop_requested();
@@ -22,119 +26,57 @@ namespace qsyn::experimental {
 
 namespace {
 using Polynomial = std::vector<PauliRotation>;
+using Bits       = sul::dynamic_bitset<>;
 
-/**
- * @brief Get the products between rows. returns matrix[0] * matrix[1], matrix[0] * matrix[2], ... matrix[1] * matrix[2], ...
- *
- * @param a_prime
- * @return dvlab::BooleanMatrix
- */
-dvlab::BooleanMatrix get_row_products(dvlab::BooleanMatrix const& matrix) {
-    auto row_products = dvlab::BooleanMatrix();
-
-    row_products.reserve(matrix.num_rows() * (matrix.num_rows() - 1) / 2, matrix.num_cols());
-
-    for (auto const& [a, b] : dvlab::combinations<2>(std::views::iota(0ul, matrix.num_rows()) | tl::to<std::vector>())) {
-        row_products.push_row(matrix[a] * matrix[b]);
-    }
-
-    assert(row_products.num_rows() == matrix.num_rows() * (matrix.num_rows() - 1) / 2);
-
-    return row_products;
-}
+using dvlab::ReducedEchelonBasis;
 
 /**
- * @brief Get the chi matrix object
+ * @brief Tracks the time budget of a TODD run. Interrupts also exhaust the budget.
  *
- * @param row_products the products between rows generated by get_row_products
- * @param z
- * @return dvlab::BooleanMatrix
  */
-dvlab::BooleanMatrix get_chi_matrix(dvlab::BooleanMatrix const& row_products, dvlab::BooleanMatrix::Row const& z) {
-    auto chi_matrix     = dvlab::BooleanMatrix();
-    auto const num_rows = static_cast<size_t>(std::ceil(std::sqrt(row_products.num_rows() * 2)));
-
-    auto const get_row_product_idx = [&num_rows](size_t a, size_t b) {
-        if (a > b) {
-            std::swap(a, b);
-        }
-        return a * num_rows - (a * (a + 1) / 2) + b - a - 1;
-    };
-
-    auto seen_rows    = std::unordered_set<dvlab::BooleanMatrix::Row, dvlab::BooleanMatrixRowHash>();
-    auto const id_vec = std::views::iota(0ul, num_rows) | tl::to<std::vector>();
-
-    for (auto const& [a, b, c] : dvlab::combinations<3>(id_vec)) {
-        auto const new_row =
-            z[a] * row_products[get_row_product_idx(b, c)] +
-            z[b] * row_products[get_row_product_idx(a, c)] +
-            z[c] * row_products[get_row_product_idx(a, b)];
-
-        if (seen_rows.contains(new_row)) {
-            continue;
-        }
-
-        if (new_row.is_zeros()) {
-            continue;
-        }
-        seen_rows.insert(new_row);
+class ToddBudget {
+public:
+    ToddBudget(std::chrono::duration<double> time_limit)
+        : _deadline{time_limit.count() > 0
+                        ? std::optional{Clock::now() + std::chrono::duration_cast<Clock::duration>(time_limit)}
+                        : std::nullopt} {}
 
-        chi_matrix.push_row(new_row);
-    }
+    bool is_exhausted() const { return stop_requested() || (_deadline.has_value() && Clock::now() > *_deadline); }
 
-    return chi_matrix;
-}
+private:
+    using Clock = std::chrono::steady_clock;
+    std::optional<Clock::time_point> _deadline;
+};
 
 /**
- * @brief Get the nullspace of a matrix.
+ * @brief Get the coordinates of every column in a nullspace basis of the matrix.
+ *        If y_1, ..., y_k are the basis vectors, the j-th returned vector is (y_1[j], ..., y_k[j]),
+ *        so that y = sum of c_i * y_i has y[j] = coords[j] · c.
  *
- * @param matrix
- * @return dvlab::BooleanMatrix
+ * @param row_space the rows of the matrix
+ * @return std::vector<Bits> one vector of k bits per column, where k is the nullity
  */
-dvlab::BooleanMatrix get_nullspace_transposed(dvlab::BooleanMatrix const& matrix) {
-    auto augmented = hstack(dvlab::transpose(matrix), dvlab::identity(matrix.num_cols()));
-
-    auto n_rows = matrix.num_cols();
-    auto n_cols = matrix.num_rows();
-
-    auto curr_pivot = size_t{0};
-
-    for (auto const col : std::views::iota(0ul, n_cols)) {
-        if (augmented[curr_pivot][col] == 0) {
-            for (auto const row : std::views::iota(curr_pivot + 1, n_rows)) {
-                if (augmented[row][col] != 0) {
-                    augmented[curr_pivot] += augmented[row];
-                    break;
-                }
-            }
-        }
-
-        if (augmented[curr_pivot][col] == 0) {
-            continue;
-        }
-
-        for (auto const row : std::views::iota(curr_pivot + 1, n_rows)) {
-            if (augmented[row][col] != 0) {
-                augmented[row] += augmented[curr_pivot];
-            }
-        }
-
-        ++curr_pivot;
-
-        if (curr_pivot == n_rows) {
-            break;
-        }
+std::vector<Bits> get_nullspace_coordinates(ReducedEchelonBasis const& row_space) {
+    auto const n_cols = row_space.n_cols();
+    auto const nullity = n_cols - row_space.rank();
+
+    // each free column owns a basis vector, which is one on the free column and on the pivots of the rows containing it
+    auto is_pivot = std::vector<bool>(n_cols, false);
+    for (auto const& [pivot, _] : row_space.rows()) {
+        is_pivot[pivot] = true;
     }
-
-    auto nullspace = dvlab::BooleanMatrix(augmented.num_rows() - curr_pivot, augmented.num_cols() - n_cols);
-
-    for (auto const row : std::views::iota(curr_pivot, augmented.num_rows())) {
-        for (auto const col : std::views::iota(n_cols, augmented.num_cols())) {
-            nullspace[row - curr_pivot][col - n_cols] = augmented[row][col];
+    auto coords       = std::vector<Bits>(n_cols, Bits(nullity));
+    size_t free_index = 0;
+    for (size_t col = 0; col < n_cols; ++col) {
+        if (is_pivot[col]) continue;
+        coords[col].set(free_index);
+        for (auto const& [pivot, row] : row_space.rows()) {
+            if (row.test(col)) coords[pivot].set(free_index);
         }
+        ++free_index;
     }
 
-    return nullspace;
+    return coords;
 }
 
 dvlab::BooleanMatrix load_phase_poly_matrix(Polynomial const& polynomial) {
@@ -181,24 +123,63 @@ std::vector<PauliRotation> from_boolean_matrix(dvlab::BooleanMatrix const& matri
            tl::to<std::vector>();
 }
 
-Polynomial todd_once(Polynomial const& polynomial) {
+/**
+ * @brief Try to find a TODD move that reduces the number of terms.
+ *        A move on terms a and b needs a vector y with y_a != y_b in the nullspace of the phase polynomial matrix A
+ *        stacked with the chi matrix of z = A_a + A_b. The nullspace of A is computed once, and the chi matrix of each
+ *        candidate is projected onto it, so each candidate only eliminates rows of nullity(A) bits.
+ *
+ * @param polynomial
+ * @param budget
+ * @return the polynomial after the move, or the input polynomial if no move is found or the budget is exhausted
+ */
+Polynomial todd_once(Polynomial const& polynomial, ToddBudget const& budget) {
     if (polynomial.empty()) {
         return polynomial;
     }
 
     auto const n_qubits = polynomial.front().n_qubits();
+    auto const n_terms  = polynomial.size();
 
     // Each column represents a term in the phase polynomial, and each row represents a qubit.
     auto const phase_poly_matrix = load_phase_poly_matrix(polynomial);
 
-    auto seen_z        = std::unordered_set<dvlab::BooleanMatrix::Row, dvlab::BooleanMatrixRowHash>();
-    auto const idx_vec = std::views::iota(0ul, polynomial.size()) | tl::to<std::vector>();
+    auto packed_rows = std::vector<Bits>(n_qubits, Bits(n_terms));
+    auto row_space   = ReducedEchelonBasis(n_terms);
+    for (size_t i = 0; i < n_qubits; ++i) {
+        for (size_t j = 0; j < n_terms; ++j) {
+            if (phase_poly_matrix[i][j]) packed_rows[i].set(j);
+        }
+        row_space.insert(packed_rows[i]);
+    }
+
+    auto const null_coords = get_nullspace_coordinates(row_space);
+    auto const nullity     = n_terms - row_space.rank();
+    if (nullity == 0) {
+        return polynomial;
+    }
+
+    // the product of rows b and c of A, projected onto the nullspace basis
+    auto row_product_coords = std::vector<Bits>(n_qubits * n_qubits, Bits(nullity));
+    for (auto const& [b, c] : dvlab::combinations<2>(std::views::iota(0ul, n_qubits) | tl::to<std::vector>())) {
+        auto& coords       = row_product_coords[b * n_qubits + c];
+        auto const product = packed_rows[b] & packed_rows[c];
+        for (auto j = product.find_first(); j != Bits::npos; j = product.find_next(j)) {
+            coords ^= null_coords[j];
+        }
+        row_product_coords[c * n_qubits + b] = coords;
+    }
+    auto const get_row_product_coords = [&](size_t b, size_t c) -> Bits const& { return row_product_coords[b * n_qubits + c]; };
+
+    auto seen_z          = std::unordered_set<dvlab::BooleanMatrix::Row, dvlab::BooleanMatrixRowHash>();
+    auto const idx_vec   = std::views::iota(0ul, n_terms) | tl::to<std::vector>();
+    auto const qubit_vec = std::views::iota(0ul, n_qubits) | tl::to<std::vector>();
 
-    auto const row_products = get_row_products(phase_poly_matrix);
     for (auto const& [a, b] : dvlab::combinations<2>(idx_vec)) {
-        if (stop_requested()) {
+        if (budget.is_exhausted()) {
             return polynomial;
         }
+
         dvlab::BooleanMatrix::Row z(n_qubits);
         for (size_t k = 0; k < n_qubits; ++k) {
             z[k] = phase_poly_matrix[k][a] ^ phase_poly_matrix[k][b];
@@ -209,36 +190,51 @@ Polynomial todd_once(Polynomial const& polynomial) {
 
         seen_z.insert(z);
 
-        // auto const chi_matrix = get_chi_matrix(phase_poly_matrix, z);
-        auto const chi_matrix           = get_chi_matrix(row_products, z);
-        auto const augmented_matrix     = vstack(phase_poly_matrix, chi_matrix);
-        auto const nullspace_transposed = get_nullspace_transposed(augmented_matrix);
+        // y_a + y_b for each nullspace basis vector y; the move is impossible if they all agree on a and b
+        auto const target = null_coords[a] ^ null_coords[b];
+        if (target.none()) {
+            continue;
+        }
+
+        // the chi matrix of z, projected onto the nullspace basis
+        auto chi_basis = ReducedEchelonBasis(nullity);
+        for (auto const& [i, j, k] : dvlab::combinations<3>(qubit_vec)) {
+            if (!z[i] && !z[j] && !z[k]) continue;
+            auto row = Bits(nullity);
+            if (z[i]) row ^= get_row_product_coords(j, k);
+            if (z[j]) row ^= get_row_product_coords(i, k);
+            if (z[k]) row ^= get_row_product_coords(i, j);
+            chi_basis.insert(std::move(row));
+            if (chi_basis.is_full_rank()) break;
+        }
 
-        if (nullspace_transposed.is_empty()) {
+        auto const coefficients = chi_basis.get_null_vector_against(target);
+        if (!coefficients.has_value()) {
             continue;
         }
 
-        for (auto const& y : nullspace_transposed) {
-            if (y[a] == y[b]) continue;
-            spdlog::debug("Found a TODD move");
-            spdlog::debug("- a, b: {}, {}", a, b);
-            spdlog::debug("- z: {}", fmt::join(z, ""));
-            spdlog::debug("- y: {}", fmt::join(y, ""));
-            auto phase_poly_matrix_copy = phase_poly_matrix;
-            auto y_copy                 = y;
-            if (y_copy.sum() % 2 == 1) {
-                phase_poly_matrix_copy.push_zeros_column();
-                y_copy.emplace_back(1);
-            }
+        dvlab::BooleanMatrix::Row y(n_terms);
+        for (size_t j = 0; j < n_terms; ++j) {
+            y[j] = (null_coords[j] & *coefficients).count() % 2;
+        }
 
-            for (auto const i : std::views::iota(0ul, phase_poly_matrix_copy.num_rows())) {
-                if (z[i] == 1) {
-                    phase_poly_matrix_copy[i] += y_copy;
-                }
-            }
+        spdlog::debug("Found a TODD move");
+        spdlog::debug("- a, b: {}, {}", a, b);
+        spdlog::debug("- z: {}", fmt::join(z, ""));
+        spdlog::debug("- y: {}", fmt::join(y, ""));
+        auto phase_poly_matrix_copy = phase_poly_matrix;
+        if (y.sum() % 2 == 1) {
+            phase_poly_matrix_copy.push_zeros_column();
+            y.emplace_back(1);
+        }
 
-            return from_boolean_matrix(dvlab::transpose(phase_poly_matrix_copy));
+        for (auto const i : std::views::iota(0ul, phase_poly_matrix_copy.num_rows())) {
+            if (z[i] == 1) {
+                phase_poly_matrix_copy[i] += y;
+            }
         }
+
+        return from_boolean_matrix(dvlab::transpose(phase_poly_matrix_copy));
     }
 
     return polynomial;
@@ -380,10 +376,18 @@ std::pair<StabilizerTableau, Polynomial> ToddPhasePolynomialOptimizationStrategy
     spdlog::trace("Polynomial before TODD:\n{}", fmt::join(ret_polynomial, "\n"));
     spdlog::debug("num_terms before TODD: {}", ret_polynomial.size());
 
-    while (true) {
+    auto const budget = ToddBudget{time_limit};
+    for (size_t n_moves = 0;; ++n_moves) {
+        if (max_moves > 0 && n_moves >= max_moves) {
+            spdlog::info("TODD stopped after reaching the limit of {} moves", max_moves);
+            break;
+        }
         auto const num_terms = ret_polynomial.size();
-        ret_polynomial       = todd_once(ret_polynomial);
+        ret_polynomial       = todd_once(ret_polynomial, budget);
         if (ret_polynomial.empty() || ret_polynomial.size() == num_terms) {
+            if (budget.is_exhausted()) {
+                spdlog::info("TODD stopped after {} moves due to the time limit or an interrupt", n_moves);
+            }
             break;
         }
         spdlog::trace("Polynomial after TODD:\n{}", fmt::join(ret_polynomial, "\n"));
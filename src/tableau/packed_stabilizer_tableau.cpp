@@ -0,0 +1,218 @@
+/****************************************************************************
+  PackageName  [ tableau ]
+  Synopsis     [ Define the column-major, bit-packed stabilizer tableau ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include "./packed_stabilizer_tableau.hpp"
+
+#include <algorithm>
+#include <ranges>
+
+#include "util/util.hpp"
+
+namespace qsyn::experimental {
+
+void PackedPauliProducts::push_back(PauliProduct const& product) {
+    DVLAB_ASSERT(product.n_qubits() == _n_qubits, "The Pauli product should have the same number of qubits");
+    if (_n_rows == _n_capacity * _word_bits) _grow();
+
+    auto const word = _n_rows / _word_bits;
+    auto const bit  = Word{1} << (_n_rows % _word_bits);
+    for (size_t q = 0; q < _n_qubits; ++q) {
+        if (product.is_x_set(q)) _x_word(q, word) |= bit;
+        if (product.is_z_set(q)) _z_word(q, word) |= bit;
+    }
+    if (product.is_neg()) _r[word] |= bit;
+    ++_n_rows;
+}
+
+/**
+ * @brief Append a row that is `pauli` on `qubit` and the identity elsewhere, without building a PauliProduct
+ *
+ */
+void PackedPauliProducts::push_back(size_t qubit, Pauli pauli) {
+    DVLAB_ASSERT(qubit < _n_qubits, "Qubit index out of range");
+    if (_n_rows == _n_capacity * _word_bits) _grow();
+
+    auto const word = _n_rows / _word_bits;
+    auto const bit  = Word{1} << (_n_rows % _word_bits);
+    if (pauli == Pauli::x || pauli == Pauli::y) _x_word(qubit, word) |= bit;
+    if (pauli == Pauli::z || pauli == Pauli::y) _z_word(qubit, word) |= bit;
+    ++_n_rows;
+}
+
+void PackedPauliProducts::reserve(size_t n_rows) {
+    auto const capacity = (n_rows + _word_bits - 1) / _word_bits;
+    if (capacity > _n_capacity) _reallocate(capacity);
+}
+
+PauliProduct PackedPauliProducts::get(size_t row) const {
+    DVLAB_ASSERT(row < _n_rows, "Row index out of range");
+    auto const word     = row / _word_bits;
+    auto const shift    = row % _word_bits;
+    auto const get_bit  = [shift](Word w) { return static_cast<bool>((w >> shift) & 1); };
+    auto const to_pauli = [&](size_t q) {
+        auto const x = get_bit(_x_word(q, word));
+        auto const z = get_bit(_z_word(q, word));
+        return z ? (x ? Pauli::y : Pauli::z) : (x ? Pauli::x : Pauli::i);
+    };
+    return PauliProduct(std::views::iota(0ul, _n_qubits) | std::views::transform(to_pauli), get_bit(_r[word]));
+}
+
+bool PackedPauliProducts::operator==(PackedPauliProducts const& rhs) const {
+    if (_n_qubits != rhs._n_qubits || _n_rows != rhs._n_rows) return false;
+    // the capacities may differ, so compare the used words only
+    auto const n_words = _n_used_words();
+    for (size_t w = 0; w < n_words; ++w) {
+        if (_r[w] != rhs._r[w]) return false;
+        for (size_t q = 0; q < _n_qubits; ++q) {
+            if (_x_word(q, w) != rhs._x_word(q, w) || _z_word(q, w) != rhs._z_word(q, w)) return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Double the number of words per column
+ *
+ */
+void PackedPauliProducts::_grow() {
+    _reallocate(std::max(size_t{1}, 2 * _n_capacity));
+}
+
+/**
+ * @brief Set the number of words per column and move the columns to their new places
+ *
+ */
+void PackedPauliProducts::_reallocate(size_t new_capacity) {
+    std::vector<Word> new_x(_n_qubits * new_capacity, 0);
+    std::vector<Word> new_z(_n_qubits * new_capacity, 0);
+    for (size_t q = 0; q < _n_qubits; ++q) {
+        std::ranges::copy_n(_x.begin() + static_cast<std::ptrdiff_t>(q * _n_capacity), static_cast<std::ptrdiff_t>(_n_capacity), new_x.begin() + static_cast<std::ptrdiff_t>(q * new_capacity));
+        std::ranges::copy_n(_z.begin() + static_cast<std::ptrdiff_t>(q * _n_capacity), static_cast<std::ptrdiff_t>(_n_capacity), new_z.begin() + static_cast<std::ptrdiff_t>(q * new_capacity));
+    }
+    _x = std::move(new_x);
+    _z = std::move(new_z);
+    _r.resize(new_capacity, 0);
+    _n_capacity = new_capacity;
+}
+
+// NOTE - The update rules are the same as those of PauliProduct, applied to 64 rows at a time.
+//        The loops are kept branch-free over plain words so that the compiler can vectorize them.
+//        Bits past the last row are zero and stay zero under these rules.
+
+void PackedPauliProducts::_h(size_t qubit, size_t first_word, size_t last_word) noexcept {
+    for (size_t w = first_word; w < last_word; ++w) {
+        auto& x = _x_word(qubit, w);
+        auto& z = _z_word(qubit, w);
+        _r[w] ^= x & z;
+        std::swap(x, z);
+    }
+}
+
+void PackedPauliProducts::_s(size_t qubit, size_t first_word, size_t last_word) noexcept {
+    for (size_t w = first_word; w < last_word; ++w) {
+        auto const x = _x_word(qubit, w);
+        auto& z      = _z_word(qubit, w);
+        _r[w] ^= x & z;
+        z ^= x;
+    }
+}
+
+void PackedPauliProducts::_cx(size_t ctrl, size_t targ, size_t first_word, size_t last_word) noexcept {
+    for (size_t w = first_word; w < last_word; ++w) {
+        auto& x_ctrl = _x_word(ctrl, w);
+        auto& z_ctrl = _z_word(ctrl, w);
+        auto& x_targ = _x_word(targ, w);
+        auto& z_targ = _z_word(targ, w);
+        _r[w] ^= x_ctrl & z_targ & ~(x_targ ^ z_ctrl);
+        x_targ ^= x_ctrl;
+        z_ctrl ^= z_targ;
+    }
+}
+
+PackedPauliProducts& PackedPauliProducts::h(size_t qubit) noexcept {
+    if (qubit >= n_qubits()) return *this;
+    _h(qubit, 0, _n_used_words());
+    return *this;
+}
+
+PackedPauliProducts& PackedPauliProducts::s(size_t qubit) noexcept {
+    if (qubit >= n_qubits()) return *this;
+    _s(qubit, 0, _n_used_words());
+    return *this;
+}
+
+PackedPauliProducts& PackedPauliProducts::cx(size_t ctrl, size_t targ) noexcept {
+    if (ctrl >= n_qubits() || targ >= n_qubits()) return *this;
+    _cx(ctrl, targ, 0, _n_used_words());
+    return *this;
+}
+
+/**
+ * @brief Apply a sequence of H, S, and CX gates in one pass over the rows.
+ *        Rows evolve independently under Clifford conjugation, so the gates are applied tile by tile:
+ *        all gates act on a few words of every column before moving to the next few words, keeping the tile in cache.
+ *        If the tiles are too large to fit in cache, the gates are applied one at a time to whole columns.
+ *
+ * @param primitives a sequence containing only H, S, and CX gates, e.g., from CliffordPrimitiveRecorder
+ * @return PackedPauliProducts&
+ */
+PackedPauliProducts& PackedPauliProducts::apply_primitives(CliffordOperatorString const& primitives) {
+    auto const n_words = _n_used_words();
+    // with many qubits, a tile of every column no longer stays in cache and tiling only scatters the accesses,
+    // so each gate is applied to whole columns instead
+    auto const tile_words = 2 * _n_qubits * _tile_words * sizeof(Word) <= _tile_cache_bytes ? _tile_words : std::max(n_words, size_t{1});
+    for (size_t first_word = 0; first_word < n_words; first_word += tile_words) {
+        auto const last_word = std::min(first_word + tile_words, n_words);
+        for (auto const& [type, qubits] : primitives) {
+            switch (type) {
+                case CliffordOperatorType::h:
+                    if (qubits[0] < _n_qubits) _h(qubits[0], first_word, last_word);
+                    break;
+                case CliffordOperatorType::s:
+                    if (qubits[0] < _n_qubits) _s(qubits[0], first_word, last_word);
+                    break;
+                case CliffordOperatorType::cx:
+                    if (qubits[0] < _n_qubits && qubits[1] < _n_qubits) _cx(qubits[0], qubits[1], first_word, last_word);
+                    break;
+                default:
+                    DVLAB_UNREACHABLE("apply_primitives only accepts H, S, and CX gates");
+            }
+        }
+    }
+    return *this;
+}
+
+PackedStabilizerTableau::PackedStabilizerTableau(size_t n_qubits) : _rows{n_qubits} {
+    // same as StabilizerTableau{n_qubits}, but without materializing the 2n rows of 2n + 1 bits each
+    _rows.reserve(2 * n_qubits);
+    for (size_t i = 0; i < n_qubits; ++i) {
+        _rows.push_back(i, Pauli::z);
+    }
+    for (size_t i = 0; i < n_qubits; ++i) {
+        _rows.push_back(i, Pauli::x);
+    }
+}
+
+PackedStabilizerTableau::PackedStabilizerTableau(StabilizerTableau const& tableau) : _rows{tableau.n_qubits()} {
+    for (size_t i = 0; i < tableau.n_qubits(); ++i) {
+        _rows.push_back(tableau.stabilizer(i));
+    }
+    for (size_t i = 0; i < tableau.n_qubits(); ++i) {
+        _rows.push_back(tableau.destabilizer(i));
+    }
+}
+
+StabilizerTableau PackedStabilizerTableau::to_stabilizer_tableau() const {
+    StabilizerTableau result{n_qubits()};
+    for (size_t i = 0; i < n_qubits(); ++i) {
+        result.stabilizer(i)   = _rows.get(i);
+        result.destabilizer(i) = _rows.get(n_qubits() + i);
+    }
+    return result;
+}
+
+}  // namespace qsyn::experimental
@@ -0,0 +1,150 @@
+/****************************************************************************
+  PackageName  [ tableau ]
+  Synopsis     [ Define the column-major, bit-packed stabilizer tableau ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "tableau/pauli_rotation.hpp"
+#include "tableau/stabilizer_tableau.hpp"
+
+namespace qsyn {
+
+namespace experimental {
+
+/**
+ * @brief A list of Pauli products stored column-major, i.e., qubit-major. For each qubit, the X bits and the Z bits of all rows
+ *        are packed into contiguous 64-bit words, as are the signs.
+ *        Conjugating by a Clifford gate therefore costs a few word-wise XOR/AND over one or two columns instead of touching every row.
+ *
+ */
+class PackedPauliProducts : public PauliProductTrait<PackedPauliProducts> {
+public:
+    using Word = std::uint64_t;
+
+    PackedPauliProducts(size_t n_qubits) : _n_qubits{n_qubits} {}
+
+    size_t n_qubits() const { return _n_qubits; }
+    size_t size() const { return _n_rows; }
+
+    void reserve(size_t n_rows);
+    void push_back(PauliProduct const& product);
+    void push_back(size_t qubit, Pauli pauli);
+    PauliProduct get(size_t row) const;
+
+    PackedPauliProducts& h(size_t qubit) noexcept override;
+    PackedPauliProducts& s(size_t qubit) noexcept override;
+    PackedPauliProducts& cx(size_t ctrl, size_t targ) noexcept override;
+
+    PackedPauliProducts& apply_primitives(CliffordOperatorString const& primitives);
+
+    bool operator==(PackedPauliProducts const& rhs) const;
+    bool operator!=(PackedPauliProducts const& rhs) const { return !(*this == rhs); }
+
+private:
+    static constexpr size_t _word_bits  = 64;
+    static constexpr size_t _tile_words       = 16;       // number of words per column processed at a time in apply_primitives
+    static constexpr size_t _tile_cache_bytes = 1 << 20;  // tile only if a tile of every column fits in this many bytes
+
+    size_t _n_qubits;
+    size_t _n_rows     = 0;
+    size_t _n_capacity = 0;  // number of words allocated per column
+
+    // the column of qubit q occupies words [q * _n_capacity, (q + 1) * _n_capacity)
+    std::vector<Word> _x;
+    std::vector<Word> _z;
+    std::vector<Word> _r;
+
+    size_t _n_used_words() const { return (_n_rows + _word_bits - 1) / _word_bits; }
+    void _grow();
+    void _reallocate(size_t new_capacity);
+
+    Word& _x_word(size_t qubit, size_t word) { return _x[qubit * _n_capacity + word]; }
+    Word& _z_word(size_t qubit, size_t word) { return _z[qubit * _n_capacity + word]; }
+    Word const& _x_word(size_t qubit, size_t word) const { return _x[qubit * _n_capacity + word]; }
+    Word const& _z_word(size_t qubit, size_t word) const { return _z[qubit * _n_capacity + word]; }
+
+    void _h(size_t qubit, size_t first_word, size_t last_word) noexcept;
+    void _s(size_t qubit, size_t first_word, size_t last_word) noexcept;
+    void _cx(size_t ctrl, size_t targ, size_t first_word, size_t last_word) noexcept;
+};
+
+/**
+ * @brief A stabilizer tableau stored as column-major packed Pauli products, as in Stim-style simulators.
+ *        Appending a gate is a handful of word operations per column, which makes it suitable for long Clifford circuits on many qubits.
+ *        The row order is the same as StabilizerTableau: stabilizers first, then destabilizers.
+ *
+ */
+class PackedStabilizerTableau : public PauliProductTrait<PackedStabilizerTableau> {
+public:
+    PackedStabilizerTableau(size_t n_qubits);
+    explicit PackedStabilizerTableau(StabilizerTableau const& tableau);
+
+    size_t n_qubits() const { return _rows.n_qubits(); }
+
+    PackedStabilizerTableau& h(size_t qubit) noexcept override {
+        _rows.h(qubit);
+        return *this;
+    }
+    PackedStabilizerTableau& s(size_t qubit) noexcept override {
+        _rows.s(qubit);
+        return *this;
+    }
+    PackedStabilizerTableau& cx(size_t ctrl, size_t targ) noexcept override {
+        _rows.cx(ctrl, targ);
+        return *this;
+    }
+
+    PackedStabilizerTableau& apply_primitives(CliffordOperatorString const& primitives) {
+        _rows.apply_primitives(primitives);
+        return *this;
+    }
+
+    StabilizerTableau to_stabilizer_tableau() const;
+
+    bool operator==(PackedStabilizerTableau const& rhs) const { return _rows == rhs._rows; }
+    bool operator!=(PackedStabilizerTableau const& rhs) const { return !(*this == rhs); }
+
+    bool is_identity() const { return *this == PackedStabilizerTableau{n_qubits()}; }
+
+private:
+    PackedPauliProducts _rows;
+};
+
+/**
+ * @brief Records the H, S, and CX gates that Clifford operations decompose into, so that they can be applied later in one batch
+ *        with `apply_primitives`.
+ *
+ */
+class CliffordPrimitiveRecorder : public PauliProductTrait<CliffordPrimitiveRecorder> {
+public:
+    CliffordPrimitiveRecorder& h(size_t qubit) noexcept override {
+        _primitives.push_back({CliffordOperatorType::h, {qubit, 0}});
+        return *this;
+    }
+    CliffordPrimitiveRecorder& s(size_t qubit) noexcept override {
+        _primitives.push_back({CliffordOperatorType::s, {qubit, 0}});
+        return *this;
+    }
+    CliffordPrimitiveRecorder& cx(size_t ctrl, size_t targ) noexcept override {
+        _primitives.push_back({CliffordOperatorType::cx, {ctrl, targ}});
+        return *this;
+    }
+
+    CliffordOperatorString const& primitives() const { return _primitives; }
+    bool empty() const { return _primitives.empty(); }
+    void clear() { _primitives.clear(); }
+
+private:
+    CliffordOperatorString _primitives;
+};
+
+}  // namespace experimental
+
+}  // namespace qsyn
@@ -0,0 +1,81 @@
+/****************************************************************************
+  PackageName  [ tableau ]
+  Synopsis     [ Define the batched commutation checks for Pauli products ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include "./pauli_commutation_kernel.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "util/util.hpp"
+
+namespace qsyn::experimental {
+
+PauliCommutationKernel::PauliCommutationKernel(std::span<PauliRotation const> rotations)
+    : PauliCommutationKernel(rotations.empty() ? 0 : rotations.front().n_qubits()) {
+    _x.reserve(rotations.size() * _n_words);
+    _z.reserve(rotations.size() * _n_words);
+    for (auto const& rotation : rotations) {
+        push_back(rotation.pauli_product());
+    }
+}
+
+void PauliCommutationKernel::push_back(PauliProduct const& product) {
+    _x.resize(_x.size() + _n_words, 0);
+    _z.resize(_z.size() + _n_words, 0);
+    ++_n_rows;
+    set(_n_rows - 1, product);
+}
+
+void PauliCommutationKernel::set(size_t row, PauliProduct const& product) {
+    DVLAB_ASSERT(row < _n_rows, "Row index out of range");
+    _pack(product, _x.data() + row * _n_words, _z.data() + row * _n_words);
+}
+
+void PauliCommutationKernel::_pack(PauliProduct const& product, Word* x, Word* z) const {
+    DVLAB_ASSERT(product.n_qubits() == _n_qubits, "The Pauli product should have the same number of qubits");
+    std::fill_n(x, _n_words, 0);
+    std::fill_n(z, _n_words, 0);
+    for (size_t q = 0; q < _n_qubits; ++q) {
+        auto const bit = Word{1} << (q % _word_bits);
+        if (product.is_x_set(q)) x[q / _word_bits] |= bit;
+        if (product.is_z_set(q)) z[q / _word_bits] |= bit;
+    }
+}
+
+bool PauliCommutationKernel::_is_commutative(Word const* x_1, Word const* z_1, size_t row_2) const {
+    auto const* x_2 = _x.data() + row_2 * _n_words;
+    auto const* z_2 = _z.data() + row_2 * _n_words;
+    // the parity of a popcount is the popcount of the XOR-ed words modulo 2
+    Word acc = 0;
+    for (size_t w = 0; w < _n_words; ++w) {
+        acc ^= (z_1[w] & x_2[w]) ^ (x_1[w] & z_2[w]);
+    }
+    return std::popcount(acc) % 2 == 0;
+}
+
+bool PauliCommutationKernel::is_commutative(size_t row_1, size_t row_2) const {
+    DVLAB_ASSERT(row_1 < _n_rows && row_2 < _n_rows, "Row index out of range");
+    return _is_commutative(_x.data() + row_1 * _n_words, _z.data() + row_1 * _n_words, row_2);
+}
+
+/**
+ * @brief Check the commutation of one row against the rows in [first, last)
+ *
+ * @return sul::dynamic_bitset<> a bitset of (last - first) bits, where bit i is set iff row (first + i) commutes with the row
+ */
+sul::dynamic_bitset<> PauliCommutationKernel::get_commuting_rows(size_t row, size_t first, size_t last) const {
+    DVLAB_ASSERT(row < _n_rows && first <= last && last <= _n_rows, "Row index out of range");
+    auto commuting = sul::dynamic_bitset<>(last - first);
+    auto const* x  = _x.data() + row * _n_words;
+    auto const* z  = _z.data() + row * _n_words;
+    for (size_t i = first; i < last; ++i) {
+        if (_is_commutative(x, z, i)) commuting.set(i - first);
+    }
+    return commuting;
+}
+
+}  // namespace qsyn::experimental
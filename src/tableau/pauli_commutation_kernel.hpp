@@ -0,0 +1,61 @@
+/****************************************************************************
+  PackageName  [ tableau ]
+  Synopsis     [ Define the batched commutation checks for Pauli products ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <sul/dynamic_bitset.hpp>
+#include <vector>
+
+#include "tableau/pauli_rotation.hpp"
+
+namespace qsyn {
+
+namespace experimental {
+
+/**
+ * @brief A list of Pauli products whose X and Z bits are packed row by row into 64-bit words, for checking the commutation
+ *        of one Pauli product against many at once. Two Pauli products commute iff their symplectic inner product,
+ *        the parity of popcount((z_1 & x_2) ^ (x_1 & z_2)), is zero, which costs a few word operations per row.
+ *
+ */
+class PauliCommutationKernel {
+public:
+    using Word = std::uint64_t;
+
+    PauliCommutationKernel(size_t n_qubits) : _n_qubits{n_qubits}, _n_words{(n_qubits + _word_bits - 1) / _word_bits} {}
+    explicit PauliCommutationKernel(std::span<PauliRotation const> rotations);
+
+    size_t n_qubits() const { return _n_qubits; }
+    size_t size() const { return _n_rows; }
+
+    void push_back(PauliProduct const& product);
+    void set(size_t row, PauliProduct const& product);
+
+    bool is_commutative(size_t row_1, size_t row_2) const;
+    sul::dynamic_bitset<> get_commuting_rows(size_t row, size_t first, size_t last) const;
+
+private:
+    static constexpr size_t _word_bits = 64;
+
+    size_t _n_qubits;
+    size_t _n_words;  // number of words per row for each of the X and Z bits
+    size_t _n_rows = 0;
+
+    // the X bits of row r occupy words [r * _n_words, (r + 1) * _n_words) of _x; so do the Z bits
+    std::vector<Word> _x;
+    std::vector<Word> _z;
+
+    void _pack(PauliProduct const& product, Word* x, Word* z) const;
+    bool _is_commutative(Word const* x_1, Word const* z_1, size_t row_2) const;
+};
+
+}  // namespace experimental
+
+}  // namespace qsyn
@@ -11,8 +11,8 @@
 #include <tl/adjacent.hpp>
 #include <tl/to.hpp>
 
-#include "util/boolean_matrix.hpp"
 #include "util/dvlab_string.hpp"
+#include "util/reduced_echelon_basis.hpp"
 
 namespace qsyn {
 
@@ -239,6 +239,15 @@ bool PauliProduct::is_commutative(PauliProduct const& rhs) const {
     return is_commutative;
 }
 
+size_t PauliProductHash::operator()(PauliProduct const& product) const {
+    auto const& bitset = product._bitset;
+    size_t ret         = std::hash<size_t>{}(bitset.size());
+    for (size_t i = 0; i < bitset.num_blocks(); ++i) {
+        ret ^= std::hash<sul::dynamic_bitset<>::block_type>{}(bitset.data()[i]) + 0x9e3779b9 + (ret << 6) + (ret >> 2);
+    }
+    return ret;
+}
+
 PauliRotation::PauliRotation(std::initializer_list<Pauli> const& pauli_list, dvlab::Phase const& phase)
     : _pauli_product(pauli_list, false), _phase(phase) { _normalize(); }
 
@@ -295,19 +304,19 @@ std::pair<CliffordOperatorString, size_t> extract_clifford_operators(PauliRotati
 }
 
 size_t matrix_rank(std::vector<PauliRotation> const& rotations) {
-    auto const n_qubits    = rotations.front().n_qubits();
-    auto const n_rotations = rotations.size();
+    auto const n_qubits = rotations.front().n_qubits();
 
-    // load the matrix
-    // REVIEW - may be revised if we move to use dynamic_bitset for the BooleanMatrix too
-    auto matrix = dvlab::BooleanMatrix{n_rotations, n_qubits};
-    for (size_t i = 0; i < n_rotations; ++i) {
+    auto basis = dvlab::ReducedEchelonBasis{n_qubits};
+    for (auto const& rotation : rotations) {
+        auto row = dvlab::ReducedEchelonBasis::Bits(n_qubits);
         for (size_t j = 0; j < n_qubits; ++j) {
-            matrix[i][j] = rotations[i].pauli_product().is_z_set(j);
+            if (rotation.pauli_product().is_z_set(j)) row.set(j);
         }
+        basis.insert(std::move(row));
+        if (basis.is_full_rank()) break;
     }
 
-    return matrix.matrix_rank();
+    return basis.rank();
 };
 
 }  // namespace experimental
@@ -247,6 +247,8 @@ public:
     }
 
 private:
+    friend struct PauliProductHash;
+
     sul::dynamic_bitset<> _bitset;
 
     size_t _z_idx(size_t i) const { return i; }
@@ -254,6 +256,10 @@ private:
     size_t _r_idx() const { return n_qubits() * 2; }
 };
 
+struct PauliProductHash {
+    size_t operator()(PauliProduct const& product) const;
+};
+
 inline bool is_commutative(PauliProduct const& lhs, PauliProduct const& rhs) {
     return lhs.is_commutative(rhs);
 }
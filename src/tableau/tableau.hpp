@@ -117,6 +117,9 @@ public:
         return _subtableaux[idx];
     }
 
+    bool operator==(Tableau const& rhs) const { return _n_qubits == rhs._n_qubits && _subtableaux == rhs._subtableaux; }
+    bool operator!=(Tableau const& rhs) const { return !(*this == rhs); }
+
     auto get_filename() const {
         return _filename;
     }
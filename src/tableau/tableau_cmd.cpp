@@ -187,6 +187,10 @@ dvlab::Command tableau_optimization_cmd(TableauMgr& tableau_mgr) {
         [&](ArgumentParser& parser) {
             parser.description("Optimize the tableau");
 
+            parser.add_argument<size_t>("-j", "--jobs")
+                .default_value(1)
+                .help("the number of threads for full, phasepoly, and matpar, which process the rotation segments independently. If 0, use all hardware threads");
+
             auto methods = parser.add_subparsers("method").required(true);
 
             methods.add_parser("full")
@@ -209,6 +213,14 @@ dvlab::Command tableau_optimization_cmd(TableauMgr& tableau_mgr) {
                 .constraint(choices_allow_prefix({"todd"}))
                 .help("Phase polynomial optimization strategy");
 
+            phasepoly_parser.add_argument<size_t>("--max-moves")
+                .default_value(0)
+                .help("the maximum number of TODD moves on each phase polynomial; 0 means no limit");
+
+            phasepoly_parser.add_argument<double>("--time-limit")
+                .default_value(0.)
+                .help("the time limit in seconds for optimizing each phase polynomial; 0 means no limit");
+
             auto matpar_parser = methods.add_parser("matpar")
                                      .description("partition the Pauli rotations into simultaneously-implementable tableaux. This option requires all Pauli rotations to be diagonal");
 
@@ -218,8 +230,8 @@ dvlab::Command tableau_optimization_cmd(TableauMgr& tableau_mgr) {
 
             matpar_parser.add_argument<std::string>("strategy")
                 .default_value("naive")
-                .constraint(choices_allow_prefix({"naive"}))
-                .help("Matroid partitioning strategy");
+                .constraint(choices_allow_prefix({"naive", "edmonds"}))
+                .help("Matroid partitioning strategy. `naive` greedily fills one partition at a time; `edmonds` finds the fewest partitions");
         },
         [&](ArgumentParser const& parser) {
             if (!dvlab::utils::mgr_has_data(tableau_mgr)) {
@@ -264,11 +276,13 @@ dvlab::Command tableau_optimization_cmd(TableauMgr& tableau_mgr) {
 
                 auto const phasepoly_strategy = std::invoke([&]() -> std::unique_ptr<PhasePolynomialOptimizationStrategy> {
                     if (dvlab::str::is_prefix_of(phasepoly_strategy_str, "todd")) {
-                        return std::make_unique<ToddPhasePolynomialOptimizationStrategy>();
+                        return std::make_unique<ToddPhasePolynomialOptimizationStrategy>(
+                            parser.get<size_t>("--max-moves"),
+                            std::chrono::duration<double>(parser.get<double>("--time-limit")));
                     }
                     return nullptr;
                 });
-                optimize_phase_polynomial(*tableau_mgr.get(), *phasepoly_strategy);
+                optimize_phase_polynomial(*tableau_mgr.get(), *phasepoly_strategy, parser.get<size_t>("--jobs"));
             };
 
             auto const do_matroid_partition = [&]() {
@@ -279,9 +293,12 @@ dvlab::Command tableau_optimization_cmd(TableauMgr& tableau_mgr) {
                     if (dvlab::str::is_prefix_of(matpar_strategy_str, "naive")) {
                         return std::make_unique<NaiveMatroidPartitionStrategy>();
                     }
+                    if (dvlab::str::is_prefix_of(matpar_strategy_str, "edmonds")) {
+                        return std::make_unique<EdmondsMatroidPartitionStrategy>();
+                    }
                     return nullptr;
                 });
-                auto const matpar_result   = matroid_partition(*tableau_mgr.get(), *matpar_strategy, ancillae);
+                auto const matpar_result   = matroid_partition(*tableau_mgr.get(), *matpar_strategy, ancillae, parser.get<size_t>("--jobs"));
                 if (!matpar_result) {
                     spdlog::error("Matroid partitioning failed!!");
                     return false;
@@ -293,7 +310,7 @@ dvlab::Command tableau_optimization_cmd(TableauMgr& tableau_mgr) {
 
             switch (*method) {
                 case OptimizationMethod::full:
-                    full_optimize(*tableau_mgr.get());
+                    full_optimize(*tableau_mgr.get(), parser.get<size_t>("--jobs"));
                     break;
                 case OptimizationMethod::collapse:
                     collapse(*tableau_mgr.get());
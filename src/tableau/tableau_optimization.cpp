@@ -9,17 +9,24 @@
 #include <fmt/core.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <gsl/narrow>
+#include <optional>
 #include <ranges>
 #include <tl/adjacent.hpp>
 #include <tl/to.hpp>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
+#include "tableau/pauli_commutation_kernel.hpp"
 #include "tableau/pauli_rotation.hpp"
 #include "tableau/stabilizer_tableau.hpp"
 #include "tableau/tableau.hpp"
+#include "util/parallel.hpp"
+#include "util/reduced_echelon_basis.hpp"
 
 namespace qsyn {
 
@@ -29,8 +36,9 @@ namespace experimental {
  * @brief Perform the best-known optimization routine on the tableau. The strategy may change in the future.
  *
  * @param tableau
+ * @param n_jobs the number of threads for the stages that process rotation segments independently. If 0, use all hardware threads
  */
-void full_optimize(Tableau& tableau) {
+void full_optimize(Tableau& tableau, size_t n_jobs) {
     size_t non_clifford_count = SIZE_MAX;
     size_t count              = 0;
     do {  // NOLINT(cppcoreguidelines-avoid-do-while)
@@ -40,7 +48,7 @@ void full_optimize(Tableau& tableau) {
         spdlog::debug("Internal-H-opt");
         minimize_internal_hadamards(tableau);
         spdlog::debug("Phase polynomial optimization");
-        optimize_phase_polynomial(tableau, ToddPhasePolynomialOptimizationStrategy{});
+        optimize_phase_polynomial(tableau, ToddPhasePolynomialOptimizationStrategy{}, n_jobs);
         spdlog::info("{}: Reduced the number of non-Clifford gates from {} to {}.", ++count, non_clifford_count, tableau.n_pauli_rotations());
     } while (non_clifford_count > tableau.n_pauli_rotations());
     minimize_internal_hadamards(tableau);
@@ -48,45 +56,43 @@ void full_optimize(Tableau& tableau) {
 
 namespace {
 /**
- * @brief A view of the conjugation of a Clifford and a list of PauliRotations.
+ * @brief Absorb the Clifford rotation R_P(θ) at `rotations[i]` into the Clifford operator before the rotations,
+ *        where θ is π/2, -π/2, or π. Moving the rotation to the front conjugates the Clifford operator and the rotations
+ *        before it, but the rotations that commute with P are left unchanged, so only the anticommuting ones are touched.
  *
+ * @param clifford
+ * @param rotations
+ * @param kernel the packed Pauli products of `rotations`, which is kept up to date
+ * @param i
+ * @param phase θ
  */
-class ConjugationView : public PauliProductTrait<ConjugationView> {
-public:
-    ConjugationView(
-        StabilizerTableau& clifford,
-        std::vector<PauliRotation>& rotations,
-        size_t upto) : _clifford{clifford}, _rotations{rotations}, _upto{upto} {}
-
-    ConjugationView& h(size_t qubit) noexcept override {
-        _clifford.get().h(qubit);
-        for (size_t i = 0; i < _upto; ++i) {
-            _rotations.get()[i].h(qubit);
-        }
-        return *this;
-    }
-
-    ConjugationView& s(size_t qubit) noexcept override {
-        _clifford.get().s(qubit);
-        for (size_t i = 0; i < _upto; ++i) {
-            _rotations.get()[i].s(qubit);
+void absorb_clifford_rotation(StabilizerTableau& clifford, std::vector<PauliRotation>& rotations, PauliCommutationKernel& kernel, size_t i, dvlab::Phase const& phase) {
+    auto const extracted    = extract_clifford_operators(rotations[i]);
+    auto const& ops         = extracted.first;
+    auto const adjoint_ops  = adjoint(ops);
+    auto const target_qubit = extracted.second;
+
+    auto const conjugate = [&](auto& target) {
+        target.apply(ops);
+        if (phase == dvlab::Phase(1, 2)) {
+            target.s(target_qubit);
+        } else if (phase == dvlab::Phase(-1, 2)) {
+            target.sdg(target_qubit);
+        } else {
+            assert(phase == dvlab::Phase(1));
+            target.z(target_qubit);
         }
-        return *this;
-    }
+        target.apply(adjoint_ops);
+    };
 
-    ConjugationView& cx(size_t control, size_t target) noexcept override {
-        _clifford.get().cx(control, target);
-        for (size_t i = 0; i < _upto; ++i) {
-            _rotations.get()[i].cx(control, target);
-        }
-        return *this;
+    conjugate(clifford);
+    auto const commuting = kernel.get_commuting_rows(i, 0, i);
+    for (size_t j = 0; j < i; ++j) {
+        if (commuting.test(j)) continue;
+        conjugate(rotations[j]);
+        kernel.set(j, rotations[j].pauli_product());
     }
-
-private:
-    std::reference_wrapper<StabilizerTableau> _clifford;
-    std::reference_wrapper<std::vector<PauliRotation>> _rotations;
-    size_t _upto;
-};
+}
 
 }  // namespace
 
@@ -224,13 +230,61 @@ void remove_identities(Tableau& tableau) {
  * @param rotations
  */
 void merge_rotations(std::vector<PauliRotation>& rotations) {
-    // merge two rotations if they are commutative and have the same underlying pauli product
+    if (rotations.empty()) {
+        return;
+    }
+
+    // Sweep forward while keeping, for each Pauli product, the open rotation, i.e., the earliest one that commutes with
+    // every rotation after it so far. A later rotation with the same product can be moved next to it and merged.
+    // A new rotation closes all open rotations it anticommutes with. Only rotations with a different non-identity Pauli
+    // on a shared qubit can anticommute with it, so open rotations are also indexed by (qubit, Pauli) to find them quickly.
+    auto const n_qubits = rotations.front().n_qubits();
+
+    auto const site_index = [](size_t qubit, Pauli pauli) {
+        return 3 * qubit + (pauli == Pauli::x ? 0 : pauli == Pauli::y ? 1 : 2);
+    };
+
+    auto const kernel = PauliCommutationKernel{rotations};
+
+    auto open_rotations = std::unordered_map<PauliProduct, size_t, PauliProductHash>{};
+    // may contain closed rotations, which are dropped lazily
+    auto open_rotations_at_site = std::vector<std::vector<size_t>>(3 * n_qubits);
+    auto is_open                = std::vector<bool>(rotations.size(), false);
+    // the last rotation that checked commutation against each rotation, to avoid checking twice
+    auto last_checked_by = std::vector<size_t>(rotations.size(), SIZE_MAX);
+
     for (size_t i = 0; i < rotations.size(); ++i) {
-        for (size_t j = i + 1; j < rotations.size(); ++j) {
-            if (!is_commutative(rotations[i], rotations[j])) break;
-            if (rotations[i].pauli_product() == rotations[j].pauli_product()) {
-                rotations[i].phase() += rotations[j].phase();
-                rotations[j].phase() = dvlab::Phase(0);
+        auto& rotation = rotations[i];
+        if (rotation.phase() == dvlab::Phase(0) || rotation.pauli_product().is_identity()) continue;
+
+        if (auto const it = open_rotations.find(rotation.pauli_product()); it != open_rotations.end()) {
+            rotations[it->second].phase() += rotation.phase();
+            rotation.phase() = dvlab::Phase(0);
+            continue;
+        }
+
+        for (size_t qubit = 0; qubit < n_qubits; ++qubit) {
+            auto const pauli = rotation.get_pauli_type(qubit);
+            if (pauli == Pauli::i) continue;
+            for (auto const other : {Pauli::x, Pauli::y, Pauli::z}) {
+                if (other == pauli) continue;
+                std::erase_if(open_rotations_at_site[site_index(qubit, other)], [&](size_t j) {
+                    if (!is_open[j]) return true;
+                    if (last_checked_by[j] == i) return false;
+                    last_checked_by[j] = i;
+                    if (kernel.is_commutative(j, i)) return false;
+                    is_open[j] = false;
+                    open_rotations.erase(rotations[j].pauli_product());
+                    return true;
+                });
+            }
+        }
+
+        is_open[i] = true;
+        open_rotations.emplace(rotation.pauli_product(), i);
+        for (size_t qubit = 0; qubit < n_qubits; ++qubit) {
+            if (auto const pauli = rotation.get_pauli_type(qubit); pauli != Pauli::i) {
+                open_rotations_at_site[site_index(qubit, pauli)].push_back(i);
             }
         }
     }
@@ -246,30 +300,14 @@ void merge_rotations(std::vector<PauliRotation>& rotations) {
  * @param rotations
  */
 void absorb_clifford_rotations(StabilizerTableau& clifford, std::vector<PauliRotation>& rotations) {
+    auto kernel = PauliCommutationKernel{rotations};
     for (size_t const i : std::views::iota(0ul, rotations.size())) {
         if (rotations[i].phase() != dvlab::Phase(1, 2) &&
             rotations[i].phase() != dvlab::Phase(-1, 2) &&
             rotations[i].phase() != dvlab::Phase(1)) continue;
 
-        auto conjugation_view = ConjugationView{clifford, rotations, i};
-
-        auto [ops, qubit] = extract_clifford_operators(rotations[i]);
-
-        conjugation_view.apply(ops);
-
-        if (rotations[i].phase() == dvlab::Phase(1, 2)) {
-            conjugation_view.s(qubit);
-        } else if (rotations[i].phase() == dvlab::Phase(-1, 2)) {
-            conjugation_view.sdg(qubit);
-        } else {
-            assert(rotations[i].phase() == dvlab::Phase(1));
-            conjugation_view.z(qubit);
-        }
+        absorb_clifford_rotation(clifford, rotations, kernel, i, rotations[i].phase());
         rotations[i].phase() = dvlab::Phase(0);
-
-        adjoint_inplace(ops);
-
-        conjugation_view.apply(ops);
     }
 
     // remove all rotations with zero phase
@@ -294,6 +332,7 @@ void properize(StabilizerTableau& clifford, std::vector<PauliRotation>& rotation
 
     // properize the rotations from the last to the first
     // the order is important because absorbing a rotation may change the phase of the preceding rotations
+    auto kernel = PauliCommutationKernel{rotations};
     for (size_t const i : std::views::iota(0ul, rotations.size()) | std::views::reverse) {
         auto complement_phase = dvlab::Phase(0);
         while (!is_proper_phase(rotations[i].phase())) {
@@ -302,24 +341,7 @@ void properize(StabilizerTableau& clifford, std::vector<PauliRotation>& rotation
         }
         if (complement_phase == dvlab::Phase(0)) continue;
 
-        auto [ops, qubit] = extract_clifford_operators(rotations[i]);
-
-        auto conjugation_view = ConjugationView{clifford, rotations, i};
-
-        conjugation_view.apply(ops);
-
-        if (complement_phase == dvlab::Phase(1, 2)) {
-            conjugation_view.s(qubit);
-        } else if (complement_phase == dvlab::Phase(-1, 2)) {
-            conjugation_view.sdg(qubit);
-        } else {
-            assert(complement_phase == dvlab::Phase(1));
-            conjugation_view.z(qubit);
-        }
-
-        adjoint_inplace(ops);
-
-        conjugation_view.apply(ops);
+        absorb_clifford_rotation(clifford, rotations, kernel, i, complement_phase);
     }
 
     remove_identities(rotations);
@@ -395,8 +417,94 @@ void merge_rotations(Tableau& tableau) {
     absorb_clifford_rotations(clifford, rotations);
 }
 
+/**
+ * @brief Rewrite the tableau into a normal form: a Clifford operator followed by proper Pauli rotations in a canonical order.
+ *        The rotations are merged and properized until nothing changes, and then sorted into the Foata normal form, i.e.,
+ *        grouped into layers by the length of the longest chain of anticommuting rotations before them, with the rotations
+ *        of a layer sorted by their Pauli products.
+ *        Reordering commuting rotations, merging rotations, and absorbing the Clifford parts of rotations do not change the
+ *        normal form. Two tableaux with the same normal form are therefore equivalent, but the converse need not hold.
+ *
+ * @param tableau
+ */
+void normalize(Tableau& tableau) {
+    collapse(tableau);
+
+    if (tableau.size() <= 1) {
+        remove_identities(tableau);
+        return;
+    }
+
+    auto& clifford  = std::get<StabilizerTableau>(tableau.front());
+    auto& rotations = std::get<std::vector<PauliRotation>>(tableau.back());
+
+    // properizing merges the rotations first; absorbing the Clifford parts may then enable more merges
+    auto n_rotations = rotations.size();
+    do {  // NOLINT(cppcoreguidelines-avoid-do-while)
+        n_rotations = rotations.size();
+        properize(clifford, rotations);
+    } while (rotations.size() < n_rotations);
+
+    auto const kernel = PauliCommutationKernel{rotations};
+    auto layer        = std::vector<size_t>(rotations.size(), 0);
+    for (size_t i = 0; i < rotations.size(); ++i) {
+        auto const commuting = kernel.get_commuting_rows(i, 0, i);
+        for (size_t j = 0; j < i; ++j) {
+            if (!commuting.test(j)) layer[i] = std::max(layer[i], layer[j] + 1);
+        }
+    }
+
+    // rotations in the same layer commute, and after merging, no two of them have the same Pauli product
+    auto const pauli_types = [n_qubits = tableau.n_qubits()](PauliRotation const& rotation) {
+        return std::views::iota(0ul, n_qubits) | std::views::transform([&rotation](size_t q) { return rotation.get_pauli_type(q); });
+    };
+    auto order = std::views::iota(0ul, rotations.size()) | tl::to<std::vector>();
+    std::ranges::sort(order, [&](size_t a, size_t b) {
+        if (layer[a] != layer[b]) return layer[a] < layer[b];
+        return std::ranges::lexicographical_compare(pauli_types(rotations[a]), pauli_types(rotations[b]));
+    });
+    rotations = order | std::views::transform([&rotations](size_t i) { return rotations[i]; }) | tl::to<std::vector>();
+
+    remove_identities(tableau);
+}
+
 // phase polynomial optimization
 
+namespace {
+
+/**
+ * @brief A Clifford operator in a tableau and the lists of Pauli rotations that follow it up to the next Clifford operator.
+ *        Passes that only modify the rotations and the Clifford operator before them act on disjoint parts of the tableau
+ *        for different segments.
+ *
+ */
+struct CliffordSegment {
+    size_t clifford;
+    std::vector<size_t> rotations;
+};
+
+/**
+ * @brief Split the tableau into Clifford segments. The first sub-tableau must be a stabilizer tableau.
+ *
+ * @param tableau
+ * @return std::vector<CliffordSegment>
+ */
+std::vector<CliffordSegment> get_clifford_segments(Tableau const& tableau) {
+    DVLAB_ASSERT(!tableau.is_empty() && std::holds_alternative<StabilizerTableau>(tableau.front()), "The first sub-tableau must be a StabilizerTableau");
+
+    auto segments = std::vector<CliffordSegment>{};
+    for (size_t i = 0; i < tableau.size(); ++i) {
+        if (std::holds_alternative<StabilizerTableau>(tableau[i])) {
+            segments.push_back({i, {}});
+        } else {
+            segments.back().rotations.push_back(i);
+        }
+    }
+    return segments;
+}
+
+}  // namespace
+
 /**
  * @brief Reduce the number of terms for the phase polynomial. If the polynomial is not a phase polynomial, do nothing.
  *
@@ -416,8 +524,9 @@ void optimize_phase_polynomial(StabilizerTableau& clifford, std::vector<PauliRot
  *
  * @param tableau
  * @param strategy
+ * @param n_jobs the number of threads; if 0, use all hardware threads
  */
-void optimize_phase_polynomial(Tableau& tableau, PhasePolynomialOptimizationStrategy const& strategy) {
+void optimize_phase_polynomial(Tableau& tableau, PhasePolynomialOptimizationStrategy const& strategy, size_t n_jobs) {
     if (tableau.is_empty()) {
         return;
     }
@@ -426,14 +535,17 @@ void optimize_phase_polynomial(Tableau& tableau, PhasePolynomialOptimizationStra
         tableau.insert(tableau.begin(), StabilizerTableau{tableau.n_qubits()});
     }
 
-    auto last_clifford = std::ref(std::get<StabilizerTableau>(tableau.front()));
-    for (auto& subtableau : tableau) {
-        if (auto pr = std::get_if<std::vector<PauliRotation>>(&subtableau)) {
-            optimize_phase_polynomial(last_clifford.get(), *pr, strategy);
-        } else {
-            last_clifford = std::get<StabilizerTableau>(subtableau);
-        }
-    }
+    // the polynomials after different Clifford operators touch disjoint sub-tableaux, so they are optimized concurrently
+    auto const segments = get_clifford_segments(tableau);
+    dvlab::utils::parallel_for(
+        segments.size(),
+        [&](size_t i) {
+            auto& clifford = std::get<StabilizerTableau>(tableau[segments[i].clifford]);
+            for (auto const j : segments[i].rotations) {
+                optimize_phase_polynomial(clifford, std::get<std::vector<PauliRotation>>(tableau[j]), strategy);
+            }
+        },
+        n_jobs);
 
     remove_identities(tableau);
 }
@@ -460,22 +572,33 @@ std::optional<std::vector<std::vector<PauliRotation>>> matroid_partition(std::ve
  * @param polynomial
  * @param strategy
  * @param num_ancillae
+ * @param n_jobs the number of threads; if 0, use all hardware threads
  * @return Tableau
  */
-std::optional<Tableau> matroid_partition(Tableau const& tableau, MatroidPartitionStrategy const& strategy, size_t num_ancillae) {
+std::optional<Tableau> matroid_partition(Tableau const& tableau, MatroidPartitionStrategy const& strategy, size_t num_ancillae, size_t n_jobs) {
+    // the rotation lists are partitioned independently, then put back in order
+    auto partitions = std::vector<std::optional<MatroidPartitionStrategy::Partitions>>(tableau.size());
+    dvlab::utils::parallel_for(
+        tableau.size(),
+        [&](size_t i) {
+            if (auto const pr = std::get_if<std::vector<PauliRotation>>(&tableau[i])) {
+                partitions[i] = matroid_partition(*pr, strategy, num_ancillae);
+            }
+        },
+        n_jobs);
+
     auto new_tableau = Tableau{tableau.n_qubits()};
 
-    for (auto const& subtableau : tableau) {
-        if (auto const pr = std::get_if<std::vector<PauliRotation>>(&subtableau)) {
-            auto partitions = matroid_partition(*pr, strategy, num_ancillae);
-            if (!partitions) {
+    for (size_t i = 0; i < tableau.size(); ++i) {
+        if (std::holds_alternative<std::vector<PauliRotation>>(tableau[i])) {
+            if (!partitions[i]) {
                 return std::nullopt;
             }
-            for (auto const& partition : *partitions) {
+            for (auto const& partition : *partitions[i]) {
                 new_tableau.push_back(partition);
             }
         } else {
-            new_tableau.push_back(subtableau);
+            new_tableau.push_back(tableau[i]);
         }
     }
 
@@ -503,6 +626,20 @@ auto MatroidPartitionStrategy::is_independent(std::vector<PauliRotation> const&
     return dim_v + polynomial.size() <= n + matrix_rank(polynomial);
 };
 
+namespace {
+
+using Bits = dvlab::ReducedEchelonBasis::Bits;
+
+Bits get_z_bits(PauliRotation const& rotation) {
+    auto bits = Bits(rotation.n_qubits());
+    for (size_t i = 0; i < rotation.n_qubits(); ++i) {
+        if (rotation.pauli_product().is_z_set(i)) bits.set(i);
+    }
+    return bits;
+}
+
+}  // namespace
+
 MatroidPartitionStrategy::Partitions NaiveMatroidPartitionStrategy::partition(MatroidPartitionStrategy::Polynomial const& polynomial, size_t num_ancillae) const {
     auto matroids = std::vector(1, std::vector<PauliRotation>{});  // starts with an empty matroid
 
@@ -510,12 +647,21 @@ MatroidPartitionStrategy::Partitions NaiveMatroidPartitionStrategy::partition(Ma
         return matroids;
     }
 
+    auto const dim_v = polynomial.front().n_qubits();
+    auto const n     = dim_v + num_ancillae;
+
+    // keep the row space of the last matroid so that the independence test does not recompute the rank
+    auto basis = dvlab::ReducedEchelonBasis{dim_v};
     for (auto const& term : polynomial) {
-        matroids.back().push_back(term);
-        if (!this->is_independent(matroids.back(), num_ancillae)) {
-            matroids.back().pop_back();
-            matroids.push_back({term});
+        auto z_bits         = get_z_bits(term);
+        auto const new_rank = basis.rank() + (basis.contains(z_bits) ? 0 : 1);
+        auto const new_size = matroids.back().size() + 1;
+        if (dim_v + new_size > n + new_rank) {  // the same condition as is_independent
+            matroids.push_back({});
+            basis = dvlab::ReducedEchelonBasis{dim_v};
         }
+        matroids.back().push_back(term);
+        basis.insert(std::move(z_bits));
     }
 
     DVLAB_ASSERT(std::ranges::none_of(matroids, [](std::vector<PauliRotation> const& matroid) { return matroid.empty(); }), "The matroids must not be empty.");
@@ -523,6 +669,152 @@ MatroidPartitionStrategy::Partitions NaiveMatroidPartitionStrategy::partition(Ma
     return matroids;
 }
 
+namespace {
+
+/**
+ * @brief A part of the partition in EdmondsMatroidPartitionStrategy, together with what the exchange tests need to know about it.
+ *        For a set S of terms with r = rank(S), let d = |S| - r be its deficiency; S is independent iff d <= num_ancillae.
+ *        - S + y is independent iff y is not in span(S) or d < num_ancillae.
+ *        - For y in span(S) and z in S, S - z + y has deficiency d + 1 iff z is a coloop of S (i.e., z is in every basis of S)
+ *          and y can be written without z; otherwise it has deficiency d.
+ *
+ */
+struct MatroidPart {
+    std::vector<size_t> terms;
+    dvlab::ReducedEchelonBasis basis{0};
+    std::vector<size_t> generators;  // the terms that form the basis, in the order of the generators of `basis`
+    Bits is_coloop;                  // over the generators
+    size_t deficiency = 0;
+
+    void rebuild(std::vector<Bits> const& z_bits, size_t dim_v, std::vector<size_t>& generator_index) {
+        basis = dvlab::ReducedEchelonBasis{dim_v};
+        generators.clear();
+        auto dependent_terms = std::vector<size_t>{};
+        for (auto const term : terms) {
+            if (basis.insert(z_bits[term])) {
+                generator_index[term] = generators.size();
+                generators.push_back(term);
+            } else {
+                generator_index[term] = SIZE_MAX;
+                dependent_terms.push_back(term);
+            }
+        }
+        deficiency = dependent_terms.size();
+
+        // a generator is a coloop iff no dependent term needs it
+        is_coloop = Bits(generators.size());
+        is_coloop.set();
+        for (auto const term : dependent_terms) {
+            auto const coordinates = basis.get_coordinates(z_bits[term]);
+            DVLAB_ASSERT(coordinates.has_value(), "A dependent term must be in the row space.");
+            for (auto i = coordinates->find_first(); i != Bits::npos; i = coordinates->find_next(i)) {
+                is_coloop.reset(i);
+            }
+        }
+    }
+};
+
+}  // namespace
+
+/**
+ * @brief Partition the polynomial with Edmonds' matroid partitioning algorithm, as proposed for T-par.
+ *        The terms are inserted one at a time. If no part can take the new term directly, we search for the shortest chain of
+ *        exchanges, each moving a term into a part that can take it after another term has left, that ends with a term
+ *        entering a part that has room for it. A new part is opened only if no such chain exists, which yields the minimum
+ *        number of parts.
+ *        ref: [Polynomial-time T-depth Optimization of Clifford+T circuits via Matroid Partitioning](https://arxiv.org/pdf/1303.2042.pdf)
+ *
+ */
+MatroidPartitionStrategy::Partitions EdmondsMatroidPartitionStrategy::partition(MatroidPartitionStrategy::Polynomial const& polynomial, size_t num_ancillae) const {
+    if (polynomial.empty()) {
+        return Partitions(1, Polynomial{});
+    }
+
+    auto const dim_v   = polynomial.front().n_qubits();
+    auto const n_terms = polynomial.size();
+    auto const z_bits  = polynomial | std::views::transform(get_z_bits) | tl::to<std::vector>();
+
+    auto parts           = std::vector<MatroidPart>{};
+    auto part_of         = std::vector<size_t>(n_terms, SIZE_MAX);
+    auto generator_index = std::vector<size_t>(n_terms, SIZE_MAX);
+
+    // bookkeeping of the breadth-first search; visit_stamp[t] == x + 1 marks that t is visited while inserting x
+    auto visit_stamp = std::vector<size_t>(n_terms, 0);
+    auto parent      = std::vector<size_t>(n_terms, SIZE_MAX);
+
+    for (size_t x = 0; x < n_terms; ++x) {
+        auto queue = std::vector<size_t>{x};
+        visit_stamp[x] = x + 1;
+
+        // the last term of the chain and the part it enters
+        auto sink = std::optional<std::pair<size_t, size_t>>{};
+        for (size_t head = 0; head < queue.size() && !sink.has_value(); ++head) {
+            auto const y = queue[head];
+            for (size_t j = 0; j < parts.size(); ++j) {
+                if (part_of[y] == j) continue;
+                auto& part             = parts[j];
+                auto const coordinates = part.basis.get_coordinates(z_bits[y]);
+                if (!coordinates.has_value() || part.deficiency < num_ancillae) {
+                    sink = {y, j};
+                    break;
+                }
+                for (auto const z : part.terms) {
+                    if (visit_stamp[z] == x + 1) continue;
+                    auto const g = generator_index[z];
+                    if (g != SIZE_MAX && part.is_coloop.test(g) && !coordinates->test(g)) continue;
+                    visit_stamp[z] = x + 1;
+                    parent[z]      = y;
+                    queue.push_back(z);
+                }
+            }
+        }
+
+        if (!sink.has_value()) {
+            part_of[x] = parts.size();
+            parts.emplace_back().terms = {x};
+            parts.back().rebuild(z_bits, dim_v, generator_index);
+            continue;
+        }
+
+        // move every term on the chain into the part of its successor, and the last term into the sink
+        auto touched_parts = std::vector<size_t>{};
+        auto move_to       = [&](size_t term, size_t j) {
+            if (part_of[term] != SIZE_MAX) {
+                auto& terms = parts[part_of[term]].terms;
+                terms.erase(std::ranges::find(terms, term));
+            }
+            parts[j].terms.push_back(term);
+            part_of[term] = j;
+            touched_parts.push_back(j);
+        };
+        auto [term, target_part] = *sink;
+        while (true) {
+            auto const old_part = part_of[term];
+            move_to(term, target_part);
+            if (term == x) break;
+            target_part = old_part;
+            term        = parent[term];
+        }
+        std::ranges::sort(touched_parts);
+        auto const [first, last] = std::ranges::unique(touched_parts);
+        touched_parts.erase(first, last);
+        for (auto const j : touched_parts) {
+            parts[j].rebuild(z_bits, dim_v, generator_index);
+        }
+    }
+
+    auto matroids = Partitions{};
+    matroids.reserve(parts.size());
+    for (auto& part : parts) {
+        std::ranges::sort(part.terms);
+        matroids.push_back(part.terms | std::views::transform([&](size_t t) { return polynomial[t]; }) | tl::to<std::vector>());
+    }
+
+    DVLAB_ASSERT(std::ranges::all_of(matroids, [&](Polynomial const& matroid) { return this->is_independent(matroid, num_ancillae); }), "The matroids must be independent.");
+
+    return matroids;
+}
+
 }  // namespace experimental
 
 }  // namespace qsyn
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <concepts>
 
 #include "./tableau.hpp"
@@ -16,7 +17,7 @@ namespace qsyn {
 
 namespace experimental {
 
-void full_optimize(Tableau& tableau);
+void full_optimize(Tableau& tableau, size_t n_jobs = 1);
 
 void collapse(Tableau& tableau);
 
@@ -31,6 +32,8 @@ void properize(Tableau& tableau);
 void merge_rotations(std::vector<PauliRotation>& rotation);
 void merge_rotations(Tableau& tableau);
 
+void normalize(Tableau& tableau);
+
 // hadamard minimization
 // implemented in ./optimize/internal_h_opt.cpp
 
@@ -44,12 +47,24 @@ struct PhasePolynomialOptimizationStrategy {
     virtual std::pair<StabilizerTableau, Polynomial> optimize(StabilizerTableau const& clifford, Polynomial const& polynomial) const = 0;
 };
 
+/**
+ * @brief TODD phase polynomial optimization. Each polynomial stops early once it has taken `max_moves` TODD moves
+ *        or spent `time_limit`; a zero budget means no limit.
+ *
+ */
 struct ToddPhasePolynomialOptimizationStrategy : public PhasePolynomialOptimizationStrategy {
+    ToddPhasePolynomialOptimizationStrategy() = default;
+    ToddPhasePolynomialOptimizationStrategy(size_t max_moves, std::chrono::duration<double> time_limit)
+        : max_moves{max_moves}, time_limit{time_limit} {}
+
     std::pair<StabilizerTableau, Polynomial> optimize(StabilizerTableau const& clifford, Polynomial const& polynomial) const override;
+
+    size_t max_moves = 0;
+    std::chrono::duration<double> time_limit{0};
 };
 
 void optimize_phase_polynomial(StabilizerTableau& clifford, std::vector<PauliRotation>& polynomial, PhasePolynomialOptimizationStrategy const& strategy);
-void optimize_phase_polynomial(Tableau& tableau, PhasePolynomialOptimizationStrategy const& strategy);
+void optimize_phase_polynomial(Tableau& tableau, PhasePolynomialOptimizationStrategy const& strategy, size_t n_jobs = 1);
 
 struct MatroidPartitionStrategy {
     using Polynomial                    = std::vector<PauliRotation>;
@@ -69,13 +84,21 @@ struct NaiveMatroidPartitionStrategy : public MatroidPartitionStrategy {
     Partitions partition(Polynomial const& polynomial, size_t num_ancillae) const override;
 };
 
+/**
+ * @brief partitions the given polynomial into the fewest matroids by finding augmenting exchange paths, as in Edmonds' algorithm
+ *
+ */
+struct EdmondsMatroidPartitionStrategy : public MatroidPartitionStrategy {
+    Partitions partition(Polynomial const& polynomial, size_t num_ancillae) const override;
+};
+
 inline bool is_phase_polynomial(std::vector<PauliRotation> const& polynomial) noexcept {
     return std::ranges::all_of(polynomial, [](PauliRotation const& rotation) { return rotation.is_diagonal(); }) &&
            std::ranges::all_of(polynomial, [n_qubits = polynomial.front().n_qubits()](PauliRotation const& rotation) { return rotation.n_qubits() == n_qubits; });
 }
 
 std::optional<std::vector<std::vector<PauliRotation>>> matroid_partition(std::vector<PauliRotation> const& polynomial, MatroidPartitionStrategy const& strategy, size_t num_ancillae = 0);
-std::optional<Tableau> matroid_partition(Tableau const& tableau, MatroidPartitionStrategy const& strategy, size_t num_ancillae = 0);
+std::optional<Tableau> matroid_partition(Tableau const& tableau, MatroidPartitionStrategy const& strategy, size_t num_ancillae = 0, size_t n_jobs = 1);
 
 }  // namespace experimental
 
@@ -13,17 +13,12 @@ namespace qsyn::tensor {
  * @brief Append gate and save the encoding gate sequence
  *
  * @param target
- * @param qubit_list
- * @param gate_list
  */
-void Decomposer::_encode_control_gate(QubitIdList const& target, std::vector<QubitIdList>& qubit_list, std::vector<std::string>& gate_list) {
-    qubit_list.emplace_back(target);
+void Decomposer::_encode_control_gate(QubitIdList const& target) {
     if (target.size() == 2) {
-        gate_list.emplace_back("cx");
-        _quantum_circuit.append(qcir::CXGate(), target);
+        _emit(qcir::CXGate(), target);
     } else {
-        gate_list.emplace_back("x");
-        _quantum_circuit.append(qcir::XGate(), target);
+        _emit(qcir::XGate(), target);
     }
 }
 
@@ -32,22 +27,20 @@ void Decomposer::_encode_control_gate(QubitIdList const& target, std::vector<Qub
  *
  * @param origin_pos Origin qubit
  * @param targ_pos Target qubit
- * @param qubit_list
- * @param gate_list
  */
-void Decomposer::_encode(size_t origin_pos, size_t targ_pos, std::vector<QubitIdList>& qubit_list, std::vector<std::string>& gate_list) {
+void Decomposer::_encode(size_t origin_pos, size_t targ_pos) {
     bool x_given = false;
     if (((origin_pos >> targ_pos) & 1) == 0) {
-        _encode_control_gate({targ_pos}, qubit_list, gate_list);
+        _encode_control_gate({targ_pos});
         x_given = true;
     }
     for (size_t i = 0; i < _n_qubits; i++) {
         if (i == targ_pos) continue;
         if (((origin_pos >> i) & 1) == 0)
-            _encode_control_gate({targ_pos, i}, qubit_list, gate_list);
+            _encode_control_gate({targ_pos, i});
     }
     if (x_given)
-        _encode_control_gate({targ_pos}, qubit_list, gate_list);
+        _encode_control_gate({targ_pos});
 }
 
 }  // namespace qsyn::tensor
@@ -11,7 +11,8 @@
 
 #include <cstddef>
 #include <ranges>
-#include <tl/to.hpp>
+#include <utility>
+#include <vector>
 
 #include "qcir/basic_gate_type.hpp"
 #include "qcir/qcir.hpp"
@@ -52,7 +53,9 @@ struct ZYZ {
 
 class Decomposer {
 private:
-    QCir _quantum_circuit;
+    // gates are buffered and only turned into a QCir once the decomposition succeeds;
+    // the buffer is reused across calls to `decompose`
+    std::vector<std::pair<qcir::Operation, QubitIdList>> _gate_buffer;
     size_t _n_qubits = 0;
 
 public:
@@ -86,10 +89,16 @@ private:
     template <typename U>
     std::vector<TwoLevelMatrix<U>> _get_two_level_matrices(QTensor<U> matrix /* copy on purpose */);
 
+    template <typename U>
+    size_t _count_deviations_from_identity(QTensor<U> const& matrix, size_t row, U eps);
+    template <typename U>
+    void _apply_two_level_rotation(QTensor<U>& matrix, TwoLevelMatrix<U> const& rotation);
+
     template <typename U>
     bool _graycode(Tensor<U> const& matrix, size_t i, size_t j);
-    void _encode(size_t origin_pos, size_t targ_pos, std::vector<QubitIdList>& qubit_list, std::vector<std::string>& gate_list);
-    void _encode_control_gate(QubitIdList const& target, std::vector<QubitIdList>& qubit_list, std::vector<std::string>& gate_list);
+    void _emit(qcir::Operation const& op, QubitIdList const& qubits) { _gate_buffer.emplace_back(op, qubits); }
+    void _encode(size_t origin_pos, size_t targ_pos);
+    void _encode_control_gate(QubitIdList const& target);
 
     template <typename U>
     bool _decompose_cnu(Tensor<U> const& t, size_t diff_pos, size_t index, size_t ctrl_gates);
@@ -119,7 +128,7 @@ std::optional<QCir> Decomposer::decompose(QTensor<U> const& matrix) {
     _n_qubits      = static_cast<size_t>(std::round(std::log2(_get_dimension(matrix))));
     auto mat_chain = _get_two_level_matrices(matrix);
 
-    _quantum_circuit = QCir(_n_qubits);
+    _gate_buffer.clear();
 
     for (auto const& i : std::views::iota(0UL, mat_chain.size()) | std::views::reverse) {
         size_t i_idx = 0, j_idx = 0;
@@ -134,7 +143,12 @@ std::optional<QCir> Decomposer::decompose(QTensor<U> const& matrix) {
         }
         if (!_graycode(mat_chain[i]._matrix, i_idx, j_idx)) return std::nullopt;
     }
-    return _quantum_circuit;
+
+    QCir quantum_circuit(_n_qubits);
+    for (auto const& [op, qubits] : _gate_buffer) {
+        quantum_circuit.append(op, qubits);
+    }
+    return quantum_circuit;
 }
 
 /**
@@ -240,21 +254,30 @@ std::vector<TwoLevelMatrix<U>> Decomposer::_get_two_level_matrices(QTensor<U> ma
     using namespace std::literals;
     constexpr U eps = 1e-6;
     std::vector<TwoLevelMatrix<U>> two_level_chain;
-    auto const dimension = static_cast<size_t>(matrix.shape()[0]);
+    auto const dimension = _get_dimension(matrix);
+
+    // A two-level matrix has at most 4 entries that differ from the identity.
+    // Track that count incrementally so that the full scan only runs when it may succeed.
+    size_t num_deviations = 0;
+    for (size_t row = 0; row < dimension; row++) {
+        num_deviations += _count_deviations_from_identity(matrix, row, eps);
+    }
 
     for (size_t i = 0; i < dimension; i++) {
         for (size_t j = i + 1; j < dimension; j++) {
             // if `matrix` is the last two-level matrix
-            if (auto const pair = _get_two_level_matrix_indices(matrix, eps)) {
-                auto const& [selected_top, selected_bottom] = *pair;
+            if (num_deviations <= 4) {
+                if (auto const pair = _get_two_level_matrix_indices(matrix, eps)) {
+                    auto const& [selected_top, selected_bottom] = *pair;
+
+                    // shortcut for identity
+                    if (selected_top == SIZE_MAX && selected_bottom == SIZE_MAX) {
+                        return two_level_chain;
+                    }
 
-                // shortcut for identity
-                if (selected_top == SIZE_MAX && selected_bottom == SIZE_MAX) {
+                    two_level_chain.emplace_back(_make_two_level_matrix(matrix, selected_top, selected_bottom));
                     return two_level_chain;
                 }
-
-                two_level_chain.emplace_back(_make_two_level_matrix(matrix, selected_top, selected_bottom));
-                return two_level_chain;
             }
 
             // not a two-level matrix
@@ -274,31 +297,64 @@ std::vector<TwoLevelMatrix<U>> Decomposer::_get_two_level_matrices(QTensor<U> ma
             // normalization factor
             const U u = std::sqrt(std::norm(matrix(i, i)) + std::norm(matrix(j, i)));
 
-            auto const n_qubits = static_cast<size_t>(std::round(std::log2(_get_dimension(matrix))));
-            QTensor<U> conjugate_matrix_product =
-                QTensor<U>::identity(n_qubits).to_matrix(
-                    std::views::iota(0ul, n_qubits) |
-                        std::views::transform([](auto i) { return 2 * i + 1; }) |
-                        tl::to<std::vector>(),
-                    std::views::iota(0ul, n_qubits) |
-                        std::views::transform([](auto i) { return 2 * i; }) |
-                        tl::to<std::vector>());
-
-            conjugate_matrix_product(i, i) = std::conj(matrix(i, i)) / u;
-            conjugate_matrix_product(j, j) = matrix(i, i) / u;
+            // the rotation zeroes out matrix(j, i)
+            auto const rotation = TwoLevelMatrix<U>(
+                QTensor<U>({{std::conj(matrix(i, i)) / u, std::conj(matrix(j, i)) / u},
+                            {-matrix(j, i) / u, matrix(i, i) / u}}),
+                i, j);
 
-            conjugate_matrix_product(i, j) = std::conj(matrix(j, i)) / u;
-            conjugate_matrix_product(j, i) = -matrix(j, i) / u;
+            num_deviations -= _count_deviations_from_identity(matrix, i, eps) + _count_deviations_from_identity(matrix, j, eps);
+            _apply_two_level_rotation(matrix, rotation);
+            num_deviations += _count_deviations_from_identity(matrix, i, eps) + _count_deviations_from_identity(matrix, j, eps);
 
-            matrix = tensordot(conjugate_matrix_product, matrix, {1}, {0});
-
-            two_level_chain.emplace_back(adjoint(_make_two_level_matrix(conjugate_matrix_product, i, j)));
+            two_level_chain.emplace_back(adjoint(rotation));
         }
     }
 
     return two_level_chain;
 }
 
+/**
+ * @brief Count the entries in a row of the matrix that differ from those of the identity matrix
+ *
+ * @tparam U
+ * @param matrix
+ * @param row
+ * @param eps
+ * @return size_t
+ */
+template <typename U>
+size_t Decomposer::_count_deviations_from_identity(QTensor<U> const& matrix, size_t row, U eps) {
+    auto const dimension = static_cast<size_t>(matrix.shape()[1]);
+    size_t count         = 0;
+    for (size_t col = 0; col < dimension; col++) {
+        auto const expected = (col == row) ? std::complex<U>{1} : std::complex<U>{0};
+        if (std::abs(matrix(row, col) - expected) > eps) count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Left-multiply the matrix by a two-level matrix in place.
+ *        Only the two affected rows are touched, which are contiguous in memory.
+ *
+ * @tparam U
+ * @param matrix
+ * @param rotation
+ */
+template <typename U>
+void Decomposer::_apply_two_level_rotation(QTensor<U>& matrix, TwoLevelMatrix<U> const& rotation) {
+    auto const dimension = static_cast<size_t>(matrix.shape()[1]);
+    auto const& kernel   = rotation._matrix;
+    auto const k00 = kernel(0, 0), k01 = kernel(0, 1), k10 = kernel(1, 0), k11 = kernel(1, 1);
+    for (size_t col = 0; col < dimension; col++) {
+        auto const top    = matrix(rotation._i, col);
+        auto const bottom = matrix(rotation._j, col);
+        matrix(rotation._i, col) = k00 * top + k01 * bottom;
+        matrix(rotation._j, col) = k10 * top + k11 * bottom;
+    }
+}
+
 /**
  * @brief Perform Graycode synthesis
  *
@@ -312,8 +368,7 @@ std::vector<TwoLevelMatrix<U>> Decomposer::_get_two_level_matrices(QTensor<U> ma
 template <typename U>
 bool Decomposer::Decomposer::_graycode(Tensor<U> const& matrix, size_t i, size_t j) {
     // do pabbing
-    std::vector<QubitIdList> qubit_list;
-    std::vector<std::string> gate_list;
+    auto const encode_begin = _gate_buffer.size();
 
     size_t diff_pos = 0;
     for (size_t q = 0; q < _n_qubits; q++) {
@@ -324,9 +379,10 @@ bool Decomposer::Decomposer::_graycode(Tensor<U> const& matrix, size_t i, size_t
     }
 
     if ((i + size_t(std::pow(2, diff_pos))) != size_t(std::pow(2, _n_qubits) - 1))
-        _encode(i, diff_pos, qubit_list, gate_list);
+        _encode(i, diff_pos);
 
-    _encode(j, diff_pos, qubit_list, gate_list);
+    _encode(j, diff_pos);
+    auto const encode_end = _gate_buffer.size();
 
     // decompose CnU
     size_t ctrl_index = 0;  // q2 q1 q0 = t,c,c -> ctrl_index = 011 = 3
@@ -337,11 +393,9 @@ bool Decomposer::Decomposer::_graycode(Tensor<U> const& matrix, size_t i, size_t
     if (!_decompose_cnu(matrix, diff_pos, ctrl_index, _n_qubits - 1)) return false;
 
     // do unpabbing
-    DVLAB_ASSERT(gate_list.size() == qubit_list.size(), "Sizes of gate list and qubit list are different");
-    for (auto const& q : std::views::iota(0UL, gate_list.size()) | std::views::reverse) {
-        if (auto const op = qcir::str_to_operation(gate_list[q], {}); op.has_value()) {
-            _quantum_circuit.append(*op, qubit_list[q]);
-        }
+    _gate_buffer.reserve(_gate_buffer.size() + (encode_end - encode_begin));
+    for (auto const& q : std::views::iota(encode_begin, encode_end) | std::views::reverse) {
+        _gate_buffer.emplace_back(_gate_buffer[q]);
     }
 
     return true;
@@ -422,9 +476,9 @@ bool Decomposer::_decompose_cnu(Tensor<U> const& t, size_t diff_pos, size_t inde
 template <typename U>
 bool Decomposer::_decompose_cnx(const std::vector<size_t>& ctrls, const size_t extract_qubit, const size_t index, const size_t ctrl_gates) {
     if (ctrls.size() == 1) {
-        _quantum_circuit.append(qcir::CXGate(), {ctrls[0], extract_qubit});
+        _emit(qcir::CXGate(), {ctrls[0], extract_qubit});
     } else if (ctrls.size() == 2) {
-        _quantum_circuit.append(qcir::CCXGate(), {ctrls[0], ctrls[1], extract_qubit});
+        _emit(qcir::CCXGate(), {ctrls[0], ctrls[1], extract_qubit});
     } else {
         using float_type = U::value_type;
         if (!_decompose_cnu(QTensor<float_type>::xgate(), extract_qubit, index, ctrl_gates)) return false;
@@ -452,35 +506,35 @@ bool Decomposer::_decompose_cu(Tensor<U> const& t, size_t ctrl, size_t targ) {
     if (!angles.has_value()) return false;
 
     if (std::abs((angles->alpha - angles->gamma) / 2) > eps) {
-        _quantum_circuit.append(qcir::RZGate(Phase{((angles->alpha - angles->gamma) / 2) * (-1.0)}), {targ});
+        _emit(qcir::RZGate(Phase{((angles->alpha - angles->gamma) / 2) * (-1.0)}), {targ});
     }
 
     if (std::abs(angles->beta) > eps) {
-        _quantum_circuit.append(qcir::CXGate(), {ctrl, targ});
+        _emit(qcir::CXGate(), {ctrl, targ});
         if (std::abs((angles->alpha + angles->gamma) / 2) > eps) {
-            _quantum_circuit.append(qcir::RZGate(Phase{((angles->alpha + angles->gamma) / 2) * (-1.0)}), {targ});
+            _emit(qcir::RZGate(Phase{((angles->alpha + angles->gamma) / 2) * (-1.0)}), {targ});
         }
 
-        _quantum_circuit.append(qcir::RYGate(Phase{angles->beta * (-1.0)}), {targ});
-        _quantum_circuit.append(qcir::CXGate(), {ctrl, targ});
-        _quantum_circuit.append(qcir::RYGate(Phase{angles->beta}), {targ});
+        _emit(qcir::RYGate(Phase{angles->beta * (-1.0)}), {targ});
+        _emit(qcir::CXGate(), {ctrl, targ});
+        _emit(qcir::RYGate(Phase{angles->beta}), {targ});
 
         if (std::abs(angles->alpha) > eps) {
-            _quantum_circuit.append(qcir::RZGate(Phase(angles->alpha)), {targ});
+            _emit(qcir::RZGate(Phase(angles->alpha)), {targ});
         }
 
     } else {
         if (std::abs((angles->alpha + angles->gamma) / 2) > eps) {
-            _quantum_circuit.append(qcir::CXGate(), {ctrl, targ});
-            _quantum_circuit.append(qcir::RZGate(Phase{((angles->alpha + angles->gamma) / 2) * (-1.0)}), {targ});
-            _quantum_circuit.append(qcir::CXGate(), {ctrl, targ});
+            _emit(qcir::CXGate(), {ctrl, targ});
+            _emit(qcir::RZGate(Phase{((angles->alpha + angles->gamma) / 2) * (-1.0)}), {targ});
+            _emit(qcir::CXGate(), {ctrl, targ});
         }
         if (std::abs(angles->alpha) > eps) {
-            _quantum_circuit.append(qcir::RZGate(Phase(angles->alpha)), {targ});
+            _emit(qcir::RZGate(Phase(angles->alpha)), {targ});
         }
     }
     if (std::abs(angles->phi) > eps) {
-        _quantum_circuit.append(qcir::RZGate(Phase(angles->phi)), {ctrl});
+        _emit(qcir::RZGate(Phase(angles->phi)), {ctrl});
     }
 
     return true;
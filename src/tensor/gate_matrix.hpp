@@ -0,0 +1,162 @@
+/****************************************************************************
+  PackageName  [ tensor ]
+  Synopsis     [ Define fixed-size gate matrices ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <complex>
+#include <concepts>
+#include <cstddef>
+#include <numbers>
+
+#include "util/phase.hpp"
+
+namespace qsyn::tensor {
+
+/**
+ * @brief A dense matrix of an N-qubit gate stored inline, without heap allocation.
+ *        Entries are row-major; rows are outputs and columns are inputs, with the first qubit being the most significant bit.
+ *
+ * @tparam T floating-point type
+ * @tparam N number of qubits
+ */
+template <std::floating_point T, size_t N>
+struct GateMatrix {
+    static constexpr size_t num_qubits = N;
+    static constexpr size_t dimension  = size_t{1} << N;
+
+    std::array<std::complex<T>, dimension * dimension> entries{};
+
+    constexpr std::complex<T>& operator()(size_t row, size_t col) { return entries[row * dimension + col]; }
+    constexpr std::complex<T> const& operator()(size_t row, size_t col) const { return entries[row * dimension + col]; }
+
+    constexpr GateMatrix& operator*=(std::complex<T> const& scalar) {
+        for (auto& entry : entries) entry *= scalar;
+        return *this;
+    }
+    friend constexpr GateMatrix operator*(GateMatrix matrix, std::complex<T> const& scalar) { return matrix *= scalar; }
+};
+
+//------------------------------
+// fixed gates
+//------------------------------
+
+template <std::floating_point T>
+inline constexpr GateMatrix<T, 1> idgate_matrix = {{1, 0,
+                                                    0, 1}};
+
+template <std::floating_point T>
+inline constexpr GateMatrix<T, 1> xgate_matrix = {{0, 1,
+                                                   1, 0}};
+
+template <std::floating_point T>
+inline constexpr GateMatrix<T, 1> ygate_matrix = {{{{0, 0}, {0, -1},
+                                                    {0, 1}, {0, 0}}}};
+
+template <std::floating_point T>
+inline constexpr GateMatrix<T, 1> zgate_matrix = {{1, 0,
+                                                   0, -1}};
+
+template <std::floating_point T>
+inline constexpr GateMatrix<T, 1> hgate_matrix = [] {
+    constexpr T r = 1 / std::numbers::sqrt2_v<T>;
+    return GateMatrix<T, 1>{{r, r,
+                             r, -r}};
+}();
+
+template <std::floating_point T>
+inline constexpr GateMatrix<T, 2> swapgate_matrix = {{1, 0, 0, 0,
+                                                      0, 0, 1, 0,
+                                                      0, 1, 0, 0,
+                                                      0, 0, 0, 1}};
+
+template <std::floating_point T>
+inline constexpr GateMatrix<T, 2> ecrgate_matrix = [] {
+    constexpr T r = 1 / std::numbers::sqrt2_v<T>;
+    return GateMatrix<T, 2>{{{{0, 0}, {0, 0}, {r, 0}, {0, r},
+                              {0, 0}, {0, 0}, {0, r}, {r, 0},
+                              {r, 0}, {0, -r}, {0, 0}, {0, 0},
+                              {0, -r}, {r, 0}, {0, 0}, {0, 0}}}};
+}();
+
+//------------------------------
+// parameterized gates
+//------------------------------
+
+/**
+ * @brief Get the matrix of a Pz gate, i.e., diag(1, e^{iθ})
+ *
+ * @tparam T
+ * @param phase
+ * @return GateMatrix<T, 1>
+ */
+template <std::floating_point T>
+GateMatrix<T, 1> pzgate_matrix(dvlab::Phase const& phase) {
+    return {{1, 0,
+             0, std::exp(std::complex<T>{0, dvlab::Phase::phase_to_floating_point<T>(phase)})}};
+}
+
+/**
+ * @brief Get the matrix of a Px gate, i.e., H Pz H
+ *
+ * @tparam T
+ * @param phase
+ * @return GateMatrix<T, 1>
+ */
+template <std::floating_point T>
+GateMatrix<T, 1> pxgate_matrix(dvlab::Phase const& phase) {
+    auto const e     = std::exp(std::complex<T>{0, dvlab::Phase::phase_to_floating_point<T>(phase)});
+    auto const plus  = (T{1} + e) / T{2};
+    auto const minus = (T{1} - e) / T{2};
+    return {{plus, minus,
+             minus, plus}};
+}
+
+/**
+ * @brief Get the matrix of a Py gate, i.e., S Px S†
+ *
+ * @tparam T
+ * @param phase
+ * @return GateMatrix<T, 1>
+ */
+template <std::floating_point T>
+GateMatrix<T, 1> pygate_matrix(dvlab::Phase const& phase) {
+    auto const e     = std::exp(std::complex<T>{0, dvlab::Phase::phase_to_floating_point<T>(phase)});
+    auto const plus  = (T{1} + e) / T{2};
+    auto const minus = (T{1} - e) / T{2};
+    return {{plus, std::complex<T>{0, -1} * minus,
+             std::complex<T>{0, 1} * minus, plus}};
+}
+
+/**
+ * @brief Get the global phase e^{-iθ/2} that turns a P-gate into the corresponding R-gate
+ *
+ * @tparam T
+ * @param phase
+ * @return std::complex<T>
+ */
+template <std::floating_point T>
+std::complex<T> rotation_global_phase(dvlab::Phase const& phase) {
+    return std::exp(std::complex<T>{0, T{-0.5} * dvlab::Phase::phase_to_floating_point<T>(phase)});
+}
+
+template <std::floating_point T>
+GateMatrix<T, 1> rzgate_matrix(dvlab::Phase const& phase) {
+    return pzgate_matrix<T>(phase) * rotation_global_phase<T>(phase);
+}
+
+template <std::floating_point T>
+GateMatrix<T, 1> rxgate_matrix(dvlab::Phase const& phase) {
+    return pxgate_matrix<T>(phase) * rotation_global_phase<T>(phase);
+}
+
+template <std::floating_point T>
+GateMatrix<T, 1> rygate_matrix(dvlab::Phase const& phase) {
+    return pygate_matrix<T>(phase) * rotation_global_phase<T>(phase);
+}
+
+}  // namespace qsyn::tensor
@@ -12,6 +12,7 @@
 #include <gsl/narrow>
 #include <tl/to.hpp>
 
+#include "./gate_matrix.hpp"
 #include "./tensor.hpp"
 #include "util/phase.hpp"
 #include "util/util.hpp"
@@ -46,36 +47,30 @@ public:
     static QTensor<T> zspider(size_t const& arity, dvlab::Phase const& phase = dvlab::Phase(0));
     static QTensor<T> xspider(size_t const& arity, dvlab::Phase const& phase = dvlab::Phase(0));
     static QTensor<T> hbox(size_t const& arity, DataType const& a = -1.);
-    static QTensor<T> xgate() {
-        using namespace std::literals;
-        return {{0. + 0.i, 1. + 0.i}, {1. + 0.i, 0. + 0.i}};
-    }
-    static QTensor<T> ygate() {
-        using namespace std::literals;
-        return {{0. + 0.i, 0. - 1.i}, {0. + 1.i, 0. + 0.i}};
-    }
-    static QTensor<T> zgate() {
-        using namespace std::literals;
-        return {{1. + 0.i, 0. + 0.i}, {0. + 0.i, -1. + 0.i}};
-    }
-    static QTensor<T> hgate() {
-        using namespace std::literals;
-        return {{1. / sqrt(2) + 0.i, 1. / sqrt(2) + 0.i}, {1. / sqrt(2) + 0.i, -1. / sqrt(2) + 0.i}};
-    }
-    static QTensor<T> rxgate(dvlab::Phase const& phase = dvlab::Phase(0));
-    static QTensor<T> rygate(dvlab::Phase const& phase = dvlab::Phase(0));
-    static QTensor<T> rzgate(dvlab::Phase const& phase = dvlab::Phase(0));
-    static QTensor<T> pxgate(dvlab::Phase const& phase = dvlab::Phase(0));
-    static QTensor<T> pygate(dvlab::Phase const& phase = dvlab::Phase(0));
-    static QTensor<T> pzgate(dvlab::Phase const& phase = dvlab::Phase(0));
+    static QTensor<T> xgate() { return from_gate_matrix(xgate_matrix<T>); }
+    static QTensor<T> ygate() { return from_gate_matrix(ygate_matrix<T>); }
+    static QTensor<T> zgate() { return from_gate_matrix(zgate_matrix<T>); }
+    static QTensor<T> hgate() { return from_gate_matrix(hgate_matrix<T>); }
+    static QTensor<T> rxgate(dvlab::Phase const& phase = dvlab::Phase(0)) { return from_gate_matrix(rxgate_matrix<T>(phase)); }
+    static QTensor<T> rygate(dvlab::Phase const& phase = dvlab::Phase(0)) { return from_gate_matrix(rygate_matrix<T>(phase)); }
+    static QTensor<T> rzgate(dvlab::Phase const& phase = dvlab::Phase(0)) { return from_gate_matrix(rzgate_matrix<T>(phase)); }
+    static QTensor<T> pxgate(dvlab::Phase const& phase = dvlab::Phase(0)) { return from_gate_matrix(pxgate_matrix<T>(phase)); }
+    static QTensor<T> pygate(dvlab::Phase const& phase = dvlab::Phase(0)) { return from_gate_matrix(pygate_matrix<T>(phase)); }
+    static QTensor<T> pzgate(dvlab::Phase const& phase = dvlab::Phase(0)) { return from_gate_matrix(pzgate_matrix<T>(phase)); }
     static QTensor<T> control(QTensor<T> const& gate, size_t n_ctrls = 1);
 
+    template <size_t N>
+    static QTensor<T> from_gate_matrix(GateMatrix<T, N> const& matrix);
+
     QTensor<T> self_tensor_dot(TensorAxisList const& ax1 = {}, TensorAxisList const& ax2 = {});
 
     QTensor<T> to_qtensor() const;
 
     QTensor<T> to_su2() const;
 
+    template <typename U>
+    QTensor<U> astype() const;
+
     template <typename U>
     friend std::complex<U> global_scalar_factor(QTensor<U> const& t1, QTensor<U> const& t2);
 
@@ -101,6 +96,7 @@ public:
 private:
     friend struct fmt::formatter<QTensor>;
     static DataType _nu_pow(int n);
+    static size_t _interleaved_index(size_t row, size_t col, size_t n_qubits);
 
     std::string _filename;
     std::vector<std::string> _procedures;
@@ -193,89 +189,25 @@ QTensor<T> QTensor<T>::hbox(size_t const& arity, QTensor<T>::DataType const& a)
 }
 
 /**
- * @brief Generate an tensor that corresponds to a Rx gate. Axis order: <in, out>
+ * @brief Generate the tensor of a gate from its matrix, writing each entry directly to its place. Axis order: <out, in, out, in, ...>
  *
  * @tparam T
- * @param phase
+ * @tparam N number of qubits
+ * @param matrix
  * @return QTensor<T>
  */
 template <typename T>
-QTensor<T> QTensor<T>::rxgate(dvlab::Phase const& phase) {
-    using namespace std::literals;
-    auto t = QTensor<T>::pxgate(phase);
-    t._tensor *= std::exp(-0.5i * dvlab::Phase::phase_to_floating_point<T>(phase));
-    return t;
-}
-
-/**
- * @brief Generate an tensor that corresponds to a Ry gate. Axis order: <in, out>
- *
- * @tparam T
- * @param phase
- * @return QTensor<T>
- */
-template <typename T>
-QTensor<T> QTensor<T>::rygate(dvlab::Phase const& phase) {
-    using namespace std::literals;
-    auto t = QTensor<T>::pygate(phase);
-    t._tensor *= std::exp(-0.5i * dvlab::Phase::phase_to_floating_point<T>(phase));
-    return t;
-}
-
-/**
- * @brief Generate an tensor that corresponds to a Rz gate. Axis order: <in, out>
- *
- * @tparam T
- * @param phase
- * @return QTensor<T>
- */
-template <typename T>
-QTensor<T> QTensor<T>::rzgate(dvlab::Phase const& phase) {
-    using namespace std::literals;
-    auto t = QTensor<T>::pzgate(phase);
-    t._tensor *= std::exp(-0.5i * dvlab::Phase::phase_to_floating_point<T>(phase));
+template <size_t N>
+QTensor<T> QTensor<T>::from_gate_matrix(GateMatrix<T, N> const& matrix) {
+    QTensor<T> t(TensorShape(2 * N, 2));
+    for (size_t row = 0; row < matrix.dimension; ++row) {
+        for (size_t col = 0; col < matrix.dimension; ++col) {
+            t._tensor.flat(_interleaved_index(row, col, N)) = matrix(row, col);
+        }
+    }
     return t;
 }
 
-/**
- * @brief Generate an tensor that corresponds to a Px gate. Axis order: <in, out>
- *
- * @tparam T
- * @param phase
- * @return QTensor<T>
- */
-template <typename T>
-QTensor<T> QTensor<T>::pxgate(dvlab::Phase const& phase) {
-    return QTensor<T>::xspider(2, phase);
-}
-
-/**
- * @brief Generate an tensor that corresponds to a Py gate. Axis order: <in, out>
- *
- * @tparam T
- * @param phase
- * @return QTensor<T>
- */
-template <typename T>
-QTensor<T> QTensor<T>::pygate(dvlab::Phase const& phase) {
-    auto sdg = QTensor<T>::pzgate(dvlab::Phase(-1, 2));
-    auto px  = QTensor<T>::pxgate(phase);
-    auto s   = QTensor<T>::pzgate(dvlab::Phase(1, 2));
-    return tensordot(s, tensordot(px, sdg, {1}, {0}), {1}, {0});
-}
-
-/**
- * @brief Generate an tensor that corresponds to a Pz gate. Axis order: <in, out>
- *
- * @tparam T
- * @param phase
- * @return QTensor<T>
- */
-template <typename T>
-QTensor<T> QTensor<T>::pzgate(dvlab::Phase const& phase) {
-    return QTensor<T>::zspider(2, phase);
-}
-
 //------------------------------
 // tensor manipulation functions
 //------------------------------
@@ -329,6 +261,22 @@ QTensor<T> QTensor<T>::to_qtensor() const {
     return result.transpose(ax);
 }
 
+/**
+ * @brief Convert the tensor to another floating-point precision. The filename and procedures are kept.
+ *
+ * @tparam T
+ * @tparam U the target floating-point type
+ * @return QTensor<U>
+ */
+template <typename T>
+template <typename U>
+QTensor<U> QTensor<T>::astype() const {
+    QTensor<U> result = xt::cast<std::complex<U>>(this->_tensor);
+    result.set_filename(_filename);
+    result.add_procedures(_procedures);
+    return result;
+}
+
 template <typename T>
 QTensor<T> QTensor<T>::to_su2() const {
     return std::sqrt(1.0 / this->determinant()) * this->_tensor;
@@ -351,24 +299,23 @@ QTensor<T> QTensor<T>::control(QTensor<T> const& gate, size_t n_ctrls) {
 
     assert(dim % 2 == 0);
 
-    TensorAxisList ax;
+    auto const n_targets = dim / 2;
+    auto const n_qubits  = n_targets + n_ctrls;
+    auto const gate_size = int_pow(2, n_targets);
+    // the gate acts on the bottom-right block, where all controls are |1>
+    auto const offset = gate_size * (int_pow(2, n_ctrls) - 1);
 
-    for (size_t i = 0; i < dim / 2; ++i) {
-        ax.emplace_back(2 * i);
+    QTensor<T> result = xt::zeros<DataType>(TensorShape(2 * n_qubits, 2));
+    for (size_t i = 0; i < offset; ++i) {
+        result._tensor.flat(_interleaved_index(i, i, n_qubits)) = 1;
     }
-    for (size_t i = 0; i < dim / 2; ++i) {
-        ax.emplace_back(2 * i + 1);
+    for (size_t row = 0; row < gate_size; ++row) {
+        for (size_t col = 0; col < gate_size; ++col) {
+            result._tensor.flat(_interleaved_index(offset + row, offset + col, n_qubits)) =
+                gate._tensor.flat(_interleaved_index(row, col, n_targets));
+        }
     }
-
-    auto const gate_size     = int_pow(2, dim / 2);
-    auto const identity_size = gate_size * (int_pow(2, n_ctrls) - 1);
-
-    QTensor<T> const identity = xt::eye({identity_size, identity_size});
-    QTensor<T> gate_matrix    = gate.transpose(ax);
-    gate_matrix.reshape({gate_size, gate_size});
-
-    QTensor<T> const result = direct_sum(identity, gate_matrix);
-    return result.to_qtensor();
+    return result;
 }
 
 /**
@@ -432,6 +379,25 @@ typename QTensor<T>::DataType QTensor<T>::_nu_pow(int n) {
     return std::pow(2., -0.25 * n);
 }
 
+/**
+ * @brief Get the flat index of the matrix entry (row, col) in a row-major tensor with axis order <out, in, out, in, ...>,
+ *        where the first qubit is the most significant bit of the row and column indices
+ *
+ * @tparam T
+ * @param row
+ * @param col
+ * @param n_qubits
+ * @return size_t
+ */
+template <typename T>
+size_t QTensor<T>::_interleaved_index(size_t row, size_t col, size_t n_qubits) {
+    size_t index = 0;
+    for (size_t i = n_qubits; i-- > 0;) {
+        index = (index << 2) | (((row >> i) & 1) << 1) | ((col >> i) & 1);
+    }
+    return index;
+}
+
 /**
  * @brief convert the tensor to a matrix. this function overload assumes that the tensor is an 2^n x 2^n tensor and the pin order is even for input and odd for output
  *
@@ -7,20 +7,263 @@
 
 #include "./solovay_kitaev.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <ranges>
 #include <sul/dynamic_bitset.hpp>
+#include <tuple>
+#include <unordered_map>
 
 #include "qcir/basic_gate_type.hpp"
+#include "util/parallel.hpp"
+
+extern bool stop_requested();
 
 namespace qsyn::tensor {
 
+namespace {
+
+constexpr double tolerance       = 1e-12;
+constexpr uint64_t net_file_magic = 0x31'54'45'4e'4b'53'51;  // "QSKNET1"
+constexpr uint64_t max_net_depth  = 32;                       // keeps num_words from overflowing on corrupt files
+
+/**
+ * @brief Multiply two SU(2) matrices in quaternion form, i.e., the Hamilton product
+ *
+ */
+Quaternion multiply(Quaternion const& p, Quaternion const& q) {
+    return {
+        p[0] * q[0] - p[1] * q[1] - p[2] * q[2] - p[3] * q[3],
+        p[0] * q[1] + q[0] * p[1] + p[2] * q[3] - p[3] * q[2],
+        p[0] * q[2] + q[0] * p[2] + p[3] * q[1] - p[1] * q[3],
+        p[0] * q[3] + q[0] * p[3] + p[1] * q[2] - p[2] * q[1],
+    };
+}
+
+double distance(Quaternion const& p, Quaternion const& q) {
+    return std::sqrt(
+        (p[0] - q[0]) * (p[0] - q[0]) +
+        (p[1] - q[1]) * (p[1] - q[1]) +
+        (p[2] - q[2]) * (p[2] - q[2]) +
+        (p[3] - q[3]) * (p[3] - q[3]));
+}
+
+size_t num_words(size_t depth) {
+    return (size_t{1} << (depth + 1)) - 2;
+}
+
+/**
+ * @brief Get the id of the j-th word of length `length`. Words are ordered first by length, then by value.
+ *
+ */
+size_t word_id(size_t length, size_t value) {
+    return (size_t{1} << length) - 2 + value;
+}
+
+}  // namespace
+
+/**
+ * @brief Get the base approximations of the given depth. The nets are built once per depth and shared.
+ *        If `cache_dir` is specified, the net is loaded from the file of that depth in the directory,
+ *        or saved there if the file does not exist yet, even if the net has already been built in this session.
+ *
+ * @param depth the maximum length of the H/T words
+ * @param cache_dir
+ * @return std::shared_ptr<SolovayKitaevNet const>
+ */
+std::shared_ptr<SolovayKitaevNet const> SolovayKitaevNet::get(size_t depth, std::optional<std::filesystem::path> const& cache_dir) {
+    static std::mutex mutex;
+    static std::unordered_map<size_t, std::shared_ptr<SolovayKitaevNet const>> nets;
+
+    std::lock_guard const lock{mutex};
+
+    auto const filepath = cache_dir.has_value()
+                              ? std::make_optional(*cache_dir / fmt::format("sk_net_depth_{}.bin", depth))
+                              : std::nullopt;
+
+    if (filepath.has_value() && std::filesystem::exists(*filepath)) {
+        auto net = std::shared_ptr<SolovayKitaevNet>(new SolovayKitaevNet());
+        if (net->_read(*filepath, depth)) {
+            spdlog::info("Loaded the gate list of depth {} from {}", depth, filepath->string());
+            nets.insert_or_assign(depth, net);
+            return net;
+        }
+        spdlog::warn("Failed to load the gate list from {}; rebuilding...", filepath->string());
+    }
+
+    auto it = nets.find(depth);
+    if (it == nets.end()) {
+        it = nets.emplace(depth, std::make_shared<SolovayKitaevNet>(depth)).first;
+    }
+
+    if (filepath.has_value()) {
+        if (it->second->_write(*filepath)) {
+            spdlog::info("Saved the gate list of depth {} to {}", depth, filepath->string());
+        } else {
+            spdlog::warn("Failed to save the gate list to {}", filepath->string());
+        }
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief Build the base approximations by concatenating Hs and Ts. Each word is obtained from its prefix with one multiplication.
+ *
+ * @param depth
+ */
+SolovayKitaevNet::SolovayKitaevNet(size_t depth) : _depth{depth} {
+    auto const h        = to_quaternion(QTensor<double>::hgate().to_su2());
+    auto const t        = to_quaternion(QTensor<double>::pzgate(Phase(1, 4)).to_su2());
+    auto const identity = Quaternion{1., 0., 0., 0.};
+
+    _points.reserve(num_words(depth));
+    for (size_t length = 1; length <= depth; ++length) {
+        auto const last_bit = length - 1;
+        auto const mask     = (size_t{1} << last_bit) - 1;
+        for (size_t value = 0; value < (size_t{1} << length); ++value) {
+            auto const prefix = length == 1 ? identity : _points[word_id(last_bit, value & mask)];
+            _points.emplace_back(multiply(prefix, ((value >> last_bit) & 1) ? t : h));
+        }
+    }
+
+    _tree.resize(_points.size());
+    std::iota(_tree.begin(), _tree.end(), 0);
+    _axes.resize(_points.size());
+    _build_tree(0, _tree.size());
+}
+
+/**
+ * @brief Get the word of the base approximation. Bit 1 stands for a T gate, and bit 0 for an H gate.
+ *
+ * @param index
+ * @return sul::dynamic_bitset<>
+ */
+sul::dynamic_bitset<> SolovayKitaevNet::word(size_t index) const {
+    auto const length = static_cast<size_t>(std::bit_width(index + 2)) - 1;
+    return sul::dynamic_bitset<>(length, index + 2 - (size_t{1} << length));
+}
+
+/**
+ * @brief Find the base approximation closest to q. Ties are broken by the word id.
+ *
+ * @param q
+ * @return SolovayKitaevNet::Neighbor
+ */
+SolovayKitaevNet::Neighbor SolovayKitaevNet::nearest(Quaternion const& q) const {
+    Neighbor best{std::numeric_limits<size_t>::max(), std::numeric_limits<double>::infinity()};
+    _search(0, _tree.size(), q, best);
+    return best;
+}
+
+void SolovayKitaevNet::_build_tree(size_t lo, size_t hi) {
+    if (hi - lo <= 1) return;
+
+    // split along the coordinate with the largest spread
+    Quaternion lower, upper;
+    lower.fill(std::numeric_limits<double>::infinity());
+    upper.fill(-std::numeric_limits<double>::infinity());
+    for (size_t i = lo; i < hi; ++i) {
+        for (size_t k = 0; k < 4; ++k) {
+            lower[k] = std::min(lower[k], _points[_tree[i]][k]);
+            upper[k] = std::max(upper[k], _points[_tree[i]][k]);
+        }
+    }
+    size_t axis = 0;
+    for (size_t k = 1; k < 4; ++k) {
+        if (upper[k] - lower[k] > upper[axis] - lower[axis]) axis = k;
+    }
+
+    auto const mid = lo + (hi - lo) / 2;
+    std::nth_element(
+        _tree.begin() + gsl::narrow<std::ptrdiff_t>(lo),
+        _tree.begin() + gsl::narrow<std::ptrdiff_t>(mid),
+        _tree.begin() + gsl::narrow<std::ptrdiff_t>(hi),
+        [this, axis](size_t a, size_t b) { return _points[a][axis] < _points[b][axis]; });
+    _axes[mid] = gsl::narrow<unsigned char>(axis);
+
+    _build_tree(lo, mid);
+    _build_tree(mid + 1, hi);
+}
+
+void SolovayKitaevNet::_search(size_t lo, size_t hi, Quaternion const& q, Neighbor& best) const {
+    if (lo >= hi) return;
+
+    auto const mid   = lo + (hi - lo) / 2;
+    auto const index = _tree[mid];
+    auto const dist  = distance(_points[index], q);
+    if (dist < best.distance - tolerance || (dist <= best.distance + tolerance && index < best.index)) {
+        best = {index, dist};
+    }
+
+    if (hi - lo == 1) return;
+
+    auto const diff = q[_axes[mid]] - _points[index][_axes[mid]];
+    if (diff < 0) {
+        _search(lo, mid, q, best);
+        if (-diff <= best.distance + tolerance) _search(mid + 1, hi, q, best);
+    } else {
+        _search(mid + 1, hi, q, best);
+        if (diff <= best.distance + tolerance) _search(lo, mid, q, best);
+    }
+}
+
 /**
- * @brief Initialize binary list
+ * @brief Load the net from a file written by `_write`. The file is rejected if it is of another depth, or if the KD-tree is corrupt.
  *
+ * @param path
+ * @param depth the depth the file is expected to hold
+ * @return true if the net is loaded
  */
-void SolovayKitaev::_init_binary_list() {
-    for (size_t i = 1; i <= _depth; i++)
-        for (size_t j = 0; j < gsl::narrow<size_t>(std::pow(2, i)); j++)
-            _binary_list.emplace_back(sul::dynamic_bitset<>(i, j));
+bool SolovayKitaevNet::_read(std::filesystem::path const& path, size_t depth) {
+    std::ifstream fin{path, std::ios::binary};
+    if (!fin.is_open()) return false;
+
+    uint64_t magic = 0, stored_depth = 0, size = 0;
+    fin.read(reinterpret_cast<char*>(&magic), sizeof(magic));                // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast) : binary I/O
+    fin.read(reinterpret_cast<char*>(&stored_depth), sizeof(stored_depth));  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast) : binary I/O
+    fin.read(reinterpret_cast<char*>(&size), sizeof(size));                  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast) : binary I/O
+    if (!fin || magic != net_file_magic || stored_depth != depth || stored_depth > max_net_depth || size != num_words(stored_depth)) return false;
+
+    _depth = depth;
+    _points.resize(size);
+    _tree.resize(size);
+    _axes.resize(size);
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast) : binary I/O
+    fin.read(reinterpret_cast<char*>(_points.data()), gsl::narrow<std::streamsize>(size * sizeof(Quaternion)));
+    fin.read(reinterpret_cast<char*>(_tree.data()), gsl::narrow<std::streamsize>(size * sizeof(size_t)));
+    fin.read(reinterpret_cast<char*>(_axes.data()), gsl::narrow<std::streamsize>(size * sizeof(unsigned char)));
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (!fin) return false;
+
+    // the search indexes the points with the tree and the quaternions with the axes
+    return std::ranges::all_of(_tree, [size](size_t index) { return index < size; }) &&
+           std::ranges::all_of(_axes, [](unsigned char axis) { return axis < 4; });
+}
+
+bool SolovayKitaevNet::_write(std::filesystem::path const& path) const {
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    std::ofstream fout{path, std::ios::binary};
+    if (!fout.is_open()) return false;
+
+    uint64_t const depth = _depth, size = _points.size();
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast) : binary I/O
+    fout.write(reinterpret_cast<char const*>(&net_file_magic), sizeof(net_file_magic));
+    fout.write(reinterpret_cast<char const*>(&depth), sizeof(depth));
+    fout.write(reinterpret_cast<char const*>(&size), sizeof(size));
+    fout.write(reinterpret_cast<char const*>(_points.data()), gsl::narrow<std::streamsize>(size * sizeof(Quaternion)));
+    fout.write(reinterpret_cast<char const*>(_tree.data()), gsl::narrow<std::streamsize>(size * sizeof(size_t)));
+    fout.write(reinterpret_cast<char const*>(_axes.data()), gsl::narrow<std::streamsize>(size * sizeof(unsigned char)));
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+
+    return static_cast<bool>(fout);
 }
 
 /**
@@ -39,8 +282,9 @@ std::vector<int> SolovayKitaev::_adjoint_gate_sequence(std::vector<int> sequence
  * @brief Remove redundant gates
  *
  * @param gate_sequence
+ * @return size_t the number of removed gates
  */
-void SolovayKitaev::_remove_redundant_gates(std::vector<int>& gate_sequence) const {
+size_t SolovayKitaev::_remove_redundant_gates(std::vector<int>& gate_sequence) const {
     const size_t original_count = gate_sequence.size();
     size_t counter_rotate       = 0;
     std::vector<int> optimized_sequence;
@@ -74,24 +318,125 @@ void SolovayKitaev::_remove_redundant_gates(std::vector<int>& gate_sequence) con
         gate_sequence = optimized_sequence;
         optimized_sequence.clear();
     }
-    spdlog::info("Remove {} redundant gates", original_count - gate_sequence.size());
+    return original_count - gate_sequence.size();
 }
 
 /**
  * @brief Save gates in sequence into QCir
  *
  * @param gate_sequence
+ * @return QCir
  */
-void SolovayKitaev::_save_gates(const std::vector<int>& gate_sequence) {
-    _quantum_circuit.add_qubits(1);
+QCir SolovayKitaev::_save_gates(const std::vector<int>& gate_sequence) const {
+    QCir quantum_circuit{1};
     for (const int& bit : gate_sequence) {
         if (bit == 0) {
-            _quantum_circuit.prepend(qcir::HGate(), {0});
+            quantum_circuit.prepend(qcir::HGate(), {0});
         } else {
-            _quantum_circuit.prepend(qcir::PZGate(Phase(bit, 4)), {0});
+            quantum_circuit.prepend(qcir::PZGate(Phase(bit, 4)), {0});
+        }
+    }
+    spdlog::info("Decompose tensor into {} gates.", quantum_circuit.get_num_gates());
+    return quantum_circuit;
+}
+
+namespace {
+
+/**
+ * @brief Get the phase of a single-qubit rotation, or std::nullopt if the operation is not one
+ *
+ * @param op
+ * @return std::optional<dvlab::Phase>
+ */
+std::optional<dvlab::Phase> get_rotation_phase(qcir::Operation const& op) {
+    if (auto const gate = op.get_underlying_if<qcir::PZGate>()) return gate->get_phase();
+    if (auto const gate = op.get_underlying_if<qcir::PXGate>()) return gate->get_phase();
+    if (auto const gate = op.get_underlying_if<qcir::PYGate>()) return gate->get_phase();
+    if (auto const gate = op.get_underlying_if<qcir::RZGate>()) return gate->get_phase();
+    if (auto const gate = op.get_underlying_if<qcir::RXGate>()) return gate->get_phase();
+    if (auto const gate = op.get_underlying_if<qcir::RYGate>()) return gate->get_phase();
+    return std::nullopt;
+}
+
+/**
+ * @brief Check if the gate is a single-qubit rotation whose angle is not a multiple of π/4
+ *
+ */
+bool is_non_clifford_t_rotation(qcir::QCirGate const& gate) {
+    auto const phase = get_rotation_phase(gate.get_operation());
+    return phase.has_value() && phase->denominator() > 4;
+}
+
+}  // namespace
+
+/**
+ * @brief Decompose every single-qubit rotation whose angle is not a multiple of π/4 into H and T gates, up to global phases.
+ *        Identical rotations are approximated only once, and the distinct ones are approximated in parallel.
+ *        Other gates are kept as is.
+ *
+ * @param qcir
+ * @param num_threads number of threads. If 0, use the hardware concurrency.
+ * @return std::optional<QCir>
+ */
+std::optional<QCir> SolovayKitaev::decompose_rotations(QCir const& qcir, size_t num_threads) const {
+    if (_depth == 0) {
+        spdlog::error("The depth of the gate list should be positive!!");
+        return std::nullopt;
+    }
+
+    // memo table: operation -> index into the approximations
+    std::unordered_map<qcir::Operation, size_t, qcir::OperationHash> memo;
+    std::vector<qcir::Operation> distinct_ops;
+    size_t num_rotations = 0;
+    for (auto const* gate : qcir.get_gates()) {
+        if (!is_non_clifford_t_rotation(*gate)) continue;
+        ++num_rotations;
+        if (memo.emplace(gate->get_operation(), distinct_ops.size()).second) {
+            distinct_ops.emplace_back(gate->get_operation());
         }
     }
-    spdlog::info("Decompose tensor into {} gates.", _quantum_circuit.get_num_gates());
+
+    spdlog::info("Approximating {} rotations ({} distinct) with gate list depth {} and {} recursions...", num_rotations, distinct_ops.size(), _depth, _recursion);
+
+    std::vector<std::vector<int>> sequences(distinct_ops.size());
+    std::vector<double> distances(distinct_ops.size());
+    dvlab::utils::parallel_for(
+        distinct_ops.size(),
+        [&](size_t i) {
+            if (stop_requested()) return;
+            auto const matrix = to_tensor(distinct_ops[i]);
+            assert(matrix.has_value());
+            std::tie(sequences[i], distances[i]) = _approximate(*matrix);
+            _remove_redundant_gates(sequences[i]);
+        },
+        num_threads);
+
+    if (stop_requested()) {
+        spdlog::warn("Decomposition interrupted.");
+        return std::nullopt;
+    }
+
+    QCir result{qcir.get_num_qubits()};
+    for (auto const* gate : qcir.get_gates()) {
+        if (!is_non_clifford_t_rotation(*gate)) {
+            result.append(*gate);
+            continue;
+        }
+        auto const qubit = gate->get_qubit(0);
+        // the sequence is a matrix product, so the last gate is applied first
+        for (auto const bit : sequences[memo.at(gate->get_operation())] | std::views::reverse) {
+            if (bit == 0) {
+                result.append(qcir::HGate(), {qubit});
+            } else {
+                result.append(qcir::PZGate(Phase(bit, 4)), {qubit});
+            }
+        }
+    }
+
+    spdlog::info("Maximum trace distance: {:.6f}", distances.empty() ? 0. : std::ranges::max(distances));
+    spdlog::info("Decompose QCir into {} gates.", result.get_num_gates());
+
+    return result;
 }
 
 }  // namespace qsyn::tensor
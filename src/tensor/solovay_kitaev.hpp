@@ -10,7 +10,11 @@
 #include <fmt/core.h>
 #include <spdlog/spdlog.h>
 
+#include <array>
 #include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <optional>
 #include <sul/dynamic_bitset.hpp>
 #include <tl/to.hpp>
 #include <vector>
@@ -29,45 +33,126 @@ using BinaryList = std::vector<sul::dynamic_bitset<>>;
 
 namespace tensor {
 
+// SU(2) element q0 I - i (q1 X + q2 Y + q3 Z), stored as [q0, q1, q2, q3]
+using Quaternion = std::array<double, 4>;
+
+template <typename U>
+Quaternion to_quaternion(QTensor<U> const& u);
+template <typename U>
+QTensor<U> to_su2_tensor(Quaternion const& q);
+
+/**
+ * @brief The base approximations of the Solovay-Kitaev algorithm, i.e., all H/T words up to a given length.
+ *        The words are stored as SU(2) quaternions and indexed by a KD-tree. For SU(2) matrices,
+ *        the trace distance coincides with the Euclidean distance between the quaternions.
+ *        Nets are immutable and shared across decompositions through `SolovayKitaevNet::get`.
+ */
+class SolovayKitaevNet {
+public:
+    struct Neighbor {
+        size_t index;
+        double distance;
+    };
+
+    static std::shared_ptr<SolovayKitaevNet const> get(size_t depth, std::optional<std::filesystem::path> const& cache_dir = std::nullopt);
+
+    size_t depth() const { return _depth; }
+    size_t size() const { return _points.size(); }
+
+    Quaternion const& quaternion(size_t index) const { return _points[index]; }
+    sul::dynamic_bitset<> word(size_t index) const;
+    Neighbor nearest(Quaternion const& q) const;
+
+    explicit SolovayKitaevNet(size_t depth);
+
+private:
+    size_t _depth;
+    std::vector<Quaternion> _points;   // indexed by word id
+    std::vector<size_t> _tree;         // implicit KD-tree: median of [lo, hi) sits at the middle
+    std::vector<unsigned char> _axes;  // split axis of the node at each tree position
+
+    SolovayKitaevNet() = default;
+
+    void _build_tree(size_t lo, size_t hi);
+    void _search(size_t lo, size_t hi, Quaternion const& q, Neighbor& best) const;
+
+    bool _read(std::filesystem::path const& path, size_t depth);
+    bool _write(std::filesystem::path const& path) const;
+};
+
 class SolovayKitaev {
 public:
     // clang-format off
     // clang-format-17 formats this line in a weird way
-    SolovayKitaev(size_t d, size_t r) : _depth(d), _recursion(r) {};
+    SolovayKitaev(size_t d, size_t r, std::optional<std::filesystem::path> const& net_cache_dir = std::nullopt) : _depth(d), _recursion(r), _net(SolovayKitaevNet::get(d, net_cache_dir)) {};
     // clang-format on
 
     template <typename U>
-    std::optional<QCir> solovay_kitaev_decompose(QTensor<U> const& matrix);
+    std::optional<QCir> solovay_kitaev_decompose(QTensor<U> const& matrix) const;
+
+    std::optional<QCir> decompose_rotations(QCir const& qcir, size_t num_threads = 0) const;
 
 private:
     size_t _depth;
     size_t _recursion;
-    BinaryList _binary_list;
-    QCir _quantum_circuit;
+    std::shared_ptr<SolovayKitaevNet const> _net;
 
     template <typename U>
-    std::vector<QTensor<U>> _create_gate_list() const;
+    std::pair<std::vector<int>, U> _approximate(QTensor<U> const& matrix) const;
+
     template <typename U>
     QTensor<U> _diagonalize(const QTensor<U>& u) const;
 
     template <typename U>
-    QTensor<U> _find_and_insert_closest_u(const std::vector<QTensor<U>>& gate_list, const QTensor<U>& u, std::vector<int>& output_gate) const;
+    QTensor<U> _find_and_insert_closest_u(const QTensor<U>& u, std::vector<int>& output_gate) const;
 
     template <typename U>
     std::pair<QTensor<U>, QTensor<U>> _group_commutator_decompose(const QTensor<U>& u) const;
 
     template <typename U>
-    QTensor<U> _solovay_kitaev_iteration(const std::vector<QTensor<U>>& gate_list, const QTensor<U>& u, size_t n, std::vector<int>& output_gate) const;
+    QTensor<U> _solovay_kitaev_iteration(const QTensor<U>& u, size_t n, std::vector<int>& output_gate) const;
 
     template <typename U>
     std::vector<std::complex<U>> _to_bloch(const QTensor<U>& u) const;
 
-    void _init_binary_list();
     std::vector<int> _adjoint_gate_sequence(std::vector<int> sequence) const;
-    void _remove_redundant_gates(std::vector<int>& gate_sequence) const;
-    void _save_gates(const std::vector<int>& gate_sequence);
+    size_t _remove_redundant_gates(std::vector<int>& gate_sequence) const;
+    QCir _save_gates(const std::vector<int>& gate_sequence) const;
 };
 
+/**
+ * @brief Get the quaternion coordinates of an SU(2) matrix
+ *
+ * @tparam U
+ * @param u
+ * @return Quaternion
+ */
+template <typename U>
+Quaternion to_quaternion(QTensor<U> const& u) {
+    assert(u.dimension() == 2);
+    std::complex<U> const half_i{0, 0.5};
+    return {
+        static_cast<double>(((u(0, 0) + u(1, 1)) / U(2)).real()),
+        static_cast<double>(((u(0, 1) + u(1, 0)) * half_i).real()),
+        static_cast<double>(((u(1, 0) - u(0, 1)) / U(2)).real()),
+        static_cast<double>(((u(0, 0) - u(1, 1)) * half_i).real()),
+    };
+}
+
+/**
+ * @brief Get the SU(2) matrix of a quaternion
+ *
+ * @tparam U
+ * @param q
+ * @return QTensor<U>
+ */
+template <typename U>
+QTensor<U> to_su2_tensor(Quaternion const& q) {
+    using C = std::complex<U>;
+    return {{C(q[0], -q[3]), C(-q[2], -q[1])},
+            {C(q[2], -q[1]), C(q[0], q[3])}};
+}
+
 /**
  * @brief
  *
@@ -78,32 +163,48 @@ private:
  * @reference https://github.com/qcc4cp/qcc/blob/main/src/solovay_kitaev.py
  */
 template <typename U>
-std::optional<QCir> SolovayKitaev::solovay_kitaev_decompose(QTensor<U> const& matrix) {
+std::optional<QCir> SolovayKitaev::solovay_kitaev_decompose(QTensor<U> const& matrix) const {
     assert(matrix.dimension() == 2);
 
     spdlog::info("Gate list depth: {0}, #Recursions: {1}", _depth, _recursion);
 
-    spdlog::debug("Creating gate list");
-    _init_binary_list();
-    const std::vector<QTensor<U>> gate_list = _create_gate_list<U>();
+    if (_depth == 0) {
+        spdlog::error("The depth of the gate list should be positive!!");
+        return std::nullopt;
+    }
 
     spdlog::debug("Performing SK algorithm");
-    std::vector<int> output_gates;
-    const U tr_dist = trace_distance(matrix, _solovay_kitaev_iteration(gate_list, matrix, _recursion, output_gates));
+    auto [output_gates, tr_dist] = _approximate(matrix);
 
     fmt::println("\nTrace distance: {:.{}f}\n", tr_dist, 6);
 
-    _remove_redundant_gates(output_gates);
+    spdlog::info("Remove {} redundant gates", _remove_redundant_gates(output_gates));
 
-    _save_gates(output_gates);
-    return _quantum_circuit;
+    return _save_gates(output_gates);
+}
+
+/**
+ * @brief Approximate the matrix up to a global phase. This function does not log or print anything,
+ *        so it can be used to decompose many matrices.
+ *
+ * @tparam U
+ * @param matrix
+ * @return std::pair<std::vector<int>, U> the gate sequence (1: T, -1: TDG, 0: H) and its trace distance to the matrix
+ */
+template <typename U>
+std::pair<std::vector<int>, U> SolovayKitaev::_approximate(QTensor<U> const& matrix) const {
+    // the base approximations are in SU(2), so the target is normalized first
+    auto const target = matrix.to_su2();
+
+    std::vector<int> output_gates;
+    const U tr_dist = trace_distance(target, _solovay_kitaev_iteration(target, _recursion, output_gates));
+    return {output_gates, tr_dist};
 }
 
 /**
  * @brief
  *
  * @tparam U
- * @param gate_list usable gates
  * @param u
  * @param recursion number of recursions
  * @param output_gate 1: T, -1: TDG, 0: H
@@ -112,16 +213,16 @@ std::optional<QCir> SolovayKitaev::solovay_kitaev_decompose(QTensor<U> const& ma
  * @reference https://github.com/qcc4cp/qcc/blob/main/src/solovay_kitaev.py
  */
 template <typename U>
-QTensor<U> SolovayKitaev::_solovay_kitaev_iteration(const std::vector<QTensor<U>>& gate_list, const QTensor<U>& u, size_t recursion, std::vector<int>& output_gate) const {
+QTensor<U> SolovayKitaev::_solovay_kitaev_iteration(const QTensor<U>& u, size_t recursion, std::vector<int>& output_gate) const {
     if (recursion == 0) {
-        return _find_and_insert_closest_u(gate_list, u, output_gate);
+        return _find_and_insert_closest_u(u, output_gate);
     } else {
         std::vector<int> output_gate_u_prev, output_gate_v_prev, output_gate_w_prev;
-        const QTensor<U> u_prev = _solovay_kitaev_iteration(gate_list, u, recursion - 1, output_gate_u_prev);
+        const QTensor<U> u_prev = _solovay_kitaev_iteration(u, recursion - 1, output_gate_u_prev);
         const QTensor<U> u_mult = tensor_multiply(u, adjoint(u_prev));
         auto const& [v, w]      = _group_commutator_decompose(u_mult);
-        const QTensor<U> v_prev = _solovay_kitaev_iteration(gate_list, v, recursion - 1, output_gate_v_prev);
-        const QTensor<U> w_prev = _solovay_kitaev_iteration(gate_list, w, recursion - 1, output_gate_w_prev);
+        const QTensor<U> v_prev = _solovay_kitaev_iteration(v, recursion - 1, output_gate_v_prev);
+        const QTensor<U> w_prev = _solovay_kitaev_iteration(w, recursion - 1, output_gate_w_prev);
 
         // NOTE - prepare adjointed gate sequence
         const std::vector<int> output_gate_v_prev_adjoint = _adjoint_gate_sequence(output_gate_v_prev);
@@ -140,31 +241,21 @@ QTensor<U> SolovayKitaev::_solovay_kitaev_iteration(const std::vector<QTensor<U>
 }
 
 /**
- * @brief Find and insert the closest unitary
+ * @brief Find and insert the closest unitary in the base approximations
  *
  * @tparam U
- * @param gate_list
  * @param u
  * @param output_gate
  * @return QTensor<U>
  */
 template <typename U>
-QTensor<U> SolovayKitaev::_find_and_insert_closest_u(const std::vector<QTensor<U>>& gate_list, const QTensor<U>& u, std::vector<int>& output_gate) const {
-    U min_dist       = 10;
-    QTensor<U> min_u = QTensor<U>::identity(1);
-
-    size_t min_index = 0;
-    for (size_t i = 0; i < gate_list.size(); i++) {
-        const U tr_dist = trace_distance(gate_list[i], u);
-        if (min_dist - tr_dist > pow(10, -12)) {
-            min_dist  = tr_dist;
-            min_u     = gate_list[i];
-            min_index = i;
-        }
-    }
-    for (size_t i = 0; i < _binary_list[min_index].size(); i++)
-        output_gate.emplace_back(_binary_list[min_index][i]);
-    return min_u;
+QTensor<U> SolovayKitaev::_find_and_insert_closest_u(const QTensor<U>& u, std::vector<int>& output_gate) const {
+    auto const min_index = _net->nearest(to_quaternion(u)).index;
+
+    auto const word = _net->word(min_index);
+    for (size_t i = 0; i < word.size(); i++)
+        output_gate.emplace_back(word[i]);
+    return to_su2_tensor<U>(_net->quaternion(min_index));
 }
 
 /**
@@ -238,24 +329,6 @@ QTensor<U> SolovayKitaev::_diagonalize(const QTensor<U>& u) const {
     return std::get<1>(u.eigen());
 }
 
-/**
- * @brief Create the basic gate list by concatenating Hs and Ts
- *
- * @tparam U
- * @return std::vector<QTensor<U>>
- */
-template <typename U>
-std::vector<QTensor<U>> SolovayKitaev::_create_gate_list() const {
-    std::vector<QTensor<U>> gate_list;
-    for (const auto& bits : _binary_list) {
-        QTensor<U> u = QTensor<U>::identity(1);
-        for (size_t i = 0; i < bits.size(); i++)
-            u = (bits[i]) ? tensor_multiply(u, QTensor<U>::pzgate(Phase(1, 4)).to_su2()) : tensor_multiply(u, QTensor<U>::hgate().to_su2());
-        gate_list.emplace_back(u);
-    }
-    return gate_list;
-}
-
 }  // namespace tensor
 
 }  // namespace qsyn
@@ -0,0 +1,143 @@
+/****************************************************************************
+  PackageName  [ util ]
+  Synopsis     [ Define a fixed-size vector stored as changes on top of a shared parent ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace dvlab {
+
+namespace utils {
+
+/**
+ * @brief A fixed-size vector that records its writes as changes on top of an immutable parent. Copies share the parent,
+ *        and the changes of the copied vector become a new immutable layer between them, so that copying costs time and memory
+ *        proportional to the elements written since the last copy rather than to the size of the vector.
+ *        Reading an element walks the layers, so the layers are flattened into a new parent once there are more than `max_layers`
+ *        of them, or once they hold more than a quarter of the elements.
+ *
+ * @tparam T
+ */
+template <typename T>
+class DeltaVector {
+public:
+    DeltaVector() : DeltaVector(std::vector<T>{}) {}
+    explicit DeltaVector(std::vector<T> values) : _base{std::make_shared<std::vector<T> const>(std::move(values))} {}
+
+    DeltaVector(DeltaVector const& other);
+    DeltaVector(DeltaVector&& other) noexcept = default;
+    DeltaVector& operator=(DeltaVector copy) noexcept {
+        swap(copy);
+        return *this;
+    }
+    ~DeltaVector() = default;
+
+    void swap(DeltaVector& other) noexcept {
+        std::swap(_base, other._base);
+        std::swap(_layers, other._layers);
+        std::swap(_changes, other._changes);
+    }
+
+    size_t size() const { return _base->size(); }
+    bool empty() const { return _base->empty(); }
+
+    T const& operator[](size_t i) const;
+    void set(size_t i, T value) { _changes.insert_or_assign(i, std::move(value)); }
+    T& get_mutable(size_t i);
+
+    std::vector<T> to_vector() const;
+    void flatten();
+
+private:
+    struct Layer {
+        std::shared_ptr<Layer const> parent;
+        std::unordered_map<size_t, T> changes;
+        size_t num_layers;   // the number of layers from this one to the base, inclusive
+        size_t num_changes;  // the number of changes in these layers, counting an element once per layer that changes it
+    };
+
+    constexpr static size_t max_layers = 8;
+
+    std::shared_ptr<std::vector<T> const> _base;
+    std::shared_ptr<Layer const> _layers;    // the most recent layer, or nullptr if the vector is flat
+    std::unordered_map<size_t, T> _changes;  // the writes since this vector is copied or flattened; not shared
+};
+
+template <typename T>
+DeltaVector<T>::DeltaVector(DeltaVector const& other) : _base{other._base}, _layers{other._layers} {
+    if (other._changes.empty()) return;
+
+    auto const num_layers  = (_layers == nullptr ? 0 : _layers->num_layers) + 1;
+    auto const num_changes = (_layers == nullptr ? 0 : _layers->num_changes) + other._changes.size();
+    if (num_layers > max_layers || 4 * num_changes > size()) {
+        _base   = std::make_shared<std::vector<T> const>(other.to_vector());
+        _layers = nullptr;
+        return;
+    }
+    _layers = std::make_shared<Layer const>(Layer{_layers, other._changes, num_layers, num_changes});
+}
+
+template <typename T>
+T const& DeltaVector<T>::operator[](size_t i) const {
+    if (auto const it = _changes.find(i); it != _changes.end()) return it->second;
+    for (auto const* layer = _layers.get(); layer != nullptr; layer = layer->parent.get()) {
+        if (auto const it = layer->changes.find(i); it != layer->changes.end()) return it->second;
+    }
+    return (*_base)[i];
+}
+
+/**
+ * @brief Get a writable reference to the i-th element. The element is copied into the changes of this vector on the first write;
+ *        the reference is valid until this vector is flattened or assigned to.
+ *
+ */
+template <typename T>
+T& DeltaVector<T>::get_mutable(size_t i) {
+    if (auto const it = _changes.find(i); it != _changes.end()) return it->second;
+    return _changes.emplace(i, (*this)[i]).first->second;
+}
+
+template <typename T>
+std::vector<T> DeltaVector<T>::to_vector() const {
+    if (_layers == nullptr && _changes.empty()) return *_base;
+
+    auto result = *_base;
+    // applies the oldest layer first so that newer changes overwrite older ones
+    auto layers = std::vector<Layer const*>{};
+    for (auto const* layer = _layers.get(); layer != nullptr; layer = layer->parent.get()) {
+        layers.emplace_back(layer);
+    }
+    for (auto it = layers.rbegin(); it != layers.rend(); ++it) {
+        for (auto const& [i, value] : (*it)->changes) {
+            result[i] = value;
+        }
+    }
+    for (auto const& [i, value] : _changes) {
+        result[i] = value;
+    }
+    return result;
+}
+
+/**
+ * @brief Merge the layers and the changes into a new base that is not shared with other vectors.
+ *
+ */
+template <typename T>
+void DeltaVector<T>::flatten() {
+    if (_layers == nullptr && _changes.empty()) return;
+    _base   = std::make_shared<std::vector<T> const>(to_vector());
+    _layers = nullptr;
+    _changes.clear();
+}
+
+}  // namespace utils
+
+}  // namespace dvlab
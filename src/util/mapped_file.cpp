@@ -0,0 +1,49 @@
+/****************************************************************************
+  PackageName  [ util ]
+  Synopsis     [ RAII wrapper for read-only memory-mapped files ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include "./mapped_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dvlab {
+
+namespace utils {
+
+/**
+ * @brief Map the file at `path`. If the file cannot be opened or is empty, is_open() is false.
+ *
+ * @param path
+ */
+MappedFile::MappedFile(std::filesystem::path const& path) {
+    auto const fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st {};
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        auto const size = static_cast<size_t>(st.st_size);
+        // the mapping stays valid after the file descriptor is closed
+        auto* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            _data = static_cast<std::byte const*>(data);
+            _size = size;
+        }
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (_data != nullptr) {
+        munmap(const_cast<std::byte*>(_data), _size);  // NOLINT(cppcoreguidelines-pro-type-const-cast) : munmap takes a non-const pointer
+    }
+}
+
+}  // namespace utils
+
+}  // namespace dvlab
@@ -0,0 +1,43 @@
+/****************************************************************************
+  PackageName  [ util ]
+  Synopsis     [ RAII wrapper for read-only memory-mapped files ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace dvlab {
+
+namespace utils {
+
+/**
+ * @brief Maps a whole file into memory for reading. The pages are loaded by the OS on first access,
+ *        so opening a large file costs almost nothing until its contents are read.
+ *
+ */
+class MappedFile {
+public:
+    MappedFile(std::filesystem::path const& path);
+    ~MappedFile();
+    // deletes copy ctors and assignment operators because the mapping is released on destruction
+    MappedFile(MappedFile const&)            = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+    MappedFile(MappedFile&&)                 = delete;
+    MappedFile& operator=(MappedFile&&)      = delete;
+
+    bool is_open() const { return _data != nullptr; }
+    std::span<std::byte const> data() const { return {_data, _size}; }
+
+private:
+    std::byte const* _data = nullptr;
+    size_t _size           = 0;
+};
+
+}  // namespace utils
+
+}  // namespace dvlab
@@ -0,0 +1,82 @@
+/****************************************************************************
+  PackageName  [ util ]
+  Synopsis     [ Define simple data-parallel helpers ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dvlab {
+
+namespace utils {
+
+/**
+ * @brief Get the number of threads the hardware supports. Falls back to 1 if unknown.
+ *
+ * @return size_t
+ */
+inline size_t hardware_concurrency() {
+    return std::max(size_t{1}, static_cast<size_t>(std::thread::hardware_concurrency()));
+}
+
+/**
+ * @brief Run f(i) for every i in [0, n) on up to `num_threads` threads.
+ *        Indices are handed out one at a time, so uneven workloads are balanced.
+ *        If `num_threads` is 0, use the hardware concurrency. With one thread, f runs on the calling thread.
+ *        The first exception thrown by f is rethrown after all threads have joined.
+ *
+ * @param n number of iterations
+ * @param f callable taking the iteration index
+ * @param num_threads
+ */
+template <typename F>
+void parallel_for(size_t n, F&& f, size_t num_threads = 0) {
+    if (num_threads == 0) num_threads = hardware_concurrency();
+    num_threads = std::min(num_threads, n);
+
+    if (num_threads <= 1) {
+        for (size_t i = 0; i < n; ++i) f(i);
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::exception_ptr exception;
+    std::mutex exception_mutex;
+
+    auto const worker = [&]() {
+        for (size_t i = next++; i < n; i = next++) {
+            try {
+                f(i);
+            } catch (...) {
+                std::lock_guard const lock{exception_mutex};
+                if (!exception) exception = std::current_exception();
+                next = n;  // stop handing out work
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (size_t t = 1; t < num_threads; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (exception) std::rethrow_exception(exception);
+}
+
+}  // namespace utils
+
+}  // namespace dvlab
@@ -0,0 +1,139 @@
+/****************************************************************************
+  PackageName  [ util ]
+  Synopsis     [ Define an incrementally-built GF(2) basis in reduced row echelon form ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023 DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <sul/dynamic_bitset.hpp>
+#include <vector>
+
+namespace dvlab {
+
+/**
+ * @brief A basis of a row space over GF(2), kept in reduced row echelon form while rows are inserted one at a time.
+ *        Testing or inserting a row costs one pass over the basis, so the rank of a growing set of rows is maintained
+ *        without re-running Gaussian elimination.
+ *
+ *        The rows that increased the rank when inserted are called the generators. Each basis row remembers which
+ *        generators it sums, so that any vector in the row space can be written in terms of the generators.
+ *
+ */
+class ReducedEchelonBasis {
+public:
+    using Bits = sul::dynamic_bitset<>;
+
+    struct BasisRow {
+        size_t pivot;
+        Bits row;
+    };
+
+    ReducedEchelonBasis(size_t n_cols) : _n_cols{n_cols} {}
+
+    size_t n_cols() const { return _n_cols; }
+    size_t rank() const { return _rows.size(); }
+    bool is_full_rank() const { return rank() == _n_cols; }
+    std::vector<BasisRow> const& rows() const { return _rows; }
+
+    /**
+     * @brief Reduce the row by the basis. Afterwards, the row is zero on every pivot.
+     *
+     */
+    void reduce(Bits& row) const {
+        for (auto const& [pivot, basis_row] : _rows) {
+            if (row.test(pivot)) row ^= basis_row;
+        }
+    }
+
+    /**
+     * @brief Check if the row is in the row space
+     *
+     */
+    bool contains(Bits row) const {
+        reduce(row);
+        return row.none();
+    }
+
+    /**
+     * @brief Add the row to the basis if it is not in the row space. If added, the row becomes the generator
+     *        with index rank() - 1.
+     *
+     * @return true if the rank increases
+     */
+    bool insert(Bits row) {
+        auto combination = Bits(rank() + 1);
+        combination.set(rank());
+        for (size_t i = 0; i < _rows.size(); ++i) {
+            if (row.test(_rows[i].pivot)) {
+                row ^= _rows[i].row;
+                _xor_combination(combination, _combinations[i]);
+            }
+        }
+        auto const pivot = row.find_first();
+        if (pivot == Bits::npos) return false;
+
+        for (size_t i = 0; i < _rows.size(); ++i) {
+            _combinations[i].resize(rank() + 1);
+            if (_rows[i].row.test(pivot)) {
+                _rows[i].row ^= row;
+                _combinations[i] ^= combination;
+            }
+        }
+        _rows.push_back({pivot, std::move(row)});
+        _combinations.push_back(std::move(combination));
+        return true;
+    }
+
+    /**
+     * @brief Write the row as a sum of generators
+     *
+     * @return a vector of rank() bits, one for each generator, or std::nullopt if the row is not in the row space
+     */
+    std::optional<Bits> get_coordinates(Bits row) const {
+        auto coordinates = Bits(rank());
+        for (size_t i = 0; i < _rows.size(); ++i) {
+            if (row.test(_rows[i].pivot)) {
+                row ^= _rows[i].row;
+                _xor_combination(coordinates, _combinations[i]);
+            }
+        }
+        if (row.any()) return std::nullopt;
+        return coordinates;
+    }
+
+    /**
+     * @brief Get a vector x in the nullspace of the basis rows with row · x = 1
+     *
+     * @return std::nullopt if the row is in the row space, in which case no such vector exists
+     */
+    std::optional<Bits> get_null_vector_against(Bits row) const {
+        reduce(row);
+        auto const free_col = row.find_first();
+        if (free_col == Bits::npos) return std::nullopt;
+
+        auto null_vector = Bits(_n_cols);
+        null_vector.set(free_col);
+        for (auto const& [pivot, basis_row] : _rows) {
+            if (basis_row.test(free_col)) null_vector.set(pivot);
+        }
+        return null_vector;
+    }
+
+private:
+    size_t _n_cols;
+    std::vector<BasisRow> _rows;
+    std::vector<Bits> _combinations;  // _combinations[i] marks the generators summing to _rows[i]
+
+    // while inserting, the target is one bit longer than the combinations of the existing rows
+    static void _xor_combination(Bits& target, Bits const& combination) {
+        for (auto i = combination.find_first(); i != Bits::npos; i = combination.find_next(i)) {
+            target.flip(i);
+        }
+    }
+};
+
+}  // namespace dvlab